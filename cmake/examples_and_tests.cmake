@@ -109,6 +109,10 @@ endif()
 
     target_link_libraries(${TARGET_NAME} PRIVATE vclib-tests-examples-common)
 
+    if(ARG_MODULE STREQUAL "core" AND ${ARG_TEST})
+        target_link_libraries(${TARGET_NAME} PRIVATE vclib-core-tests-common)
+    endif()
+
     if(${TO_EXCLUDE})
         set_target_properties(${TARGET_NAME} PROPERTIES EXCLUDE_FROM_ALL TRUE)
     endif()
@@ -56,8 +56,40 @@ void trimeshStaticAsserts()
 
     static_assert(HasBoundingBox<TriMesh>, "");
 
+    static_assert(
+        !TriMesh::hasPerElementVerticalComponent<
+            ElemId::VERTEX,
+            CompId::POSITION>(),
+        "");
+    static_assert(
+        TriMesh::hasPerElementVerticalComponent<
+            ElemId::VERTEX,
+            CompId::COLOR>(),
+        "");
+
+    // structure of arrays variant
+    static_assert(
+        TriangleMeshConcept<TriMeshSoA>,
+        "The TriMeshSoA is not a static Triangle Mesh.");
+    static_assert(
+        TriMeshSoA::hasPerElementVerticalComponent<
+            ElemId::VERTEX,
+            CompId::POSITION>(),
+        "");
+    static_assert(
+        TriMeshSoA::hasPerElementVerticalComponent<
+            ElemId::VERTEX,
+            CompId::NORMAL>(),
+        "");
+    static_assert(
+        TriMeshSoA::hasPerElementVerticalComponent<
+            ElemId::FACE,
+            CompId::NORMAL>(),
+        "");
+
     // mesh views
     meshViewsStaticAsserts<TriMesh>();
+    meshViewsStaticAsserts<TriMeshSoA>();
 }
 
 #endif // TRIMESH_H
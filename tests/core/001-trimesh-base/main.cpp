@@ -10,6 +10,8 @@
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <set>
+
 TEMPLATE_TEST_CASE(
     "Test empty TriMesh",
     "",
@@ -313,3 +315,129 @@ TEMPLATE_TEST_CASE(
         REQUIRE(m.vertex(1).color() == vcl::Color::Red);
     }
 }
+
+TEMPLATE_TEST_CASE(
+    "Test TriMesh stable storage",
+    "",
+    vcl::TriMesh,
+    vcl::TriMeshf,
+    vcl::TriMeshIndexed,
+    vcl::TriMeshIndexedf)
+{
+    using TriMesh = TestType;
+    using PointT  = TriMesh::VertexType::PositionType;
+
+    const unsigned int N = 10000;
+
+    TriMesh m;
+    m.addVertices(PointT(0, 0, 0), PointT(1, 0, 0), PointT(0, 1, 0));
+    m.addFace(0, 1, 2);
+
+    m.reserveStableVertices(N);
+    m.reserveStableFaces(N);
+
+    // the references have been updated after the first reservation
+    REQUIRE(m.face(0).vertex(1) == &m.vertex(1));
+
+    const auto* v0 = &m.vertex(0);
+    const auto* f0 = &m.face(0);
+
+    WHEN("Adding elements while the size is below the reserved one")
+    {
+        for (unsigned int i = 3; i < N - 1; ++i) {
+            m.addVertex(PointT(i, 0, 0));
+            m.addFace(i - 2, i - 1, i);
+        }
+
+        THEN("The elements are never moved")
+        {
+            REQUIRE(m.vertexCount() == N - 1);
+            REQUIRE(m.faceCount() == N - 3);
+            REQUIRE(&m.vertex(0) == v0);
+            REQUIRE(&m.face(0) == f0);
+            REQUIRE(m.face(0).vertex(0) == v0);
+            REQUIRE(m.face(N - 4).vertexIndex(2) == N - 2);
+        }
+
+        THEN("A copy of the mesh keeps the stable storage")
+        {
+            TriMesh c = m;
+            REQUIRE(c.vertexCount() == N - 1);
+            REQUIRE(c.face(N - 4).vertex(2) == &c.vertex(N - 2));
+
+            const auto* cv0 = &c.vertex(0);
+            c.addVertex();
+            REQUIRE(&c.vertex(0) == cv0);
+        }
+    }
+
+    WHEN("Adding elements beyond the reserved size")
+    {
+        m.addVertices(N);
+
+        THEN("The references are updated")
+        {
+            REQUIRE(m.vertexCount() == N + 3);
+            REQUIRE(m.face(0).vertex(0) == &m.vertex(0));
+            REQUIRE(m.face(0).vertex(2) == &m.vertex(2));
+            REQUIRE(m.face(0).vertexIndex(1) == 1);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE(
+    "Test TriMesh compaction without preserving the order",
+    "",
+    vcl::TriMesh,
+    vcl::TriMeshf,
+    vcl::TriMeshIndexed,
+    vcl::TriMeshIndexedf)
+{
+    using TriMesh = TestType;
+    using PointT  = TriMesh::VertexType::PositionType;
+
+    const unsigned int N = 100;
+
+    // a strip of faces, followed by N isolated vertices
+    TriMesh m;
+    for (unsigned int i = 0; i < N + 2; ++i) {
+        m.addVertex(PointT(i, 0, 0));
+    }
+    for (unsigned int i = 0; i < N; ++i) {
+        m.addFace(i, i + 1, i + 2);
+    }
+    m.addVertices(N);
+
+    for (unsigned int i = 0; i < N; i += 7) {
+        m.deleteFace(i);
+    }
+    for (unsigned int i = N + 2; i < 2 * N + 2; i += 3) {
+        m.deleteVertex(i);
+    }
+    const unsigned int nf = m.faceCount();
+    const unsigned int nv = m.vertexCount();
+
+    m.compact(false);
+
+    REQUIRE(m.faceCount() == nf);
+    REQUIRE(m.faceContainerSize() == nf);
+    REQUIRE(m.vertexContainerSize() == nv);
+
+    // the non-moved faces keep their index
+    REQUIRE(m.face(1).vertex(0)->position().x() == 1);
+    // the last face filled the first hole
+    REQUIRE(m.face(0).vertex(0)->position().x() == N - 1);
+
+    std::set<unsigned int> firsts;
+    for (const auto& f : m.faces()) {
+        const auto x = f.vertex(0)->position().x();
+        REQUIRE(f.vertex(1)->position().x() == x + 1);
+        REQUIRE(f.vertex(2)->position().x() == x + 2);
+        REQUIRE(f.vertexIndex(0) == (unsigned int) x);
+        firsts.insert(x);
+    }
+    REQUIRE(firsts.size() == nf);
+    for (unsigned int i = 0; i < N; ++i) {
+        REQUIRE(firsts.contains(i) == (i % 7 != 0));
+    }
+}
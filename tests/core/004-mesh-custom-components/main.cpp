@@ -58,3 +58,84 @@ TEMPLATE_TEST_CASE(
 
     REQUIRE(!m.hasPerVertexCustomComponent("flag"));
 }
+
+TEMPLATE_TEST_CASE(
+    "Test Custom Components contiguous storage",
+    "",
+    vcl::TriMesh,
+    vcl::TriMeshIndexed)
+{
+    using TriMesh = TestType;
+
+    TriMesh m;
+    m.addVertices(10);
+
+    m.template addPerVertexCustomComponent<double>("confidence");
+    m.template addPerVertexCustomComponent<bool>("label");
+
+    auto conf = m.template perVertexCustomComponentVectorHandle<double>(
+        "confidence");
+    auto label = m.template perVertexCustomComponentVectorHandle<bool>("label");
+
+    REQUIRE(conf.size() == 10);
+    REQUIRE(conf.span().size() == 10);
+    REQUIRE(label.size() == 10);
+
+    // values are contiguous, and shared with the per element access
+    for (vcl::uint i = 0; i < 10; ++i) {
+        REQUIRE(conf.data() + i == &conf[i]);
+        REQUIRE(
+            &m.vertex(i).template customComponent<double>("confidence") ==
+            &conf[i]);
+        REQUIRE(
+            &m.vertex(i).template customComponent<bool>("label") ==
+            label.data() + i);
+        conf[i]  = i * 0.5;
+        label[i] = i % 2 == 0;
+    }
+
+    REQUIRE_THROWS_AS(
+        m.template perVertexCustomComponentVectorHandle<float>("confidence"),
+        vcl::BadCustomComponentTypeException);
+
+    // new values are value initialized
+    m.addVertices(5);
+    conf = m.template perVertexCustomComponentVectorHandle<double>(
+        "confidence");
+    REQUIRE(conf.size() == 15);
+    for (vcl::uint i = 10; i < 15; ++i) {
+        REQUIRE(conf[i] == 0);
+        REQUIRE(!m.vertex(i).template customComponent<bool>("label"));
+    }
+
+    // const handles
+    const TriMesh& cm = m;
+    auto cconf = cm.template perVertexCustomComponentVectorHandle<double>(
+        "confidence");
+    auto cconf2 =
+        m.template perVertexCustomComponentVectorHandle<const double>(
+            "confidence");
+    REQUIRE(cconf.data() == cconf2.data());
+    REQUIRE(cconf[3] == 1.5);
+
+    // copies do not share the values
+    TriMesh m2 = m;
+    m2.vertex(3).template customComponent<double>("confidence") = -1;
+    REQUIRE(m.vertex(3).template customComponent<double>("confidence") == 1.5);
+
+    // compaction and append keep the values of the elements
+    m.deleteVertex(0u);
+    m.deleteVertex(5u);
+    m.compact();
+    REQUIRE(m.vertexCount() == 13);
+    REQUIRE(m.vertex(0).template customComponent<double>("confidence") == 0.5);
+    REQUIRE(m.vertex(4).template customComponent<double>("confidence") == 3);
+    REQUIRE(m.vertex(4).template customComponent<bool>("label"));
+    REQUIRE(!m.vertex(5).template customComponent<bool>("label"));
+
+    m.append(m2);
+    REQUIRE(m.vertexCount() == 28);
+    REQUIRE(
+        m.vertex(13 + 3).template customComponent<double>("confidence") == -1);
+    REQUIRE(m.vertex(13 + 8).template customComponent<bool>("label"));
+}
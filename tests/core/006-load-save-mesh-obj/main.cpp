@@ -5,6 +5,8 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at https://mozilla.org/MPL/2.0/.
 
+#include "check_same_meshes.h"
+
 #include <vclib/io.h>
 #include <vclib/meshes.h>
 
@@ -256,3 +258,125 @@ TEMPLATE_TEST_CASE(
         REQUIRE(info.hasEdges());
     }
 }
+
+// Loading an OBJ file with parallel text parsing must give the same result of
+// the sequential loader
+TEMPLATE_TEST_CASE(
+    "Load OBJ from file with parallel text parsing",
+    "",
+    Meshes,
+    Meshesf)
+{
+    using TriMesh  = std::tuple_element_t<0, TestType>;
+    using PolyMesh = std::tuple_element_t<1, TestType>;
+
+    vcl::LoadSettings parSettings;
+    parSettings.parallelTextParsing = true;
+
+    vcl::MeshInfo seqInfo, parInfo;
+
+    SECTION("TriMesh - bunny")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/bunny.obj";
+
+        TriMesh tm1, tm2;
+        vcl::loadObj(tm1, filename, seqInfo);
+        vcl::loadObj(tm2, filename, parInfo, parSettings);
+
+        REQUIRE(parInfo.isTriangleMesh());
+        checkSameMeshes(tm1, tm2);
+    }
+
+    SECTION("PolyMesh - Rhombicosidodecahedron")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/rhombicosidodecahedron.obj";
+
+        PolyMesh pm1, pm2;
+        vcl::loadObj(pm1, filename, seqInfo);
+        vcl::loadObj(pm2, filename, parInfo, parSettings);
+
+        REQUIRE(pm2.vertexCount() == 60);
+        REQUIRE(pm2.faceCount() == 62);
+        REQUIRE(parInfo.isPolygonMesh());
+        checkSameMeshes(pm1, pm2);
+    }
+
+    SECTION("TriMesh - Rhombicosidodecahedron")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/rhombicosidodecahedron.obj";
+
+        TriMesh tm1, tm2;
+        vcl::loadObj(tm1, filename, seqInfo);
+        vcl::loadObj(tm2, filename, parInfo, parSettings);
+
+        checkSameMeshes(tm1, tm2);
+    }
+}
+
+// With tiny chunks, vertices, faces and material statements of an OBJ file are
+// spread across many chunks, that must be merged in file order
+TEMPLATE_TEST_CASE(
+    "Load OBJ from file with parallel text parsing in tiny chunks",
+    "",
+    Meshes,
+    Meshesf)
+{
+    using TriMesh  = std::tuple_element_t<0, TestType>;
+    using PolyMesh = std::tuple_element_t<1, TestType>;
+
+    vcl::LoadSettings parSettings;
+    parSettings.parallelTextParsing = true;
+    parSettings.textChunkSize       = 64;
+
+    vcl::MeshInfo seqInfo, parInfo;
+
+    SECTION("TriMesh - Wedge TextureDouble")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/TextureDouble.obj";
+
+        TriMesh tm1, tm2;
+        vcl::loadObj(tm1, filename, seqInfo);
+        vcl::loadObj(tm2, filename, parInfo, parSettings);
+
+        checkSameMeshes(tm1, tm2);
+        REQUIRE(tm2.materialCount() == tm1.materialCount());
+        REQUIRE(parInfo.hasPerFaceWedgeTexCoords());
+        REQUIRE(parInfo.hasMaterials());
+        for (uint i = 0; i < tm1.faceCount(); ++i) {
+            const auto& f1 = tm1.face(i);
+            const auto& f2 = tm2.face(i);
+            REQUIRE(f1.materialIndex() == f2.materialIndex());
+            for (uint j = 0; j < f1.vertexCount(); ++j) {
+                REQUIRE(f1.wedgeTexCoord(j) == f2.wedgeTexCoord(j));
+            }
+        }
+    }
+
+    SECTION("PolyMesh - Rhombicosidodecahedron")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/rhombicosidodecahedron.obj";
+
+        PolyMesh pm1, pm2;
+        vcl::loadObj(pm1, filename, seqInfo);
+        vcl::loadObj(pm2, filename, parInfo, parSettings);
+
+        REQUIRE(parInfo.isPolygonMesh());
+        checkSameMeshes(pm1, pm2);
+    }
+
+    SECTION("TriMesh - Rhombicosidodecahedron")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/rhombicosidodecahedron.obj";
+
+        TriMesh tm1, tm2;
+        vcl::loadObj(tm1, filename, seqInfo);
+        vcl::loadObj(tm2, filename, parInfo, parSettings);
+
+        checkSameMeshes(tm1, tm2);
+    }
+}
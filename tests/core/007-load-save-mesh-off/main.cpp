@@ -5,6 +5,8 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at https://mozilla.org/MPL/2.0/.
 
+#include "check_same_meshes.h"
+
 #include <vclib/algorithms.h>
 #include <vclib/io.h>
 #include <vclib/meshes.h>
@@ -12,6 +14,8 @@
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <fstream>
+
 std::istringstream offPolyCube()
 {
     // string containing a cube in OFF format
@@ -233,3 +237,192 @@ TEMPLATE_TEST_CASE(
         REQUIRE(line == "4 2 3 1 0 ");
     }
 }
+
+// Loading an OFF file with parallel text parsing must give the same result of
+// the sequential loader
+TEMPLATE_TEST_CASE(
+    "Load OFF from file with parallel text parsing",
+    "",
+    Meshes,
+    Meshesf)
+{
+    using TriMesh  = typename TestType::first_type;
+    using PolyMesh = typename TestType::second_type;
+
+    vcl::LoadSettings parSettings;
+    parSettings.parallelTextParsing = true;
+
+    vcl::MeshInfo seqInfo, parInfo;
+
+    SECTION("TriMesh - bone")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/bone.off";
+
+        TriMesh tm1, tm2;
+        vcl::loadOff(tm1, filename, seqInfo);
+        vcl::loadOff(tm2, filename, parInfo, parSettings);
+
+        REQUIRE(tm2.vertexCount() == 1872);
+        REQUIRE(tm2.faceCount() == 3022);
+        REQUIRE(parInfo.hasPerVertexColor() == seqInfo.hasPerVertexColor());
+        checkSameMeshes(tm1, tm2);
+        for (uint i = 0; i < tm1.vertexCount(); ++i) {
+            REQUIRE(tm1.vertex(i).color() == tm2.vertex(i).color());
+        }
+    }
+
+    SECTION("PolyMesh - trim-star")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/trim-star.off";
+
+        PolyMesh pm1, pm2;
+        vcl::loadOff(pm1, filename, seqInfo);
+        vcl::loadOff(pm2, filename, parInfo, parSettings);
+
+        REQUIRE(pm2.vertexCount() == 5192);
+        REQUIRE(pm2.faceCount() == 10384);
+        REQUIRE(parInfo.isTriangleMesh());
+        checkSameMeshes(pm1, pm2);
+    }
+}
+
+// With tiny chunks, the faces of an OFF file are read in many per-chunk arrays,
+// that must be merged at the right offsets
+TEMPLATE_TEST_CASE(
+    "Load OFF from file with parallel text parsing in tiny chunks",
+    "",
+    Meshes,
+    Meshesf)
+{
+    using TriMesh  = typename TestType::first_type;
+    using PolyMesh = typename TestType::second_type;
+
+    vcl::LoadSettings parSettings;
+    parSettings.parallelTextParsing = true;
+    parSettings.textChunkSize       = 256;
+
+    vcl::MeshInfo seqInfo, parInfo;
+
+    SECTION("TriMesh - bone")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/bone.off";
+
+        TriMesh tm1, tm2;
+        vcl::loadOff(tm1, filename, seqInfo);
+        vcl::loadOff(tm2, filename, parInfo, parSettings);
+
+        checkSameMeshes(tm1, tm2);
+        for (uint i = 0; i < tm1.vertexCount(); ++i) {
+            REQUIRE(tm1.vertex(i).color() == tm2.vertex(i).color());
+        }
+    }
+
+    SECTION("PolyMesh - trim-star")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/trim-star.off";
+
+        PolyMesh pm1, pm2;
+        vcl::loadOff(pm1, filename, seqInfo);
+        vcl::loadOff(pm2, filename, parInfo, parSettings);
+
+        REQUIRE(parInfo.isTriangleMesh());
+        checkSameMeshes(pm1, pm2);
+    }
+
+    SECTION("TriMesh - polygons split in triangles")
+    {
+        const std::string filename =
+            VCLIB_CORE_RESULTS_PATH "/cube_poly_chunks.off";
+        {
+            std::ofstream file(filename);
+            file << offPolyCube().str();
+        }
+
+        TriMesh tm1, tm2;
+        vcl::loadOff(tm1, filename, seqInfo);
+        vcl::loadOff(tm2, filename, parInfo, parSettings);
+
+        REQUIRE(tm2.faceCount() == 12);
+        checkSameMeshes(tm1, tm2);
+    }
+}
+
+// Loading a mesh in blocks and writing it to an OFF file block by block must
+// give the same mesh of the whole-file loader, with the element counts of the
+// header patched on close
+TEMPLATE_TEST_CASE(
+    "Load and save OFF in blocks",
+    "",
+    vcl::PointCloud,
+    vcl::PointCloudf)
+{
+    using BlockMesh = TestType;
+
+    vcl::MeshInfo info;
+    info.setVertices();
+    info.setPerVertexPosition();
+    info.setFaces();
+    info.setPerFaceVertexReferences();
+
+    BlockMesh block;
+
+    auto saveInBlocks = [&](const std::string& in,
+                            const std::string& out,
+                            uint               blockSize) {
+        vcl::MeshBlockWriter writer(out, info);
+        vcl::loadMeshBlocks(
+            block,
+            in,
+            [&](const BlockMesh& b, uint) { writer.writeVertices(b); },
+            [&](const vcl::FaceBlock& f) { writer.writeFaces(f); },
+            blockSize);
+        writer.close();
+        return std::pair(writer.vertexCount(), writer.faceCount());
+    };
+
+    SECTION("TriMesh - bone")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/bone.off";
+        const std::string outFilename =
+            VCLIB_CORE_RESULTS_PATH "/bone_blocks.off";
+
+        auto [nv, nf] = saveInBlocks(filename, outFilename, 500);
+
+        vcl::TriMesh tm1, tm2;
+        vcl::loadMesh(tm1, filename);
+        vcl::loadMesh(tm2, outFilename);
+
+        REQUIRE(nv == tm1.vertexCount());
+        REQUIRE(nf == tm1.faceCount());
+        REQUIRE(tm2.vertexCount() == tm1.vertexCount());
+        REQUIRE(tm2.faceCount() == tm1.faceCount());
+        for (uint i = 0; i < tm1.vertexCount(); ++i) {
+            REQUIRE(tm2.vertex(i).position().epsilonEquals(
+                tm1.vertex(i).position(), 1e-4));
+        }
+        for (uint i = 0; i < tm1.faceCount(); ++i) {
+            for (uint j = 0; j < 3; ++j) {
+                REQUIRE(
+                    tm2.face(i).vertexIndex(j) == tm1.face(i).vertexIndex(j));
+            }
+        }
+    }
+
+    SECTION("PolyMesh - cube_poly")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/cube_poly.ply";
+        const std::string outFilename =
+            VCLIB_CORE_RESULTS_PATH "/cube_poly_blocks.off";
+
+        auto [nv, nf] = saveInBlocks(filename, outFilename, 3);
+
+        REQUIRE(nv == 8);
+        REQUIRE(nf == 6);
+
+        vcl::PolyMesh pm1, pm2;
+        vcl::loadMesh(pm1, filename);
+        vcl::loadMesh(pm2, outFilename);
+        checkSameMeshes(pm1, pm2);
+    }
+}
@@ -5,12 +5,19 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at https://mozilla.org/MPL/2.0/.
 
+#include "check_same_meshes.h"
+
 #include <vclib/io.h>
 #include <vclib/meshes.h>
 
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+
 std::istringstream plyPolyCube()
 {
     // string containing a cube in PLY format
@@ -99,6 +106,85 @@ std::istringstream plyTriCube()
     return ss;
 }
 
+template<typename T>
+void writeBigEndian(std::ostream& out, T value)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if constexpr (std::endian::native == std::endian::little)
+        std::reverse(bytes, bytes + sizeof(T));
+    out.write(bytes, sizeof(T));
+}
+
+// writes a big endian PLY file storing a n x n grid of vertices with normals,
+// colors and two custom components, and its triangles with colors and a custom
+// component: all the values are computed from the indices of the elements
+void writeBigEndianPlyGrid(const std::string& filename, uint n)
+{
+    const uint nv = n * n;
+    const uint nf = (n - 1) * (n - 1) * 2;
+
+    std::ofstream file(filename, std::ofstream::binary);
+    file << "ply\n"
+            "format binary_big_endian 1.0\n"
+            "element vertex "
+         << nv
+         << "\n"
+            "property float x\n"
+            "property float y\n"
+            "property float z\n"
+            "property float nx\n"
+            "property float ny\n"
+            "property float nz\n"
+            "property uchar red\n"
+            "property uchar green\n"
+            "property uchar blue\n"
+            "property uchar alpha\n"
+            "property short vshort\n"
+            "property double vdouble\n"
+            "element face "
+         << nf
+         << "\n"
+            "property list uchar int vertex_indices\n"
+            "property uchar red\n"
+            "property uchar green\n"
+            "property uchar blue\n"
+            "property uchar alpha\n"
+            "property ushort fushort\n"
+            "end_header\n";
+
+    for (uint i = 0; i < nv; ++i) {
+        writeBigEndian<float>(file, i % n);
+        writeBigEndian<float>(file, i / n);
+        writeBigEndian<float>(file, 0.25f * (i % 7));
+        writeBigEndian<float>(file, 0);
+        writeBigEndian<float>(file, 0.6f);
+        writeBigEndian<float>(file, 0.8f);
+        for (uint j = 0; j < 4; ++j)
+            writeBigEndian<unsigned char>(file, (i + j * 50) % 256);
+        writeBigEndian<short>(file, short(i) - 1000);
+        writeBigEndian<double>(file, i * 0.5);
+    }
+    for (uint f = 0; f < nf; ++f) {
+        const uint q = f / 2, x = q % (n - 1), y = q / (n - 1);
+        const uint v = y * n + x;
+        writeBigEndian<unsigned char>(file, 3);
+        if (f % 2 == 0) {
+            writeBigEndian<int>(file, v);
+            writeBigEndian<int>(file, v + 1);
+            writeBigEndian<int>(file, v + n + 1);
+        }
+        else {
+            writeBigEndian<int>(file, v);
+            writeBigEndian<int>(file, v + n + 1);
+            writeBigEndian<int>(file, v + n);
+        }
+        for (uint j = 0; j < 4; ++j)
+            writeBigEndian<unsigned char>(file, (f + j * 30) % 256);
+        writeBigEndian<unsigned short>(file, f * 7);
+    }
+}
+
 using Meshes  = std::tuple<vcl::TriMesh, vcl::PolyMesh, vcl::EdgeMesh>;
 using Meshesf = std::tuple<vcl::TriMeshf, vcl::PolyMeshf, vcl::EdgeMeshf>;
 using MeshesIndexed =
@@ -207,3 +293,392 @@ TEMPLATE_TEST_CASE(
         REQUIRE(pm.edgeCount() == 4);
     }
 }
+
+// Binary ply files loaded from the file system are memory mapped: the result
+// must be the same of loading them from a stream
+TEMPLATE_TEST_CASE(
+    "Load binary PLY from file and from stream",
+    "",
+    Meshes,
+    Meshesf)
+{
+    using TriMesh  = std::tuple_element_t<0, TestType>;
+    using PolyMesh = std::tuple_element_t<1, TestType>;
+
+    vcl::MeshInfo fileInfo, streamInfo;
+
+    SECTION("TriMesh - bimba_selected")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/bimba_selected.ply";
+
+        TriMesh tm1, tm2;
+        vcl::loadPly(tm1, filename, fileInfo);
+        std::ifstream file(filename, std::ifstream::binary);
+        vcl::loadPly(tm2, file, streamInfo);
+
+        REQUIRE(tm1.vertexCount() == 23112);
+        REQUIRE(tm1.faceCount() == 46220);
+        REQUIRE(fileInfo.isTriangleMesh());
+        checkSameMeshes(tm1, tm2);
+        for (uint i = 0; i < tm1.faceCount(); ++i) {
+            REQUIRE(tm1.face(i).selected() == tm2.face(i).selected());
+        }
+    }
+
+    SECTION("TriMesh - cube_poly")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/cube_poly.ply";
+
+        TriMesh tm1, tm2;
+        vcl::loadPly(tm1, filename, fileInfo);
+        std::ifstream file(filename, std::ifstream::binary);
+        vcl::loadPly(tm2, file, streamInfo);
+
+        REQUIRE(tm1.faceCount() == 12);
+        checkSameMeshes(tm1, tm2);
+    }
+
+    SECTION("PolyMesh - cube_poly")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/cube_poly.ply";
+
+        PolyMesh pm1, pm2;
+        vcl::loadPly(pm1, filename, fileInfo);
+        std::ifstream file(filename, std::ifstream::binary);
+        vcl::loadPly(pm2, file, streamInfo);
+
+        REQUIRE(pm1.faceCount() == 6);
+        REQUIRE(fileInfo.isQuadMesh());
+        checkSameMeshes(pm1, pm2);
+    }
+
+    SECTION("TriMesh - big endian with normals, colors and custom components")
+    {
+        const std::string filename =
+            VCLIB_CORE_RESULTS_PATH "/grid_big_endian.ply";
+        const uint n = 60;
+        writeBigEndianPlyGrid(filename, n);
+
+        TriMesh tm1, tm2;
+        vcl::loadPly(tm1, filename, fileInfo);
+        std::ifstream file(filename, std::ifstream::binary);
+        vcl::loadPly(tm2, file, streamInfo);
+
+        REQUIRE(tm1.vertexCount() == n * n);
+        REQUIRE(tm1.faceCount() == (n - 1) * (n - 1) * 2);
+        REQUIRE(fileInfo.hasPerVertexNormal());
+        REQUIRE(fileInfo.hasPerVertexColor());
+        REQUIRE(fileInfo.hasPerFaceColor());
+        REQUIRE(tm1.hasPerVertexCustomComponent("vshort"));
+        REQUIRE(tm1.hasPerVertexCustomComponent("vdouble"));
+        REQUIRE(tm1.hasPerFaceCustomComponent("fushort"));
+        checkSameMeshes(tm1, tm2);
+
+        using NormalType = TriMesh::VertexType::NormalType;
+        for (uint i = 0; i < tm1.vertexCount(); ++i) {
+            const auto& v1 = tm1.vertex(i);
+            const auto& v2 = tm2.vertex(i);
+            REQUIRE(v1.position().x() == i % n);
+            REQUIRE(v1.position().y() == i / n);
+            REQUIRE(v1.normal() == NormalType(0, 0.6f, 0.8f));
+            REQUIRE(v1.normal() == v2.normal());
+            REQUIRE(v1.color().red() == i % 256);
+            REQUIRE(v1.color().alpha() == (i + 150) % 256);
+            REQUIRE(v1.color() == v2.color());
+            REQUIRE(
+                v1.template customComponent<short>("vshort") ==
+                short(i) - 1000);
+            REQUIRE(
+                v1.template customComponent<short>("vshort") ==
+                v2.template customComponent<short>("vshort"));
+            REQUIRE(v1.template customComponent<double>("vdouble") == i * 0.5);
+            REQUIRE(
+                v1.template customComponent<double>("vdouble") ==
+                v2.template customComponent<double>("vdouble"));
+        }
+        for (uint i = 0; i < tm1.faceCount(); ++i) {
+            const auto& f1 = tm1.face(i);
+            const auto& f2 = tm2.face(i);
+            REQUIRE(f1.color().green() == (i + 30) % 256);
+            REQUIRE(f1.color() == f2.color());
+            REQUIRE(
+                f1.template customComponent<unsigned short>("fushort") ==
+                (unsigned short) (i * 7));
+            REQUIRE(
+                f1.template customComponent<unsigned short>("fushort") ==
+                f2.template customComponent<unsigned short>("fushort"));
+        }
+    }
+}
+
+// Loading an ascii PLY file with parallel text parsing must give the same
+// result of the sequential loader
+TEMPLATE_TEST_CASE(
+    "Load ascii PLY from file with parallel text parsing",
+    "",
+    Meshes,
+    Meshesf)
+{
+    using TriMesh  = std::tuple_element_t<0, TestType>;
+    using PolyMesh = std::tuple_element_t<1, TestType>;
+
+    vcl::LoadSettings parSettings;
+    parSettings.parallelTextParsing = true;
+
+    vcl::MeshInfo seqInfo, parInfo;
+
+    SECTION("TriMesh - bone")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/bone.ply";
+
+        TriMesh tm1, tm2;
+        vcl::loadPly(tm1, filename, seqInfo);
+        vcl::loadPly(tm2, filename, parInfo, parSettings);
+
+        REQUIRE(parInfo.isTriangleMesh());
+        checkSameMeshes(tm1, tm2);
+    }
+
+    SECTION("PolyMesh - cube_tri")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/cube_tri.ply";
+
+        PolyMesh pm1, pm2;
+        vcl::loadPly(pm1, filename, seqInfo);
+        vcl::loadPly(pm2, filename, parInfo, parSettings);
+
+        REQUIRE(pm2.faceCount() == 12);
+        checkSameMeshes(pm1, pm2);
+    }
+}
+
+// With tiny chunks, the vertices and the faces of an ascii PLY file are read
+// in many chunks, whose infos must be merged
+TEMPLATE_TEST_CASE(
+    "Load ascii PLY from file with parallel text parsing in tiny chunks",
+    "",
+    Meshes,
+    Meshesf)
+{
+    using TriMesh  = std::tuple_element_t<0, TestType>;
+    using PolyMesh = std::tuple_element_t<1, TestType>;
+
+    vcl::LoadSettings parSettings;
+    parSettings.parallelTextParsing = true;
+    parSettings.textChunkSize       = 16;
+
+    vcl::MeshInfo seqInfo, parInfo;
+
+    SECTION("TriMesh - bone")
+    {
+        const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/bone.ply";
+
+        TriMesh tm1, tm2;
+        vcl::loadPly(tm1, filename, seqInfo);
+        vcl::loadPly(tm2, filename, parInfo, parSettings);
+
+        REQUIRE(parInfo.isTriangleMesh());
+        checkSameMeshes(tm1, tm2);
+    }
+
+    SECTION("TriMesh - Wedge TextureDouble")
+    {
+        const std::string filename =
+            VCLIB_EXAMPLE_MESHES_PATH "/TextureDouble.ply";
+
+        TriMesh tm1, tm2;
+        vcl::loadPly(tm1, filename, seqInfo);
+        vcl::loadPly(tm2, filename, parInfo, parSettings);
+
+        REQUIRE(parInfo.hasPerFaceWedgeTexCoords());
+        checkSameMeshes(tm1, tm2);
+        for (uint i = 0; i < tm1.faceCount(); ++i) {
+            const auto& f1 = tm1.face(i);
+            const auto& f2 = tm2.face(i);
+            REQUIRE(f1.materialIndex() == f2.materialIndex());
+            for (uint j = 0; j < f1.vertexCount(); ++j) {
+                REQUIRE(f1.wedgeTexCoord(j) == f2.wedgeTexCoord(j));
+            }
+        }
+    }
+
+    SECTION("PolyMesh - mixed face sizes")
+    {
+        // a quad and two triangles: each face line is in its own chunk, and
+        // the mesh type must be computed from all the chunks
+        const std::string filename =
+            VCLIB_CORE_RESULTS_PATH "/mixed_faces_chunks.ply";
+        {
+            std::ofstream file(filename);
+            file << "ply\n"
+                    "format ascii 1.0\n"
+                    "element vertex 5\n"
+                    "property float x\n"
+                    "property float y\n"
+                    "property float z\n"
+                    "element face 3\n"
+                    "property list uchar int vertex_indices\n"
+                    "end_header\n"
+                    "0 0 0\n"
+                    "1 0 0\n"
+                    "1 1 0\n"
+                    "0 1 0\n"
+                    "2 0 0\n"
+                    "4 0 1 2 3\n"
+                    "3 1 4 2\n"
+                    "3 0 2 4\n";
+        }
+
+        PolyMesh pm1, pm2;
+        vcl::loadPly(pm1, filename, seqInfo);
+        vcl::loadPly(pm2, filename, parInfo, parSettings);
+
+        REQUIRE(seqInfo.isPolygonMesh());
+        REQUIRE(parInfo.isPolygonMesh());
+        checkSameMeshes(pm1, pm2);
+    }
+}
+
+// Loading a PLY file in blocks and writing it back block by block must give
+// the same mesh of the whole-file loader
+TEMPLATE_TEST_CASE(
+    "Load and save PLY in blocks",
+    "",
+    vcl::PointCloud,
+    vcl::PointCloudf)
+{
+    using BlockMesh = TestType;
+    using Scalar    = BlockMesh::VertexType::PositionType::ScalarType;
+
+    const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/bone.ply";
+    const std::string outFilename =
+        VCLIB_CORE_RESULTS_PATH "/bone_blocks.ply";
+
+    vcl::TriMesh tm;
+    vcl::loadMesh(tm, filename);
+
+    vcl::MeshInfo info;
+    info.setVertices();
+    info.setPerVertexPosition();
+    info.setFaces();
+    info.setPerFaceVertexReferences();
+
+    BlockMesh block;
+    uint      nVertices = 0, nFaces = 0;
+
+    SECTION("Load in blocks")
+    {
+        vcl::MeshInfo loadedInfo;
+        vcl::loadMeshBlocks(
+            block,
+            filename,
+            [&](const BlockMesh& b, uint firstVertex) {
+                REQUIRE(b.vertexCount() <= 1000);
+                REQUIRE(firstVertex == nVertices);
+                for (uint i = 0; i < b.vertexCount(); ++i) {
+                    const auto& p = tm.vertex(firstVertex + i).position();
+                    REQUIRE(b.vertex(i).position().epsilonEquals(
+                        p.template cast<Scalar>(), Scalar(1e-6)));
+                }
+                nVertices += b.vertexCount();
+            },
+            [&](const vcl::FaceBlock& f) {
+                REQUIRE(f.size() <= 1000);
+                REQUIRE(f.firstFace == nFaces);
+                uint k = 0;
+                for (uint i = 0; i < f.size(); ++i) {
+                    const auto& face = tm.face(f.firstFace + i);
+                    REQUIRE(f.sizes[i] == 3);
+                    for (uint j = 0; j < 3; ++j)
+                        REQUIRE(f.vertexIndices[k++] == face.vertexIndex(j));
+                }
+                nFaces += f.size();
+            },
+            1000,
+            loadedInfo);
+
+        REQUIRE(loadedInfo.hasVertices());
+        REQUIRE(loadedInfo.hasFaces());
+        REQUIRE(nVertices == tm.vertexCount());
+        REQUIRE(nFaces == tm.faceCount());
+    }
+
+    SECTION("Save in blocks")
+    {
+        vcl::SaveSettings settings;
+        settings.binary = false;
+
+        vcl::MeshBlockWriter writer(outFilename, info, settings);
+        vcl::loadMeshBlocks(
+            block,
+            filename,
+            [&](const BlockMesh& b, uint) { writer.writeVertices(b); },
+            [&](const vcl::FaceBlock& f) { writer.writeFaces(f); },
+            1000);
+        writer.close();
+
+        REQUIRE(writer.vertexCount() == tm.vertexCount());
+        REQUIRE(writer.faceCount() == tm.faceCount());
+
+        vcl::TriMesh tm2;
+        vcl::loadMesh(tm2, outFilename);
+
+        REQUIRE(tm2.vertexCount() == tm.vertexCount());
+        REQUIRE(tm2.faceCount() == tm.faceCount());
+        for (uint i = 0; i < tm.faceCount(); ++i) {
+            for (uint j = 0; j < 3; ++j) {
+                REQUIRE(
+                    tm2.face(i).vertexIndex(j) == tm.face(i).vertexIndex(j));
+            }
+        }
+    }
+
+    SECTION("Save in binary blocks")
+    {
+        const std::string binFilename =
+            VCLIB_CORE_RESULTS_PATH "/bone_blocks_bin.ply";
+
+        vcl::MeshBlockWriter writer(binFilename, info);
+        vcl::loadMeshBlocks(
+            block,
+            filename,
+            [&](const BlockMesh& b, uint) { writer.writeVertices(b); },
+            [&](const vcl::FaceBlock& f) { writer.writeFaces(f); },
+            1000);
+        writer.close();
+
+        REQUIRE(writer.vertexCount() == tm.vertexCount());
+        REQUIRE(writer.faceCount() == tm.faceCount());
+
+        // the element counts of the header are patched on close
+        vcl::TriMesh tm2;
+        vcl::loadMesh(tm2, binFilename);
+
+        REQUIRE(tm2.vertexCount() == tm.vertexCount());
+        for (uint i = 0; i < tm.vertexCount(); ++i) {
+            REQUIRE(tm2.vertex(i).position().epsilonEquals(
+                tm.vertex(i).position(), 1e-6));
+        }
+        REQUIRE(tm2.faceCount() == tm.faceCount());
+        for (uint i = 0; i < tm.faceCount(); ++i) {
+            for (uint j = 0; j < 3; ++j) {
+                REQUIRE(
+                    tm2.face(i).vertexIndex(j) == tm.face(i).vertexIndex(j));
+            }
+        }
+    }
+
+    SECTION("Bad vertex index")
+    {
+        vcl::MeshBlockWriter writer(outFilename, info);
+
+        vcl::FaceBlock faces;
+        faces.sizes         = {3};
+        faces.vertexIndices = {0, 1, 2};
+        REQUIRE_THROWS_AS(
+            writer.writeFaces(faces), vcl::BadVertexIndexException);
+    }
+}
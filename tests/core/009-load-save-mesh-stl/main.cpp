@@ -12,6 +12,8 @@
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+
 std::istringstream stlCube()
 {
     // string containing a triangulted cube in STL format
@@ -164,3 +166,68 @@ TEMPLATE_TEST_CASE(
         REQUIRE(count == expectedStlSize);
     }
 }
+
+// Writing a polygonal mesh to an STL file block by block must triangulate its
+// polygons, and patch the number of triangles of binary files on close
+TEMPLATE_TEST_CASE(
+    "Load and save STL in blocks",
+    "",
+    vcl::PointCloud,
+    vcl::PointCloudf)
+{
+    using BlockMesh = TestType;
+
+    const std::string filename = VCLIB_EXAMPLE_MESHES_PATH "/cube_poly.ply";
+
+    vcl::MeshInfo info;
+    info.setVertices();
+    info.setPerVertexPosition();
+    info.setFaces();
+    info.setPerFaceVertexReferences();
+
+    vcl::PolyMesh cube;
+    vcl::loadMesh(cube, filename);
+
+    BlockMesh         block;
+    vcl::SaveSettings settings;
+
+    auto checkCube = [&](const std::string& outFilename) {
+        vcl::MeshBlockWriter writer(outFilename, info, settings);
+        vcl::loadMeshBlocks(
+            block,
+            filename,
+            [&](const BlockMesh& b, uint) { writer.writeVertices(b); },
+            [&](const vcl::FaceBlock& f) { writer.writeFaces(f); },
+            3);
+        writer.close();
+
+        REQUIRE(writer.vertexCount() == 8);
+        REQUIRE(writer.faceCount() == 12);
+
+        vcl::TriMesh tm;
+        vcl::loadMesh(tm, outFilename);
+
+        // each triangle vertex is a vertex of the cube, and the triangles
+        // cover the whole surface of the cube
+        REQUIRE(tm.faceCount() == 12);
+        for (const auto& v : tm.vertices()) {
+            REQUIRE(std::ranges::any_of(cube.vertices(), [&](const auto& c) {
+                return c.position() == v.position();
+            }));
+        }
+        REQUIRE(
+            std::abs(vcl::surfaceArea(tm) - vcl::surfaceArea(cube)) < 1e-6);
+    };
+
+    SECTION("Binary STL")
+    {
+        settings.binary = true;
+        checkCube(VCLIB_CORE_RESULTS_PATH "/cube_poly_blocks_bin.stl");
+    }
+
+    SECTION("ASCII STL")
+    {
+        settings.binary = false;
+        checkCube(VCLIB_CORE_RESULTS_PATH "/cube_poly_blocks_txt.stl");
+    }
+}
@@ -12,6 +12,8 @@
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+
 template<typename MeshType, typename PointType>
 std::vector<unsigned int> getKNearestNeighbors(
     const PointType& p,
@@ -42,3 +44,145 @@ TEMPLATE_TEST_CASE(
         getKNearestNeighbors<TriMesh>(p, 5) ==
         std::vector<unsigned int> {1558, 1613, 1720, 1576, 163});
 }
+
+TEMPLATE_TEST_CASE(
+    "KD-Tree batched k nearest neighbors in bone.ply",
+    "",
+    vcl::TriMesh,
+    vcl::TriMeshf)
+{
+    using TriMesh   = TestType;
+    using PointType = TriMesh::VertexType::PositionType;
+    using Scalar    = PointType::ScalarType;
+
+    TriMesh m = vcl::loadMesh<TriMesh>(VCLIB_EXAMPLE_MESHES_PATH "/bone.ply");
+
+    vcl::KDTree tree(m);
+
+    std::vector<PointType> queries;
+    for (const auto& v : m.vertices())
+        queries.push_back(v.position() + PointType(0.01, -0.02, 0.005));
+
+    const uint k = 8;
+
+    std::vector<uint>   indices;
+    std::vector<Scalar> distances;
+    tree.kNearestNeighborsIndices(queries, k, indices, distances);
+
+    REQUIRE(indices.size() == queries.size() * k);
+    REQUIRE(distances.size() == queries.size() * k);
+
+    std::vector<Scalar> bruteForce(m.vertexCount());
+    for (uint q = 0; q < queries.size(); ++q) {
+        std::vector<Scalar> dists;
+        std::vector<uint>   neighbors =
+            tree.kNearestNeighborsIndices(queries[q], k, dists);
+
+        // the k smallest distances from all the points of the mesh
+        for (uint i = 0; i < m.vertexCount(); ++i) {
+            bruteForce[i] =
+                std::sqrt(queries[q].squaredDist(m.vertex(i).position()));
+        }
+        std::partial_sort(
+            bruteForce.begin(), bruteForce.begin() + k, bruteForce.end());
+
+        REQUIRE(neighbors.size() == k);
+        for (uint i = 0; i < k; ++i) {
+            const uint j = indices[q * k + i];
+            REQUIRE(distances[q * k + i] == bruteForce[i]);
+            REQUIRE(
+                distances[q * k + i] ==
+                std::sqrt(queries[q].squaredDist(m.vertex(j).position())));
+            REQUIRE(distances[q * k + i] == dists[i]);
+        }
+    }
+
+    SECTION("More neighbors than points")
+    {
+        TriMesh small;
+        small.addVertices(3);
+        small.vertex(1).position() = PointType(1, 0, 0);
+        small.vertex(2).position() = PointType(0, 2, 0);
+
+        vcl::KDTree smallTree(small);
+        smallTree.kNearestNeighborsIndices(
+            std::vector<PointType> {PointType(0.1, 0, 0)}, 5, indices);
+
+        REQUIRE(
+            indices ==
+            std::vector<uint> {0, 1, 2, vcl::UINT_NULL, vcl::UINT_NULL});
+    }
+}
+
+TEMPLATE_TEST_CASE(
+    "KD-Tree radius search and approximate k nearest neighbors in bone.ply",
+    "",
+    vcl::TriMesh,
+    vcl::TriMeshf)
+{
+    using TriMesh   = TestType;
+    using PointType = TriMesh::VertexType::PositionType;
+    using Scalar    = PointType::ScalarType;
+
+    TriMesh m = vcl::loadMesh<TriMesh>(VCLIB_EXAMPLE_MESHES_PATH "/bone.ply");
+
+    vcl::KDTree tree(m);
+
+    const PointType p(0.5, 0.5, 0.5);
+
+    std::vector<uint>   indices;
+    std::vector<Scalar> distances;
+
+    SECTION("Radius search")
+    {
+        const Scalar radius = 0.1;
+
+        uint n = tree.radiusSearch(p, radius, indices, distances);
+
+        std::vector<uint> expected;
+        for (const auto& v : m.vertices()) {
+            if (p.dist(v.position()) < radius)
+                expected.push_back(m.index(v));
+        }
+
+        REQUIRE(n == expected.size());
+        REQUIRE(distances.size() == n);
+        for (uint i = 0; i < n; ++i) {
+            REQUIRE(distances[i] < radius);
+        }
+        std::sort(indices.begin(), indices.end());
+        REQUIRE(indices == expected);
+
+        // capped radius search returns the closest points, that are the k
+        // nearest neighbors within the radius
+        n = tree.radiusSearch(p, radius, indices, distances, 5);
+        REQUIRE(n == 5);
+        REQUIRE(indices == tree.kNearestNeighborsIndices(p, 5));
+
+        n = tree.radiusSearch(p, Scalar(0.001), indices, distances, 5);
+        REQUIRE(n == 0);
+        REQUIRE(indices.empty());
+    }
+
+    SECTION("Approximate k nearest neighbors")
+    {
+        const uint k = 10;
+
+        std::vector<Scalar> exactDistances;
+        std::vector<uint>   exact =
+            tree.kNearestNeighborsIndices(p, k, exactDistances);
+
+        uint n = tree.kNearestNeighborsIndices(p, k, indices, distances);
+        REQUIRE(n == k);
+        REQUIRE(indices == exact);
+        REQUIRE(distances == exactDistances);
+
+        const Scalar eps = 0.5;
+        n = tree.kNearestNeighborsIndices(p, k, indices, distances, eps);
+        REQUIRE(n == k);
+        for (uint i = 0; i < k; ++i) {
+            REQUIRE(distances[i] >= exactDistances[i]);
+            REQUIRE(distances[i] <= exactDistances[i] * (1 + eps));
+        }
+    }
+}
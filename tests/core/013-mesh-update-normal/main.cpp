@@ -187,3 +187,88 @@ TEMPLATE_TEST_CASE(
             vcl::epsilonEquals(tem.vertex(6).normal(), VNormalType(1, 1, 1)));
     }
 }
+
+// The vertex normals are accumulated in parallel: the result must be identical
+// to the one of a serial scatter of the face contributions
+TEMPLATE_TEST_CASE(
+    "Parallel Vertex Normals are identical to the serial ones",
+    "",
+    vcl::TriMesh,
+    vcl::TriMeshf,
+    vcl::PolyMesh,
+    vcl::PolyMeshIndexedf)
+{
+    using MeshType    = TestType;
+    using VNormalType = MeshType::VertexType::NormalType;
+    using VNScalar    = typename VNormalType::ScalarType;
+
+    MeshType m = vcl::loadMesh<MeshType>(VCLIB_EXAMPLE_MESHES_PATH "/bone.ply");
+    m.deleteFace(10);
+
+    std::vector<VNormalType> normals(m.vertexContainerSize());
+
+    // serial scatter of the given wedge contributions
+    auto serialNormals = [&](auto&& wedgeNormal) {
+        std::fill(normals.begin(), normals.end(), VNormalType(0, 0, 0));
+        for (auto& f : m.faces()) {
+            for (uint i = 0; i < f.vertexCount(); ++i) {
+                normals[f.vertexIndex(i)] += wedgeNormal(f, i);
+            }
+        }
+    };
+
+    auto checkNormals = [&]() {
+        for (const auto& v : m.vertices()) {
+            REQUIRE(v.normal() == normals[v.index()]);
+        }
+    };
+
+    THEN("Area Weighted")
+    {
+        vcl::updatePerVertexNormals(m, false);
+        serialNormals([](const auto& f, uint) {
+            return vcl::faceNormal(f).template cast<VNScalar>();
+        });
+        checkNormals();
+    }
+
+    THEN("From Face Normals")
+    {
+        vcl::updatePerFaceNormals(m);
+        vcl::updatePerVertexNormalsFromFaceNormals(m, false);
+        serialNormals([](const auto& f, uint) {
+            return f.normal().template cast<VNScalar>();
+        });
+        checkNormals();
+    }
+
+    THEN("Angle Weighted")
+    {
+        vcl::updatePerVertexNormalsAngleWeighted(m, false);
+        serialNormals([](const auto& f, uint i) {
+            auto n = vcl::faceNormal(f).template cast<VNScalar>();
+
+            VNormalType vec1 =
+                (f.vertexMod(i - 1)->position() - f.vertexMod(i)->position())
+                    .normalized()
+                    .template cast<VNScalar>();
+            VNormalType vec2 =
+                (f.vertexMod(i + 1)->position() - f.vertexMod(i)->position())
+                    .normalized()
+                    .template cast<VNScalar>();
+            return VNormalType(n * vec1.angle(vec2));
+        });
+        checkNormals();
+    }
+
+    THEN("Normalized")
+    {
+        vcl::updatePerVertexNormals(m);
+        serialNormals([](const auto& f, uint) {
+            return vcl::faceNormal(f).template cast<VNScalar>();
+        });
+        for (auto& n : normals)
+            n.normalize();
+        checkNormals();
+    }
+}
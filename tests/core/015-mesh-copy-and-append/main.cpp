@@ -151,4 +151,111 @@ TEMPLATE_TEST_CASE(
             }
         }
     }
+
+    WHEN("Moving a mesh at the end of another mesh")
+    {
+        Mesh m2 = vcl::createTetrahedron<Mesh>();
+        m2.template addPerVertexCustomComponent<float>("v_comp");
+        for (auto& v : m2.vertices()) {
+            v.template customComponent<float>("v_comp") = v.position().z();
+        }
+        const Mesh mc = m2;
+
+        unsigned int m1vn = m1.vertexCount();
+        unsigned int m1fn = m1.faceCount();
+
+        Mesh m3 = m1;
+        m3.append(std::move(m2));
+
+        REQUIRE(m2.vertexCount() == 0);
+        REQUIRE(m2.faceCount() == 0);
+        REQUIRE(m3.vertexCount() == m1vn + mc.vertexCount());
+        REQUIRE(m3.faceCount() == m1fn + mc.faceCount());
+        REQUIRE(vcl::checkMeshPointers(m3));
+
+        for (size_t i = 0; i < mc.vertexCount(); ++i) {
+            REQUIRE(m3.vertex(m1vn + i).position() == mc.vertex(i).position());
+            REQUIRE(
+                m3.vertex(m1vn + i).template customComponent<float>(
+                    "v_comp") ==
+                mc.vertex(i).template customComponent<float>("v_comp"));
+        }
+        for (size_t i = 0; i < mc.faceCount(); ++i) {
+            for (size_t j = 0; j < mc.face(i).vertexCount(); ++j) {
+                REQUIRE(
+                    m3.face(m1fn + i).vertexIndex(j) ==
+                    mc.face(i).vertexIndex(j) + m1vn);
+            }
+        }
+    }
+
+    WHEN("Moving a mesh into an empty mesh with the same components")
+    {
+        Mesh m2 = m1;
+
+        const auto* v0 = &m2.vertex(0);
+        const auto* f0 = &m2.face(0);
+
+        Mesh m3;
+        m3.template addPerVertexCustomComponent<float>("v_comp");
+        m3.append(std::move(m2));
+
+        // the storage of m2 has been taken by m3
+        REQUIRE(&m3.vertex(0) == v0);
+        REQUIRE(&m3.face(0) == f0);
+        REQUIRE(m3.vertexCount() == m1.vertexCount());
+        REQUIRE(m3.faceCount() == m1.faceCount());
+        REQUIRE(vcl::checkMeshPointers(m3));
+
+        for (size_t i = 0; i < m1.vertexCount(); ++i) {
+            REQUIRE(m3.vertex(i).position() == m1.vertex(i).position());
+            REQUIRE(
+                m3.vertex(i).template customComponent<float>("v_comp") ==
+                m1.vertex(i).template customComponent<float>("v_comp"));
+        }
+        for (size_t i = 0; i < m1.faceCount(); ++i) {
+            REQUIRE(m3.face(i).parentMesh() == &m3);
+            REQUIRE(
+                m3.face(i).vertex(0) ==
+                &m3.vertex(m1.face(i).vertexIndex(0)));
+        }
+    }
+
+    WHEN("Appending a range of meshes")
+    {
+        Mesh m2 = vcl::createTetrahedron<Mesh>();
+        m2.template addPerVertexCustomComponent<float>("v_comp");
+        m2.deleteFace(1u);
+
+        std::vector<Mesh> tiles = {m2, m1, m2};
+
+        Mesh m3 = m1;
+        m3.append(tiles);
+
+        Mesh m4 = m1;
+        for (const Mesh& t : tiles)
+            m4.append(t);
+
+        REQUIRE(vcl::checkMeshPointers(m3));
+        REQUIRE(m3.vertexCount() == m4.vertexCount());
+        REQUIRE(m3.faceCount() == m4.faceCount());
+        REQUIRE(m3.faceContainerSize() == m4.faceContainerSize());
+
+        for (size_t i = 0; i < m4.vertexContainerSize(); ++i) {
+            REQUIRE(m3.vertex(i).position() == m4.vertex(i).position());
+            REQUIRE(
+                m3.vertex(i).template customComponent<float>("v_comp") ==
+                m4.vertex(i).template customComponent<float>("v_comp"));
+        }
+        for (size_t i = 0; i < m4.faceContainerSize(); ++i) {
+            REQUIRE(m3.face(i).deleted() == m4.face(i).deleted());
+            if (!m4.face(i).deleted()) {
+                for (size_t j = 0; j < m4.face(i).vertexCount(); ++j) {
+                    REQUIRE(
+                        m3.face(i).vertexIndex(j) ==
+                        m4.face(i).vertexIndex(j));
+                }
+            }
+        }
+    }
 }
@@ -995,3 +995,77 @@ TEMPLATE_TEST_CASE(
         }
     }
 }
+
+TEMPLATE_TEST_CASE(
+    "Export TriMesh with contiguous positions and normals to Matrix",
+    "",
+    vcl::TriMeshSoA,
+    vcl::TriMeshSoAf,
+    vcl::TriMeshSoAIndexed)
+{
+    using TriMeshSoA = TestType;
+    using ScalarType = TriMeshSoA::ScalarType;
+
+    TriMeshSoA tm = vcl::loadMesh<TriMeshSoA>(
+        VCLIB_EXAMPLE_MESHES_PATH "/bunny_simplified.obj");
+    vcl::updatePerFaceNormals(tm);
+    vcl::updatePerVertexNormals(tm);
+
+    SECTION("Positions span")
+    {
+        auto positions = tm | vcl::views::positions;
+
+        static_assert(
+            std::same_as<
+                decltype(positions),
+                std::span<typename TriMeshSoA::VertexType::PositionType>>);
+
+        REQUIRE(positions.size() == tm.vertexCount());
+        REQUIRE(positions.data() == &tm.vertex(0).position());
+        for (vcl::uint i = 0; const auto& v : tm.vertices()) {
+            REQUIRE(positions[i] == v.position());
+            ++i;
+        }
+
+        const TriMeshSoA& ctm = tm;
+        auto normals = ctm.template componentSpan<vcl::ElemId::FACE,
+                                                  vcl::CompId::NORMAL>();
+        REQUIRE(normals.size() == tm.faceCount());
+        REQUIRE(normals.data() == &tm.face(0).normal());
+    }
+
+    SECTION("Same values of TriMesh")
+    {
+        vcl::TriMeshT<ScalarType, false> m;
+        m.importFrom(tm);
+
+        auto mp = vcl::vertexPositionsMatrix<Eigen3RowMatrix<ScalarType>>(m);
+        auto tp = vcl::vertexPositionsMatrix<Eigen3RowMatrix<ScalarType>>(tm);
+        REQUIRE(mp == tp);
+
+        auto mn = vcl::faceNormalsMatrix<Eigen3RowMatrix<ScalarType>>(m);
+        auto tn = vcl::faceNormalsMatrix<Eigen3RowMatrix<ScalarType>>(tm);
+        REQUIRE(mn == tn);
+    }
+
+    SECTION("Matrices")
+    {
+        testPositionsMatrix<EigenRowMatrix<ScalarType>>(tm);
+        testPositionsMatrix<Eigen3ColMatrix<ScalarType>>(tm);
+        testPositionsMatrix<vcl::Array2<ScalarType>>(tm);
+        testVertNormalsMatrix<Eigen3RowMatrix<ScalarType>>(tm);
+        testVertNormalsMatrix<Eigen3ColMatrix<ScalarType>>(tm);
+        testFaceNormalsMatrix<Eigen3RowMatrix<ScalarType>>(tm);
+        testFaceNormalsMatrix<vcl::Array2<ScalarType>>(tm);
+    }
+
+    SECTION("Matrices of a mesh with deleted elements")
+    {
+        tm.deleteVertex(1);
+        tm.deleteFace(2);
+
+        testPositionsMatrix<Eigen3RowMatrix<ScalarType>>(tm);
+        testVertNormalsMatrix<Eigen3RowMatrix<ScalarType>>(tm);
+        testFaceNormalsMatrix<Eigen3RowMatrix<ScalarType>>(tm);
+    }
+}
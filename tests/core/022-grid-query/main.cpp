@@ -9,6 +9,8 @@
 #include "nearest.h"
 #include "sphere.h"
 
+#include <list>
+
 using Meshes         = std::tuple<vcl::TriMesh, vcl::PolyMesh>;
 using Meshesf        = std::tuple<vcl::TriMeshf, vcl::PolyMeshf>;
 using MeshesIndexed  = std::tuple<vcl::TriMeshIndexed, vcl::PolyMeshIndexed>;
@@ -209,3 +211,120 @@ TEMPLATE_TEST_CASE(
         }
     }
 }
+
+TEST_CASE("HashTableGrid insertion and erasure")
+{
+    using PointType = vcl::Point3d;
+    using GridType  = vcl::HashTableGrid3<PointType, double, false>;
+
+    vcl::Box3d bbox(PointType(0, 0, 0), PointType(1, 1, 1));
+
+    std::vector<PointType> points = randomPoints(2000, bbox);
+
+    GridType grid(points.begin(), points.end());
+
+    REQUIRE(!grid.empty());
+    REQUIRE(std::distance(grid.begin(), grid.end()) == points.size());
+
+    // duplicates are not inserted
+    REQUIRE(grid.insert(points.begin(), points.begin() + 100) == 0);
+    REQUIRE(!grid.insert(points[0]));
+
+    // each value is stored in its cell, and each cell is visited once
+    std::size_t nValues = 0;
+    for (const auto& cell : grid.nonEmptyCells()) {
+        auto [begin, end] = grid.valuesInCell(cell);
+        REQUIRE(std::distance(begin, end) == grid.countInCell(cell));
+        for (auto it = begin; it != end; ++it) {
+            REQUIRE(it->first == cell);
+            REQUIRE(grid.cell(it->second) == cell);
+        }
+        nValues += grid.countInCell(cell);
+    }
+    REQUIRE(nValues == points.size());
+
+    vcl::Sphere<double> sphere(PointType(0.5, 0.5, 0.5), 0.3);
+
+    std::size_t nInSphere = std::ranges::count_if(points, [&](const auto& p) {
+        return sphere.isInside(p);
+    });
+    REQUIRE(grid.valuesInSphere(sphere).size() == nInSphere);
+
+    grid.eraseInSphere(sphere);
+    REQUIRE(grid.valuesInSphere(sphere).empty());
+    REQUIRE(
+        std::distance(grid.begin(), grid.end()) ==
+        points.size() - nInSphere);
+
+    // the erased values can be inserted again
+    REQUIRE(grid.insert(points) == nInSphere);
+    REQUIRE(std::distance(grid.begin(), grid.end()) == points.size());
+
+    REQUIRE(grid.erase(points[0]));
+    REQUIRE(!grid.erase(points[0]));
+
+    grid.clear();
+    REQUIRE(grid.empty());
+    REQUIRE(grid.begin() == grid.end());
+    REQUIRE(grid.insert(points) == points.size());
+}
+
+TEST_CASE("StaticGrid parallel build")
+{
+    using PointType = vcl::Point3d;
+    using GridType  = vcl::StaticGrid3<PointType, double>;
+
+    vcl::Box3d bbox(PointType(0, 0, 0), PointType(1, 1, 1));
+
+    // repeated points, to have cells containing many values
+    std::vector<PointType> points = randomPoints(20000, bbox);
+    for (vcl::uint i = 0; i < 10000; ++i)
+        points.push_back(points[i % 500]);
+
+    // random access iterators: parallel insertion
+    const GridType grid(points.begin(), points.end());
+
+    // forward iterators: serial insertion
+    std::list<PointType> pointList(points.begin(), points.end());
+    const GridType       serialGrid(pointList.begin(), pointList.end());
+
+    // values are sorted by cell, keeping the insertion order in each cell
+    std::vector<PointType> expected = points;
+    std::ranges::stable_sort(expected, {}, [&](const PointType& p) {
+        return grid.indexOfCell(grid.cell(p));
+    });
+
+    auto sit = serialGrid.begin();
+    auto eit = expected.begin();
+    for (auto it = grid.begin(); it != grid.end(); ++it, ++sit, ++eit) {
+        REQUIRE(eit != expected.end());
+        REQUIRE(it->second == *eit);
+        REQUIRE(sit->second == *eit);
+    }
+    REQUIRE(eit == expected.end());
+    REQUIRE(sit == serialGrid.end());
+
+    std::size_t nValues = 0;
+    for (const auto& cell : grid.nonEmptyCells()) {
+        auto [begin, end] = grid.valuesInCell(cell);
+        std::size_t cnt   = 0;
+        for (auto it = begin; it != end; ++it, ++cnt) {
+            REQUIRE(grid.cell(it->second) == cell);
+        }
+        REQUIRE(cnt == grid.countInCell(cell));
+        nValues += cnt;
+    }
+    REQUIRE(nValues == points.size());
+
+    for (const auto& p : randomPoints(200, bbox)) {
+        double d1 = std::numeric_limits<double>::max();
+        double d2 = d1;
+
+        auto it1 = grid.closestValue(p, d1);
+        auto it2 = serialGrid.closestValue(p, d2);
+        REQUIRE(it1 != grid.end());
+        REQUIRE(it2 != serialGrid.end());
+        REQUIRE(it1->second == it2->second);
+        REQUIRE(d1 == d2);
+    }
+}
@@ -0,0 +1,275 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <vclib/algorithms.h>
+#include <vclib/io.h>
+#include <vclib/meshes.h>
+#include <vclib/space.h>
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+static const vcl::uint N_QUERIES_TEST = 50;
+
+template<typename PointType, typename BoxType>
+std::vector<PointType> randomPoints(
+    vcl::uint      n,
+    const BoxType& bbox,
+    std::mt19937&  gen)
+{
+    using ScalarType = PointType::ScalarType;
+
+    std::uniform_real_distribution<ScalarType> dis(0, 1);
+
+    std::vector<PointType> points(n);
+    for (auto& p : points) {
+        for (vcl::uint i = 0; i < 3; ++i) {
+            p[i] = bbox.min()[i] + dis(gen) * bbox.dim(i) * 1.2 -
+                   bbox.dim(i) * 0.1;
+        }
+    }
+    return points;
+}
+
+TEMPLATE_TEST_CASE(
+    "FaceBVH queries on bunny.obj",
+    "",
+    vcl::TriMesh,
+    vcl::TriMeshf,
+    vcl::PolyMesh)
+{
+    using MeshType   = TestType;
+    using FaceType   = MeshType::FaceType;
+    using PointType  = MeshType::VertexType::PositionType;
+    using ScalarType = PointType::ScalarType;
+
+    MeshType m =
+        vcl::loadMesh<MeshType>(VCLIB_EXAMPLE_MESHES_PATH "/bunny.obj");
+
+    const auto bbox = vcl::boundingBox(m);
+
+    std::mt19937 gen(42);
+
+    vcl::FaceBVH bvh(m);
+
+    REQUIRE(bvh.size() == m.faceCount());
+
+    SECTION("Closest face")
+    {
+        auto points = randomPoints<PointType>(N_QUERIES_TEST, bbox, gen);
+
+        for (const PointType& p : points) {
+            ScalarType minDist = std::numeric_limits<ScalarType>::max();
+            for (const FaceType& f : m.faces()) {
+                minDist = std::min(minDist, vcl::distance(p, f));
+            }
+
+            ScalarType      dist = 0;
+            const FaceType* f    = bvh.closestFace(p, dist);
+
+            REQUIRE(f != nullptr);
+            REQUIRE(vcl::epsilonEquals(dist, minDist));
+            REQUIRE(vcl::epsilonEquals(vcl::distance(p, *f), minDist));
+        }
+
+        // no face closer than the max distance
+        ScalarType dist = -1;
+        REQUIRE(
+            bvh.closestFace(bbox.max() * 10, dist, bbox.diagonal()) ==
+            nullptr);
+        REQUIRE(dist == -1);
+    }
+
+    SECTION("Ray hits")
+    {
+        auto origins = randomPoints<PointType>(N_QUERIES_TEST, bbox, gen);
+
+        for (const PointType& o : origins) {
+            vcl::Ray<PointType> ray(o, bbox.center() - o);
+
+            std::vector<ScalarType> bruteT;
+            for (const FaceType& f : m.faces()) {
+                ScalarType t;
+                if (vcl::intersection(ray, f, t))
+                    bruteT.push_back(t);
+            }
+            std::sort(bruteT.begin(), bruteT.end());
+
+            std::vector<ScalarType>      ts;
+            std::vector<const FaceType*> hits = bvh.allRayHits(ray, ts);
+
+            REQUIRE(hits.size() == bruteT.size());
+            REQUIRE(ts.size() == bruteT.size());
+            for (vcl::uint i = 0; i < ts.size(); ++i)
+                REQUIRE(ts[i] == bruteT[i]);
+
+            ScalarType      t = -1;
+            const FaceType* f = bvh.firstRayHit(ray, t);
+            if (bruteT.empty()) {
+                REQUIRE(f == nullptr);
+            }
+            else {
+                REQUIRE(f != nullptr);
+                REQUIRE(t == bruteT.front());
+            }
+        }
+    }
+
+    SECTION("Faces in box")
+    {
+        auto centers = randomPoints<PointType>(N_QUERIES_TEST, bbox, gen);
+
+        for (const PointType& c : centers) {
+            vcl::Box<PointType> box(c);
+            box.add(c, bbox.diagonal() * 0.05);
+
+            std::vector<const FaceType*> brute;
+            for (const FaceType& f : m.faces()) {
+                if (vcl::intersect(f, box))
+                    brute.push_back(&f);
+            }
+
+            std::vector<const FaceType*> res = bvh.facesInBox(box);
+            std::sort(res.begin(), res.end());
+
+            REQUIRE(res == brute);
+        }
+    }
+
+    SECTION("Faces in sphere")
+    {
+        auto centers = randomPoints<PointType>(N_QUERIES_TEST, bbox, gen);
+
+        for (const PointType& c : centers) {
+            vcl::Sphere<ScalarType> sphere(c, bbox.diagonal() * 0.05);
+
+            std::vector<const FaceType*> brute;
+            for (const FaceType& f : m.faces()) {
+                if (vcl::distance(c, f) <= sphere.radius())
+                    brute.push_back(&f);
+            }
+
+            std::vector<const FaceType*> res = bvh.facesInSphere(sphere);
+            std::sort(res.begin(), res.end());
+
+            REQUIRE(res == brute);
+        }
+    }
+}
+
+TEST_CASE("Mesh-sphere intersection using FaceBVH")
+{
+    vcl::TriMesh m =
+        vcl::loadMesh<vcl::TriMesh>(VCLIB_EXAMPLE_MESHES_PATH "/bunny.obj");
+
+    const auto bbox = vcl::boundingBox(m);
+
+    vcl::FaceBVH bvh(m);
+
+    vcl::Sphere<double> sphere(bbox.center(), bbox.diagonal() * 0.2);
+
+    vcl::TriMesh r1 = vcl::intersection(m, sphere);
+    vcl::TriMesh r2 = vcl::intersection(m, bvh, sphere);
+
+    REQUIRE(r2.faceCount() > 0);
+    // the faces are selected using their exact distance from the center,
+    // therefore the result may differ from the one of the plain intersection
+    // only on few faces close to the border of the sphere
+    REQUIRE(r2.faceCount() <= r1.faceCount());
+    REQUIRE(r1.faceCount() - r2.faceCount() < r1.faceCount() / 100);
+    for (const auto& f : r2.faces()) {
+        REQUIRE(
+            vcl::distance(sphere.center(), f) <=
+            sphere.radius() * (1 + 1e-6));
+    }
+}
+
+TEST_CASE("Hausdorff distance using FaceBVH")
+{
+    vcl::TriMesh m1 =
+        vcl::loadMesh<vcl::TriMesh>(VCLIB_EXAMPLE_MESHES_PATH "/bunny.obj");
+    vcl::TriMesh m2 =
+        vcl::loadMesh<vcl::TriMesh>(VCLIB_EXAMPLE_MESHES_PATH "/bunny.obj");
+
+    vcl::updateBoundingBox(m1);
+    vcl::taubinSmoothing(m2, 10, 0.5, -0.53);
+
+    auto grid = vcl::hausdorffDistance(m1, m2);
+    auto bvh  = vcl::hausdorffDistance(
+        m1,
+        m2,
+        vcl::nullLogger,
+        vcl::HAUSDORFF_VERTEX_UNIFORM,
+        0,
+        std::monostate(),
+        vcl::HAUSDORFF_FACE_BVH);
+
+    REQUIRE(vcl::epsilonEquals(grid.minDist, bvh.minDist));
+    REQUIRE(vcl::epsilonEquals(grid.maxDist, bvh.maxDist));
+    REQUIRE(vcl::epsilonEquals(grid.meanDist, bvh.meanDist));
+    REQUIRE(vcl::epsilonEquals(grid.RMSDist, bvh.RMSDist));
+}
+
+// The distances are reduced in blocks that are merged in block order: the
+// result must match the one of a serial loop over the samples
+TEST_CASE("Blocked Hausdorff reduction matches a serial run")
+{
+    vcl::TriMesh m1 =
+        vcl::loadMesh<vcl::TriMesh>(VCLIB_EXAMPLE_MESHES_PATH "/bunny.obj");
+    vcl::TriMesh m2 =
+        vcl::loadMesh<vcl::TriMesh>(VCLIB_EXAMPLE_MESHES_PATH "/bunny.obj");
+
+    vcl::updateBoundingBox(m1);
+    vcl::taubinSmoothing(m2, 10, 0.5, -0.53);
+
+    // all the vertices of m2 are used as samples, in order
+    auto res = vcl::hausdorffDistance(
+        m1,
+        m2,
+        vcl::nullLogger,
+        vcl::HAUSDORFF_VERTEX_UNIFORM,
+        0,
+        std::monostate(),
+        vcl::HAUSDORFF_FACE_BVH);
+
+    REQUIRE(m2.vertexCount() > 4 * 1024); // more than one block
+
+    vcl::FaceBVH bvh(m1);
+
+    vcl::HausdorffDistResult ser;
+    ser.histogram =
+        vcl::Histogramd(0, m1.boundingBox().diagonal() / 100, 100);
+    for (const auto& v : m2.vertices()) {
+        double dist;
+        REQUIRE(bvh.closestFace(v.position(), dist) != nullptr);
+        ser.minDist = std::min(ser.minDist, dist);
+        ser.maxDist = std::max(ser.maxDist, dist);
+        ser.meanDist += dist;
+        ser.RMSDist += dist * dist;
+        ser.histogram.addValue(dist);
+    }
+    ser.meanDist /= m2.vertexCount();
+    ser.RMSDist = std::sqrt(ser.RMSDist / m2.vertexCount());
+
+    REQUIRE(res.minDist == ser.minDist);
+    REQUIRE(res.maxDist == ser.maxDist);
+    // the sums are accumulated in a different order
+    REQUIRE(std::abs(res.meanDist - ser.meanDist) <= 1e-12 * ser.meanDist);
+    REQUIRE(std::abs(res.RMSDist - ser.RMSDist) <= 1e-12 * ser.RMSDist);
+
+    REQUIRE(res.histogram.binCount() == ser.histogram.binCount());
+    for (uint i = 0; i < ser.histogram.binCount(); ++i) {
+        REQUIRE(
+            res.histogram.binValuesCount(i) ==
+            ser.histogram.binValuesCount(i));
+    }
+    REQUIRE(res.histogram.valueCount() == ser.histogram.valueCount());
+    REQUIRE(res.histogram.valueMin() == ser.histogram.valueMin());
+    REQUIRE(res.histogram.valueMax() == ser.histogram.valueMax());
+}
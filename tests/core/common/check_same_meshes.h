@@ -0,0 +1,41 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCLIB_CORE_TESTS_COMMON_CHECK_SAME_MESHES_H
+#define VCLIB_CORE_TESTS_COMMON_CHECK_SAME_MESHES_H
+
+#include <vclib/mesh.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+/**
+ * @brief Checks that the two meshes have the same vertex positions and, if
+ * they have faces, the same faces (same number of vertices and same vertex
+ * indices).
+ */
+template<vcl::MeshConcept MeshType1, vcl::MeshConcept MeshType2>
+void checkSameMeshes(const MeshType1& m1, const MeshType2& m2)
+{
+    REQUIRE(m1.vertexCount() == m2.vertexCount());
+    for (vcl::uint i = 0; i < m1.vertexCount(); ++i) {
+        REQUIRE(m1.vertex(i).position() == m2.vertex(i).position());
+    }
+
+    if constexpr (
+        vcl::FaceMeshConcept<MeshType1> && vcl::FaceMeshConcept<MeshType2>) {
+        REQUIRE(m1.faceCount() == m2.faceCount());
+        for (vcl::uint i = 0; i < m1.faceCount(); ++i) {
+            REQUIRE(m1.face(i).vertexCount() == m2.face(i).vertexCount());
+            for (vcl::uint j = 0; j < m1.face(i).vertexCount(); ++j) {
+                REQUIRE(
+                    m1.face(i).vertexIndex(j) == m2.face(i).vertexIndex(j));
+            }
+        }
+    }
+}
+
+#endif // VCLIB_CORE_TESTS_COMMON_CHECK_SAME_MESHES_H
@@ -40,6 +40,14 @@ void initDistanceAlgorithms(pybind11::module& m)
             HausdorffSamplingMethod::HAUSDORFF_MONTECARLO)
         .export_values();
 
+    // bind enum HausdorffSpatialIndex
+    py::enum_<HausdorffSpatialIndex>(m, "HausdorffSpatialIndex")
+        .value(
+            "HAUSDORFF_STATIC_GRID",
+            HausdorffSpatialIndex::HAUSDORFF_STATIC_GRID)
+        .value("HAUSDORFF_FACE_BVH", HausdorffSpatialIndex::HAUSDORFF_FACE_BVH)
+        .export_values();
+
     auto fAllMeshes = []<MeshConcept MeshType>(
                           pybind11::module& m, MeshType = MeshType()) {
         // TODO: bind between different types of meshes
@@ -50,15 +58,23 @@ void initDistanceAlgorithms(pybind11::module& m)
                const MeshType&         m2,
                HausdorffSamplingMethod sampMethod,
                uint                    nSamples,
-               std::optional<uint>     seed) -> HausdorffDistResult {
+               std::optional<uint>     seed,
+               HausdorffSpatialIndex   index) -> HausdorffDistResult {
                 return hausdorffDistance(
-                    m1, m2, nullLogger, sampMethod, nSamples, toRConfig(seed));
+                    m1,
+                    m2,
+                    nullLogger,
+                    sampMethod,
+                    nSamples,
+                    toRConfig(seed),
+                    index);
             },
             "mesh1"_a,
             "mesh2"_a,
-            "samp_method"_a = HAUSDORFF_VERTEX_UNIFORM,
-            "n_samples"_a   = 0,
-            "seed"_a        = py::none());
+            "samp_method"_a   = HAUSDORFF_VERTEX_UNIFORM,
+            "n_samples"_a     = 0,
+            "seed"_a          = py::none(),
+            "spatial_index"_a = HAUSDORFF_STATIC_GRID);
     };
 
     defForAllMeshTypes(m, fAllMeshes);
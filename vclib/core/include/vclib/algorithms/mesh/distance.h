@@ -13,6 +13,8 @@
 #include <vclib/mesh.h>
 #include <vclib/space/complex.h>
 
+#include <atomic>
+
 namespace vcl {
 
 struct HausdorffDistResult
@@ -30,8 +32,34 @@ enum HausdorffSamplingMethod {
     HAUSDORFF_MONTECARLO
 };
 
+enum HausdorffSpatialIndex { HAUSDORFF_STATIC_GRID = 0, HAUSDORFF_FACE_BVH };
+
 namespace detail {
 
+// distance between a sample and the closest value stored in a grid; returns
+// false if no value was found
+template<typename GridType, PointConcept PointType, typename ScalarType>
+bool closestDistance(const GridType& g, const PointType& p, ScalarType& dist)
+{
+    return g.closestValue(p, dist) != g.end();
+}
+
+template<FaceConcept FaceType, PointConcept PointType, typename ScalarType>
+bool closestDistance(
+    const FaceBVH<FaceType>& bvh,
+    const PointType&         p,
+    ScalarType&              dist)
+{
+    using BVHScalar = FaceBVH<FaceType>::ScalarType;
+
+    BVHScalar d;
+    if (bvh.closestFace(p.template cast<BVHScalar>(), d)) {
+        dist = d;
+        return true;
+    }
+    return false;
+}
+
 template<
     MeshConcept         MeshType,
     PointSamplerConcept SamplerType,
@@ -43,8 +71,7 @@ HausdorffDistResult hausdorffDist(
     const GridType&    g,
     LogType&           log)
 {
-    using PointSampleType = SamplerType::PointType;
-    using ScalarType      = PointSampleType::ScalarType;
+    using ScalarType = SamplerType::PointType::ScalarType;
 
     HausdorffDistResult res;
     res.histogram = Histogramd(0, m.boundingBox().diagonal() / 100, 100);
@@ -55,32 +82,55 @@ HausdorffDistResult hausdorffDist(
 
     log.startProgress("", s.size());
 
-    std::mutex mutex;
-
-    uint ns = 0;
-    uint i  = 0;
-    parallelFor(s, [&](const PointSampleType& sample) {
-        //    for (const PointSampleType& sample : s) {
-        ScalarType dist = std::numeric_limits<ScalarType>::max();
-        const auto iter = g.closestValue(sample, dist);
-
-        if (iter != g.end()) {
-            mutex.lock();
-            ns++;
-            if (dist > res.maxDist)
-                res.maxDist = dist;
-            if (dist < res.minDist)
-                res.minDist = dist;
-            res.meanDist += dist;
-            res.RMSDist += dist * dist;
-            res.histogram.addValue(dist);
-            mutex.unlock();
+    // the samples are split in blocks that depend only on the number of
+    // samples; each block computes its partial result, and the partial results
+    // are merged in block order: the result does not depend on the number of
+    // threads
+    const uint blockSize = std::max<uint>(1024, s.size() / 1024);
+    const uint nBlocks   = (s.size() + blockSize - 1) / blockSize;
+
+    std::vector<HausdorffDistResult> partials(nBlocks, res);
+    std::vector<uint>                partialCounts(nBlocks, 0);
+
+    std::atomic<uint> processed = 0;
+
+    parallelForBlocks(s.size(), blockSize, [&](uint begin, uint end) {
+        HausdorffDistResult& p  = partials[begin / blockSize];
+        uint&                pn = partialCounts[begin / blockSize];
+
+        for (uint i = begin; i < end; ++i) {
+            ScalarType dist = std::numeric_limits<ScalarType>::max();
+
+            if (closestDistance(g, s.sample(i), dist)) {
+                pn++;
+                if (dist > p.maxDist)
+                    p.maxDist = dist;
+                if (dist < p.minDist)
+                    p.minDist = dist;
+                p.meanDist += dist;
+                p.RMSDist += dist * dist;
+                p.histogram.addValue(dist);
+            }
         }
 
-        log.progress(++i);
-        //    }
+        // progress is reported once per block; the logger is thread safe
+        log.progress(processed.fetch_add(end - begin) + end - begin);
     });
 
+    uint ns = 0;
+    for (uint b = 0; b < nBlocks; ++b) {
+        const HausdorffDistResult& p = partials[b];
+
+        ns += partialCounts[b];
+        if (p.maxDist > res.maxDist)
+            res.maxDist = p.maxDist;
+        if (p.minDist < res.minDist)
+            res.minDist = p.minDist;
+        res.meanDist += p.meanDist;
+        res.RMSDist += p.RMSDist;
+        res.histogram.merge(p.histogram);
+    }
+
     log.endProgress();
     log.log(100, "Computed " + std::to_string(ns) + " distances.");
     if (ns != s.size()) {
@@ -105,6 +155,7 @@ template<
 HausdorffDistResult samplerMeshHausdorff(
     const MeshType&    m,
     const SamplerType& s,
+    HausdorffSpatialIndex,
     LogType&           log) requires (!HasFaces<MeshType>)
 {
     using VertexType = MeshType::VertexType;
@@ -129,9 +180,10 @@ template<
     PointSamplerConcept SamplerType,
     LoggerConcept       LogType>
 HausdorffDistResult samplerMeshHausdorff(
-    const MeshType&    m,
-    const SamplerType& s,
-    LogType&           log)
+    const MeshType&       m,
+    const SamplerType&    s,
+    HausdorffSpatialIndex index,
+    LogType&              log)
 {
     using VertexType = MeshType::VertexType;
     using FaceType   = MeshType::FaceType;
@@ -152,6 +204,15 @@ HausdorffDistResult samplerMeshHausdorff(
 
         return hausdorffDist(m, s, grid, log);
     }
+    else if (index == HAUSDORFF_FACE_BVH) {
+        log.log(0, "Building BVH on " + meshName + " faces...");
+
+        FaceBVH<FaceType> bvh(m);
+
+        log.log(5, "BVH built.");
+
+        return hausdorffDist(m, s, bvh, log);
+    }
     else {
         log.log(0, "Building Grid on " + meshName + " faces...");
 
@@ -172,13 +233,14 @@ template<
     PointSamplerConcept SamplerType,
     LoggerConcept       LogType>
 HausdorffDistResult hausdorffDistance(
-    const MeshType1&   m1,
-    const MeshType2&   m2,
-    uint               nSamples,
-    RandomConfig       config,
-    SamplerType&       sampler,
-    std::vector<uint>& birth,
-    LogType&           log)
+    const MeshType1&      m1,
+    const MeshType2&      m2,
+    uint                  nSamples,
+    RandomConfig          config,
+    SamplerType&          sampler,
+    std::vector<uint>&    birth,
+    HausdorffSpatialIndex index,
+    LogType&              log)
 {
     std::string meshName1 = "first mesh";
     std::string meshName2 = "second mesh";
@@ -209,7 +271,7 @@ HausdorffDistResult hausdorffDistance(
     log.startNewTask(
         5, 100, "Computing distance between samples and " + meshName1 + "...");
 
-    auto res = samplerMeshHausdorff(m1, sampler, log);
+    auto res = samplerMeshHausdorff(m1, sampler, index, log);
 
     log.endTask("Distance between samples and " + meshName1 + " computed.");
 
@@ -228,7 +290,8 @@ HausdorffDistResult hausdorffDistance(
     LogType&                log        = nullLogger,
     HausdorffSamplingMethod sampMethod = HAUSDORFF_VERTEX_UNIFORM,
     uint                    nSamples   = 0,
-    RandomConfig            config     = std::monostate())
+    RandomConfig            config     = std::monostate(),
+    HausdorffSpatialIndex   index      = HAUSDORFF_STATIC_GRID)
 {
     if (nSamples == 0)
         nSamples = m2.vertexCount();
@@ -240,7 +303,7 @@ HausdorffDistResult hausdorffDistance(
         PointSampler<typename MeshType2::VertexType::PositionType> sampler;
 
         return detail::hausdorffDistance<HAUSDORFF_VERTEX_UNIFORM>(
-            m1, m2, nSamples, config, sampler, birth, log);
+            m1, m2, nSamples, config, sampler, birth, index, log);
     }
 
     case HAUSDORFF_EDGE_UNIFORM: {
@@ -252,7 +315,7 @@ HausdorffDistResult hausdorffDistance(
             PointSampler<typename MeshType2::VertexType::PositionType> sampler;
 
             return detail::hausdorffDistance<HAUSDORFF_MONTECARLO>(
-                m1, m2, nSamples, config, sampler, birth, log);
+                m1, m2, nSamples, config, sampler, birth, index, log);
         }
         else {
             throw std::runtime_error(
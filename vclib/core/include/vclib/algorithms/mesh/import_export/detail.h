@@ -11,6 +11,9 @@
 #include <vclib/space/complex.h>
 #include <vclib/space/core.h>
 
+#include <algorithm>
+#include <type_traits>
+
 namespace vcl::detail {
 
 // given a buffer, returns a reference to the element at (i,j) considering the
@@ -31,6 +34,42 @@ inline auto& at(
     }
 }
 
+// if the component COMP_ID of the elements ELEM_ID of the mesh is vertical and
+// each value is stored as N contiguous scalars of the same type of the buffer,
+// copies all the values to the buffer with a single copy and returns true.
+// This is possible only when the storage is row-major, the element container is
+// compact and the number of rows is the number of elements. Otherwise, returns
+// false without touching the buffer.
+template<uint ELEM_ID, uint COMP_ID, uint N, typename MeshType, typename T>
+bool copyContiguousComponent(
+    const MeshType&   mesh,
+    T*                buffer,
+    MatrixStorageType storage,
+    uint              numRows)
+{
+    if constexpr (MeshType::template hasPerElementVerticalComponent<
+                      ELEM_ID,
+                      COMP_ID>()) {
+        auto span = mesh.template componentSpan<ELEM_ID, COMP_ID>();
+
+        using ValueType  = typename decltype(span)::value_type;
+        using ScalarType = typename ValueType::ScalarType;
+
+        if constexpr (
+            std::is_same_v<ScalarType, T> &&
+            sizeof(ValueType) == N * sizeof(T)) {
+            const uint n = mesh.template count<ELEM_ID>();
+            if (storage == MatrixStorageType::ROW_MAJOR && span.size() == n &&
+                (numRows == UINT_NULL || numRows == n)) {
+                if (n > 0)
+                    std::copy_n(span[0].data(), n * N, buffer);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 inline TriPolyIndexBiMap indexMap;
 
 } // namespace vcl::detail
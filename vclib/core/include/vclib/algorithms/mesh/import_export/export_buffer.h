@@ -41,6 +41,11 @@ namespace vcl {
  * when the mesh has deleted vertices. To be sure to have a direct
  * correspondence, compact the vertex container before calling this function.
  *
+ * @note If the vertex positions are stored contiguously (vertical component,
+ * e.g. in a TriMeshSoA), the scalar type of the buffer is the one of the
+ * positions, the storage is row-major and the vertex container is compact,
+ * the positions are copied in the buffer with a single memory copy.
+ *
  * @param[in] mesh: input mesh
  * @param[out] buffer: preallocated buffer
  * @param[in] storage: storage type of the matrix (row or column major)
@@ -58,6 +63,10 @@ void vertexPositionsToBuffer(
 {
     using namespace detail;
 
+    if (copyContiguousComponent<ElemId::VERTEX, CompId::POSITION, 3>(
+            mesh, buffer, storage, numRows))
+        return;
+
     const uint NUM_ROWS = numRows == UINT_NULL ? mesh.vertexCount() : numRows;
     for (uint i = 0; const auto& p : mesh.vertices() | views::positions) {
         at(buffer, i, 0, NUM_ROWS, 3, storage) = p.x();
@@ -688,6 +697,10 @@ void elementNormalsToBuffer(
 
     requirePerElementComponent<ELEM_ID, CompId::NORMAL>(mesh);
 
+    if (!normalize && copyContiguousComponent<ELEM_ID, CompId::NORMAL, 3>(
+                          mesh, buffer, storage, numRows))
+        return;
+
     const uint NUM_ROWS =
         numRows == UINT_NULL ? mesh.template count<ELEM_ID>() : numRows;
 
@@ -10,6 +10,7 @@
 
 #include <vclib/algorithms/core.h>
 #include <vclib/mesh.h>
+#include <vclib/space/complex.h>
 
 /**
  * @defgroup intersection_mesh Mesh Intersection Algorithms
@@ -153,27 +154,13 @@ EdgeMesh intersection(const MeshType& m, const PlaneType& pl)
     return em;
 }
 
-/**
- * @brief Compute the intersection between a mesh and a ball.
- *
- * Given a mesh and a sphere, returns a new mesh made by a copy of all the faces
- * entirely included in the sphere, plus new faces created by refining the ones
- * intersected by the sphere border. It works by recursively splitting the
- * triangles that cross the border, as long as their area is greater than a
- * given value tol.
- *
- * @note The returned mesh is a triangle soup
- *
- * @param m
- * @param sphere
- * @param tol
- * @return
- *
- * @ingroup intersection_mesh
- */
+namespace detail {
+
+// refines the faces of res that cross the border of the sphere, and deletes the
+// ones that lie outside the sphere
 template<FaceMeshConcept MeshType, typename SScalar>
-MeshType intersection(
-    const MeshType&        m,
+void refineSphereIntersection(
+    MeshType&              res,
     const Sphere<SScalar>& sphere,
     double                 tol)
 {
@@ -182,12 +169,6 @@ MeshType intersection(
     using ScalarType   = PositionType::ScalarType;
     using FaceType     = MeshType::FaceType;
 
-    auto faceSphereIntersectionFilter = [&sphere](const FaceType& f) -> bool {
-        return intersect(f, sphere);
-    };
-
-    MeshType res = perFaceMeshFilter(m, faceSphereIntersectionFilter);
-
     uint i = 0;
     while (i < res.faceContainerSize()) {
         FaceType& f = res.face(i);
@@ -246,6 +227,43 @@ MeshType intersection(
 
         ++i;
     }
+}
+
+} // namespace detail
+
+/**
+ * @brief Compute the intersection between a mesh and a ball.
+ *
+ * Given a mesh and a sphere, returns a new mesh made by a copy of all the faces
+ * entirely included in the sphere, plus new faces created by refining the ones
+ * intersected by the sphere border. It works by recursively splitting the
+ * triangles that cross the border, as long as their area is greater than a
+ * given value tol.
+ *
+ * @note The returned mesh is a triangle soup
+ *
+ * @param m
+ * @param sphere
+ * @param tol
+ * @return
+ *
+ * @ingroup intersection_mesh
+ */
+template<FaceMeshConcept MeshType, typename SScalar>
+MeshType intersection(
+    const MeshType&        m,
+    const Sphere<SScalar>& sphere,
+    double                 tol)
+{
+    using FaceType = MeshType::FaceType;
+
+    auto faceSphereIntersectionFilter = [&sphere](const FaceType& f) -> bool {
+        return intersect(f, sphere);
+    };
+
+    MeshType res = perFaceMeshFilter(m, faceSphereIntersectionFilter);
+
+    detail::refineSphereIntersection(res, sphere, tol);
 
     return res;
 }
@@ -264,6 +282,67 @@ MeshType intersection(const MeshType& m, const Sphere<SScalar>& sphere)
     return intersection(m, sphere, tol);
 }
 
+/**
+ * @brief Compute the intersection between a mesh and a ball, using a FaceBVH
+ * built on the faces of the mesh to find the faces intersected by the sphere.
+ *
+ * It gives the same result of intersection(const MeshType&, const
+ * Sphere<SScalar>&, double), but only the faces stored in the leaves of the
+ * BVH that are close to the sphere are tested, instead of all the faces of the
+ * mesh. It is convenient when many intersections are computed on the same
+ * mesh.
+ *
+ * @note The returned mesh is a triangle soup
+ *
+ * @param m: the input mesh.
+ * @param bvh: a FaceBVH built on the faces of m.
+ * @param sphere: the query sphere.
+ * @param tol: the faces crossing the border of the sphere are refined as long
+ * as their area is greater than tol.
+ * @return the intersection between the mesh and the sphere.
+ *
+ * @ingroup intersection_mesh
+ */
+template<FaceMeshConcept MeshType, typename SScalar>
+MeshType intersection(
+    const MeshType&                             m,
+    const FaceBVH<typename MeshType::FaceType>& bvh,
+    const Sphere<SScalar>&                      sphere,
+    double                                      tol)
+{
+    using FaceType = MeshType::FaceType;
+
+    std::vector<bool> inSphere(m.faceContainerSize(), false);
+    for (const FaceType* f : bvh.facesInSphere(sphere))
+        inSphere[m.index(f)] = true;
+
+    MeshType res = perFaceMeshFilter(m, [&](const FaceType& f) {
+        return bool(inSphere[m.index(f)]);
+    });
+
+    detail::refineSphereIntersection(res, sphere, tol);
+
+    return res;
+}
+
+/**
+ * @copydoc intersection(const MeshType&, const FaceBVH<typename
+ * MeshType::FaceType>&, const Sphere<SScalar>&, double)
+ *
+ * The tolerance is set as 1/10^5*2*pi*radius.
+ *
+ * @ingroup intersection_mesh
+ */
+template<FaceMeshConcept MeshType, typename SScalar>
+MeshType intersection(
+    const MeshType&                             m,
+    const FaceBVH<typename MeshType::FaceType>& bvh,
+    const Sphere<SScalar>&                      sphere)
+{
+    double tol = M_PI * sphere.radius() * sphere.radius() / 100000;
+    return intersection(m, bvh, sphere, tol);
+}
+
 } // namespace vcl
 
 #endif // VCL_ALGORITHMS_MESH_INTERSECTION_H
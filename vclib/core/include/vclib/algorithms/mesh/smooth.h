@@ -200,18 +200,16 @@ void smoothPerVertexNormalsPointCloud(
 {
     requirePerVertexNormal(m);
 
-    using Scalar     = PointType::ScalarType;
     using VertexType = MeshType::VertexType;
     using NormalType = VertexType::NormalType;
 
     std::vector<NormalType> TD(m.vertexContainerSize(), NormalType(0, 0, 0));
+    std::vector<uint>       neighbors;
 
     for (uint ii = 0; ii < iterCount; ++ii) {
         for (const VertexType& v : m.vertices()) {
-            std::vector<Scalar> distances;
-
-            std::vector<uint> neighbors = tree.kNearestNeighborsIndices(
-                v.position(), neighborCount, distances);
+            tree.kNearestNeighborsIndices(
+                v.position(), neighborCount, neighbors);
 
             for (uint nid : neighbors) {
                 if (m.vertex(nid).normal() * v.normal() > 0) {
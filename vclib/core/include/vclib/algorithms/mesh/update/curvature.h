@@ -239,11 +239,8 @@ void updatePrincipalCurvaturePCA(
     using NormalType   = VertexType::NormalType;
     using FaceType     = MeshType::FaceType;
 
-    using VGrid         = StaticGrid3<VertexType*, ScalarType>;
-    using VGridIterator = VGrid::ConstIterator;
-
-    VGrid      pGrid;
-    ScalarType area;
+    KDTree<PositionType> tree;
+    ScalarType           area;
 
     log.log(0, "Updating per vertex normals...");
 
@@ -254,9 +251,8 @@ void updatePrincipalCurvaturePCA(
     log.startProgress("", m.vertexCount());
 
     if (montecarloSampling) {
-        area  = surfaceArea(m);
-        pGrid = VGrid(m.vertices() | views::addrOf);
-        pGrid.build();
+        area = surfaceArea(m);
+        tree = KDTree<PositionType>(m);
     }
 
     parallelFor(m.vertices(), [&](VertexType& v) {
@@ -264,12 +260,14 @@ void updatePrincipalCurvaturePCA(
         Matrix33<ScalarType> A, eigenvectors;
         PositionType         bp, eigenvalues;
         if (montecarloSampling) {
-            Sphere                     s(v.position(), radius);
-            std::vector<VGridIterator> vec = pGrid.valuesInSphere(s);
-            std::vector<PositionType>  points;
-            points.reserve(vec.size());
-            for (const auto& it : vec) {
-                points.push_back(it->second->position());
+            // buffers reused among the vertices processed by each thread
+            thread_local std::vector<uint>         neighbors;
+            thread_local std::vector<PositionType> points;
+
+            tree.radiusSearch(v.position(), radius, neighbors);
+            points.resize(neighbors.size());
+            for (uint i = 0; i < neighbors.size(); ++i) {
+                points[i] = m.vertex(neighbors[i]).position();
             }
             A = covarianceMatrixOfPointCloud(points);
             A *= area * area / 1000;
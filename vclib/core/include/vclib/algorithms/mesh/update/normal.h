@@ -12,6 +12,11 @@
 #include <vclib/mesh.h>
 #include <vclib/space/core.h>
 
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
 namespace vcl {
 
 namespace detail {
@@ -30,6 +35,85 @@ void normalizeNoThrow(auto& elem, LogType& log = nullLogger)
     }
 }
 
+/*
+ * Returns the (not normalized) normals of the faces of the mesh, indexed by
+ * face index and computed in parallel. The wedge functions use them instead of
+ * computing the normal of a face once for each of its wedges.
+ */
+template<typename NormalType, FaceMeshConcept MeshType>
+std::vector<NormalType> perFaceNormalsVector(const MeshType& mesh)
+{
+    using ScalarType = NormalType::ScalarType;
+
+    std::vector<NormalType> normals(mesh.faceContainerSize());
+    parallelFor(mesh.faces(), [&](const auto& f) {
+        normals[f.index()] = faceNormal(f).template cast<ScalarType>();
+    });
+    return normals;
+}
+
+/*
+ * Sets the normal of each vertex referenced by the faces of the mesh to the sum
+ * of the contributions of its wedges, computed by the given function, that
+ * takes as input a face and the index of the wedge in the face.
+ *
+ * The wedges of each vertex are first collected in a compressed adjacency
+ * array; then the vertices are processed in parallel, each one summing the
+ * contributions of its wedges in the order of the faces. This is the same order
+ * of a serial scatter over the faces, hence the result is identical to the one
+ * of the serial loop and does not depend on the number of threads.
+ *
+ * The normals of the vertices that are not referenced by any face are left
+ * unchanged.
+ */
+template<FaceMeshConcept MeshType, typename WedgeFunction>
+void setPerVertexNormalsFromWedges(MeshType& mesh, WedgeFunction&& wedgeNormal)
+{
+    using NormalType = MeshType::VertexType::NormalType;
+
+    const uint nv = mesh.vertexContainerSize();
+
+    // number of wedges of each vertex, transformed in the offsets of the
+    // wedges of each vertex by the prefix sum
+    std::vector<uint> offsets(nv + 1, 0);
+    parallelFor(mesh.faces(), [&](const auto& f) {
+        for (uint i = 0; i < f.vertexCount(); ++i) {
+            std::atomic_ref<uint>(offsets[f.vertexIndex(i) + 1])
+                .fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+    // wedges of each vertex, stored as (face index << 32 | index in the face),
+    // in a non deterministic order that is fixed later by sorting
+    std::vector<std::uint64_t> wedges(offsets.back());
+    std::vector<uint>          next(offsets.begin(), offsets.end() - 1);
+    parallelFor(mesh.faces(), [&](const auto& f) {
+        for (uint i = 0; i < f.vertexCount(); ++i) {
+            uint k = std::atomic_ref<uint>(next[f.vertexIndex(i)])
+                         .fetch_add(1, std::memory_order_relaxed);
+            wedges[k] = (std::uint64_t(f.index()) << 32) | i;
+        }
+    });
+
+    parallelForBlocks(nv, 4096, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t vi = begin; vi < end; ++vi) {
+            auto first = wedges.begin() + offsets[vi];
+            auto last  = wedges.begin() + offsets[vi + 1];
+            if (first == last)
+                continue;
+
+            std::sort(first, last);
+
+            NormalType n(0, 0, 0);
+            for (auto it = first; it != last; ++it) {
+                n += wedgeNormal(mesh.face(*it >> 32), uint(*it & 0xFFFFFFFF));
+            }
+            mesh.vertex(vi).normal() = n;
+        }
+    });
+}
+
 } // namespace detail
 
 /**
@@ -270,13 +354,16 @@ void normalizePerReferencedVertexNormals(
 {
     requirePerVertexNormal(mesh);
 
+    // referenced[i] is 1 if the i-th vertex is referenced by some element
+    std::vector<char> referenced(mesh.vertexContainerSize(), 0);
+
     // function that is called for each container Cont
     auto f = [&]<mesh::ElementContainerConcept Cont>() {
         using Elem = typename Cont::ElementType; // the Element type of Cont
         if constexpr (comp::HasVertexReferences<Elem>) { // if Elem has vertices
-            for (auto& e : mesh.template elements<Elem::ELEMENT_ID>()) {
-                for (auto* v : e.vertices()) {
-                    detail::normalizeNoThrow<ElemId::VERTEX>(*v, log);
+            for (const auto& e : mesh.template elements<Elem::ELEMENT_ID>()) {
+                for (uint i = 0; i < e.vertexCount(); ++i) {
+                    referenced[e.vertexIndex(i)] = 1;
                 }
             }
         }
@@ -287,6 +374,12 @@ void normalizePerReferencedVertexNormals(
     // apply the function f to all the containers of the mesh
     ForEachType<typename MeshType::Containers>::apply(f);
 
+    // each referenced vertex is normalized exactly once
+    parallelFor(mesh.vertices(), [&](auto& v) {
+        if (referenced[v.index()])
+            detail::normalizeNoThrow<ElemId::VERTEX>(v, log);
+    });
+
     log.log(100, "Per-Vertex normals normalized.");
 }
 
@@ -404,22 +497,21 @@ void updatePerVertexNormals(
     bool                  normalize = true,
     LogType&              log       = nullLogger)
 {
+    requirePerVertexNormal(mesh);
+
     using VertexType = RemoveRef<decltype(mesh)>::VertexType;
-    using NScalar    = VertexType::NormalType::ScalarType;
+    using NormalType = VertexType::NormalType;
 
     log.log(0, "Updating per-Vertex normals...");
 
-    log.startNewTask(0, 20, "Clearing per-Vertex normals...");
-    clearPerReferencedVertexNormals(mesh, log);
-    log.endTask("Clearing per-Vertex normals...");
-
-    log.log(20, "Updating per-Vertex normals...");
+    // the normals of the referenced vertices are overwritten by the sum of the
+    // normals of their faces: there is no need to clear them first
+    const std::vector<NormalType> faceNormals =
+        detail::perFaceNormalsVector<NormalType>(mesh);
 
-    for (auto& f : mesh.faces()) {
-        for (auto* v : f.vertices()) {
-            v->normal() += faceNormal(f).template cast<NScalar>();
-        }
-    }
+    detail::setPerVertexNormalsFromWedges(mesh, [&](const auto& f, uint) {
+        return faceNormals[f.index()];
+    });
 
     if (normalize) {
         log.startNewTask(80, 100, "Normalizing per-Vertex normals...");
@@ -453,6 +545,7 @@ void updatePerVertexNormalsFromFaceNormals(
     bool                  normalize = true,
     LogType&              log       = nullLogger)
 {
+    requirePerVertexNormal(mesh);
     requirePerFaceNormal(mesh);
 
     using VertexType = RemoveRef<decltype(mesh)>::VertexType;
@@ -460,17 +553,11 @@ void updatePerVertexNormalsFromFaceNormals(
 
     log.log(0, "Updating per-Vertex normals...");
 
-    log.startNewTask(0, 20, "Clearing per-Vertex normals...");
-    clearPerReferencedVertexNormals(mesh, log);
-    log.endTask("Clearing per-Vertex normals...");
-
-    log.log(20, "Updating per-Vertex normals...");
-
-    for (auto& f : mesh.faces()) {
-        for (auto* v : f.vertices()) {
-            v->normal() += f.normal().template cast<ScalarType>();
-        }
-    }
+    // the normals of the referenced vertices are overwritten: there is no need
+    // to clear them first
+    detail::setPerVertexNormalsFromWedges(mesh, [](const auto& f, uint) {
+        return f.normal().template cast<ScalarType>();
+    });
 
     if (normalize) {
         log.startNewTask(80, 100, "Normalizing per-Vertex normals...");
@@ -559,34 +646,33 @@ void updatePerVertexNormalsAngleWeighted(
     bool                  normalize = true,
     LogType&              log       = nullLogger)
 {
+    requirePerVertexNormal(mesh);
+
     using VertexType  = RemoveRef<decltype(mesh)>::VertexType;
     using NormalType  = VertexType::NormalType;
     using NScalarType = NormalType::ScalarType;
 
     log.log(0, "Updating per-Vertex normals...");
 
-    log.startNewTask(0, 5, "Clearing per-Vertex normals...");
-    clearPerReferencedVertexNormals(mesh, log);
-    log.endTask("Clearing per-Vertex normals...");
+    // the normals of the referenced vertices are overwritten: there is no need
+    // to clear them first
+    const std::vector<NormalType> faceNormals =
+        detail::perFaceNormalsVector<NormalType>(mesh);
 
-    log.log(5, "Updating per-Vertex normals...");
+    detail::setPerVertexNormalsFromWedges(mesh, [&](const auto& f, uint i) {
+        const NormalType& n = faceNormals[f.index()];
 
-    for (auto& f : mesh.faces()) {
-        auto n = faceNormal(f).template cast<NScalarType>();
+        NormalType vec1 =
+            (f.vertexMod(i - 1)->position() - f.vertexMod(i)->position())
+                .normalized()
+                .template cast<NScalarType>();
+        NormalType vec2 =
+            (f.vertexMod(i + 1)->position() - f.vertexMod(i)->position())
+                .normalized()
+                .template cast<NScalarType>();
 
-        for (uint i = 0; i < f.vertexCount(); ++i) {
-            NormalType vec1 =
-                (f.vertexMod(i - 1)->position() - f.vertexMod(i)->position())
-                    .normalized()
-                    .template cast<NScalarType>();
-            NormalType vec2 =
-                (f.vertexMod(i + 1)->position() - f.vertexMod(i)->position())
-                    .normalized()
-                    .template cast<NScalarType>();
-
-            f.vertex(i)->normal() += n * vec1.angle(vec2);
-        }
-    }
+        return NormalType(n * vec1.angle(vec2));
+    });
 
     if (normalize) {
         log.startNewTask(95, 100, "Normalizing per-Vertex normals...");
@@ -633,31 +719,31 @@ void updatePerVertexNormalsNelsonMaxWeighted(
     bool                  normalize = true,
     LogType&              log       = nullLogger)
 {
+    requirePerVertexNormal(mesh);
+
     using VertexType  = RemoveRef<decltype(mesh)>::VertexType;
-    using NScalarType = VertexType::NormalType::ScalarType;
+    using NormalType  = VertexType::NormalType;
+    using NScalarType = NormalType::ScalarType;
 
     log.log(0, "Updating per-Vertex normals...");
 
-    log.startNewTask(0, 5, "Clearing per-Vertex normals...");
-    clearPerReferencedVertexNormals(mesh, log);
-    log.endTask("Clearing per-Vertex normals...");
+    // the normals of the referenced vertices are overwritten: there is no need
+    // to clear them first
+    const std::vector<NormalType> faceNormals =
+        detail::perFaceNormalsVector<NormalType>(mesh);
 
-    log.log(5, "Updating per-Vertex normals...");
+    detail::setPerVertexNormalsFromWedges(mesh, [&](const auto& f, uint i) {
+        const NormalType& n = faceNormals[f.index()];
 
-    for (auto& f : mesh.faces()) {
-        auto n = faceNormal(f).template cast<NScalarType>();
+        NScalarType e1 =
+            (f.vertexMod(i - 1)->position() - f.vertexMod(i)->position())
+                .squaredNorm();
+        NScalarType e2 =
+            (f.vertexMod(i + 1)->position() - f.vertexMod(i)->position())
+                .squaredNorm();
 
-        for (uint i = 0; i < f.vertexCount(); ++i) {
-            NScalarType e1 =
-                (f.vertexMod(i - 1)->position() - f.vertexMod(i)->position())
-                    .squaredNorm();
-            NScalarType e2 =
-                (f.vertexMod(i + 1)->position() - f.vertexMod(i)->position())
-                    .squaredNorm();
-
-            f.vertex(i)->normal() += n / (e1 * e2);
-        }
-    }
+        return NormalType(n / (e1 * e2));
+    });
 
     if (normalize) {
         log.startNewTask(95, 100, "Normalizing per-Vertex normals...");
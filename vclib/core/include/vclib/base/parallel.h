@@ -12,6 +12,8 @@
 #include <vclib/base/concepts/range.h>
 
 #include <algorithm>
+#include <numeric>
+#include <vector>
 
 namespace vcl {
 
@@ -117,6 +119,97 @@ void parallelFor(Rng&& r, Lambda&& F)
     parallelFor(std::ranges::begin(r), std::ranges::end(r), F);
 }
 
+/**
+ * @brief This function executes a parallel for (with std::execution::par
+ * policy) over the integer interval [0, n), split in contiguous blocks of at
+ * most `blockSize` indices.
+ *
+ * The lambda is called once per block, with the first index and the
+ * past-the-end index of the block. The subdivision in blocks depends only on
+ * `n` and `blockSize`, and not on the number of available threads: the index of
+ * the block can be computed as `begin / blockSize`, and can be used to store
+ * per-block partial results that are then combined in a deterministic order.
+ *
+ * Example of usage, filling a vector in parallel:
+ *
+ * @code{.cpp}
+ * std::vector<double> vec(n);
+ * vcl::parallelForBlocks(n, 4096, [&](std::size_t begin, std::size_t end) {
+ *     for (std::size_t i = begin; i < end; ++i)
+ *         vec[i] = std::sqrt(i);
+ * });
+ * @endcode
+ *
+ * @param[in] n: number of indices to iterate
+ * @param[in] blockSize: maximum number of indices of each block
+ * @param[in] F: lambda function that takes as input the first and the
+ * past-the-end index of a block
+ */
+template<typename Lambda>
+void parallelForBlocks(std::size_t n, std::size_t blockSize, Lambda&& F)
+{
+    if (n == 0)
+        return;
+
+    blockSize = std::max<std::size_t>(blockSize, 1);
+
+    std::vector<std::size_t> blocks((n + blockSize - 1) / blockSize);
+    std::iota(blocks.begin(), blocks.end(), 0);
+
+    std::for_each(
+        std::execution::par, blocks.begin(), blocks.end(), [&](std::size_t b) {
+            std::size_t begin = b * blockSize;
+            F(begin, std::min(begin + blockSize, n));
+        });
+}
+
+/**
+ * @brief Computes in parallel, and in place, the exclusive prefix sum of the
+ * values of the given random access range: each value is replaced by the sum of
+ * the values that precede it.
+ *
+ * The range is split in contiguous blocks of at most `blockSize` values: the
+ * sum of each block is computed in parallel, the sums of the blocks are
+ * scanned serially, and then each block is scanned in parallel starting from
+ * the sum of the previous blocks.
+ *
+ * Example of usage, computing the offsets of variable sized lists:
+ *
+ * @code{.cpp}
+ * std::vector<uint> offsets = sizes;
+ * uint total = vcl::parallelExclusiveScan(offsets);
+ * // offsets[i] is the first position of the list i, total the sum of sizes
+ * @endcode
+ *
+ * @param[in, out] r: the random access range to scan.
+ * @param[in] blockSize: maximum number of values of each block.
+ * @return The sum of all the values of the range.
+ */
+template<std::ranges::random_access_range Rng>
+auto parallelExclusiveScan(Rng&& r, std::size_t blockSize = 65536)
+{
+    using T = std::ranges::range_value_t<Rng>;
+
+    auto              first = std::ranges::begin(r);
+    const std::size_t n     = std::ranges::size(r);
+
+    blockSize = std::max<std::size_t>(blockSize, 1);
+
+    // sums[b + 1] is the sum of the values of the block b
+    std::vector<T> sums((n + blockSize - 1) / blockSize + 1, T(0));
+    parallelForBlocks(n, blockSize, [&](std::size_t begin, std::size_t end) {
+        sums[begin / blockSize + 1] =
+            std::accumulate(first + begin, first + end, T(0));
+    });
+    std::inclusive_scan(sums.begin(), sums.end(), sums.begin());
+
+    parallelForBlocks(n, blockSize, [&](std::size_t begin, std::size_t end) {
+        std::exclusive_scan(
+            first + begin, first + end, first + begin, sums[begin / blockSize]);
+    });
+    return sums.back();
+}
+
 } // namespace vcl
 
 #endif // VCL_BASE_PARALLEL_H
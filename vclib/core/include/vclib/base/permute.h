@@ -32,13 +32,14 @@ namespace vcl {
  * than the new size of vec after the compactness. The new size of vec will be
  * the number of non-null elements of newIndices.
  *
+ * @tparam Vector: a random access container that can be resized (e.g. a
+ * std::vector).
+ *
  * @param vec
  * @param newIndices
  */
-template<typename T, typename... Args>
-void compactVector(
-    std::vector<T, Args...>& vec,
-    const std::vector<uint>& newIndices)
+template<typename Vector>
+void compactVector(Vector& vec, const std::vector<uint>& newIndices)
 {
     assert(vec.size() == newIndices.size());
     uint newSize = 0;
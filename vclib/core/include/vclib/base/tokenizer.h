@@ -11,6 +11,7 @@
 #include <vclib/base/base.h>
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace vcl {
@@ -100,6 +101,95 @@ private:
     }
 };
 
+/**
+ * @brief The StringViewTokenizer class splits a string in tokens like the
+ * Tokenizer class, but without allocating a new string for each token: tokens
+ * are views on the original string, that must outlive the tokens.
+ *
+ * The same StringViewTokenizer object can be used to split several strings by
+ * calling the split() member function: the memory used to store the tokens is
+ * reused, and no allocation is performed after the first lines.
+ */
+class StringViewTokenizer
+{
+    std::vector<char> mSeparators = {' ', '\t'};
+
+    std::vector<std::string_view> mSplitted;
+
+public:
+    using iterator = std::vector<std::string_view>::const_iterator;
+
+    StringViewTokenizer() = default;
+
+    StringViewTokenizer(char separator) : mSeparators({separator}) {}
+
+    StringViewTokenizer(const std::vector<char>& separators) :
+            mSeparators(separators)
+    {
+    }
+
+    StringViewTokenizer(
+        std::string_view string,
+        char             separator,
+        bool             jumpEmptyTokens = true) : mSeparators({separator})
+    {
+        split(string, jumpEmptyTokens);
+    }
+
+    StringViewTokenizer(
+        std::string_view         string,
+        const std::vector<char>& separators,
+        bool                     jumpEmptyTokens = true) :
+            mSeparators(separators)
+    {
+        split(string, jumpEmptyTokens);
+    }
+
+    iterator begin() const { return mSplitted.begin(); }
+
+    iterator end() const { return mSplitted.end(); }
+
+    unsigned long int size() const { return (unsigned long) mSplitted.size(); }
+
+    std::string_view operator[](uint i) const { return mSplitted[i]; }
+
+    /**
+     * @brief Splits the given string using the separators of the tokenizer,
+     * replacing the tokens of the previous split.
+     *
+     * @param[in] str: the string to split.
+     * @param[in] jumpEmptyTokens: if true, empty tokens (e.g. between two
+     * consecutive separators) are not stored.
+     */
+    void split(std::string_view str, bool jumpEmptyTokens = true)
+    {
+        mSplitted.clear();
+        if (str.empty())
+            return;
+
+        std::size_t begin = 0;
+        for (std::size_t i = 0; i <= str.size(); ++i) {
+            if (i == str.size() || isSeparator(str[i])) {
+                if (begin != i)
+                    mSplitted.push_back(str.substr(begin, i - begin));
+                else if (!jumpEmptyTokens)
+                    mSplitted.push_back(std::string_view());
+                begin = i + 1;
+            }
+        }
+    }
+
+private:
+    bool isSeparator(char c) const
+    {
+        for (char s : mSeparators) {
+            if (c == s)
+                return true;
+        }
+        return false;
+    }
+};
+
 } // namespace vcl
 
 #endif // VCL_BASE_TOKENIZER_H
@@ -13,6 +13,7 @@
 #include "io/file_info.h"
 #include "io/file_type.h"
 #include "io/image.h"
+#include "io/memory_mapped_file.h"
 #include "io/mesh.h"
 
 /**
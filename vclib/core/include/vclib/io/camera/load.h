@@ -12,7 +12,7 @@
 #include "gltf/load.h"
 #endif
 
-#include <vclib/io/file_format.h>
+#include <vclib/io/file_info.h>
 
 #ifdef VCLIB_WITH_TINYGLTF
 #include <vclib/io/mesh/gltf/capability.h>
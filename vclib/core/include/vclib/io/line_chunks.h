@@ -0,0 +1,206 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_IO_LINE_CHUNKS_H
+#define VCL_IO_LINE_CHUNKS_H
+
+#include <vclib/io/exceptions.h>
+
+#include <vclib/base.h>
+
+#include <algorithm>
+#include <exception>
+#include <string_view>
+#include <vector>
+
+namespace vcl::detail {
+
+/**
+ * @brief The LineChunk struct represents a portion of a txt buffer that
+ * contains only complete lines.
+ *
+ * The lineCount and firstLine members are filled by the countLines function,
+ * and store respectively the number of non-empty lines of the chunk and the
+ * index of the first of these lines among the non-empty lines of the buffer.
+ */
+struct LineChunk
+{
+    const char* begin     = nullptr;
+    const char* end       = nullptr;
+    uint        lineCount = 0;
+    uint        firstLine = 0;
+};
+
+/**
+ * @brief Splits the buffer [begin, end) in chunks of approximately chunkSize
+ * bytes, each one ending at the end of a line.
+ */
+inline std::vector<LineChunk> splitInLineChunks(
+    const char* begin,
+    const char* end,
+    std::size_t chunkSize)
+{
+    std::vector<LineChunk> chunks;
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    while (begin < end) {
+        const char* last =
+            begin + std::min<std::size_t>(chunkSize, end - begin);
+        if (last < end) {
+            last = std::find(last - 1, end, '\n');
+            last = last == end ? end : last + 1;
+        }
+        chunks.push_back({begin, last});
+        begin = last;
+    }
+    return chunks;
+}
+
+/**
+ * @brief Returns the line starting at pos, without the new line characters,
+ * and moves pos at the beginning of the next line.
+ */
+inline std::string_view nextLine(const char*& pos, const char* end)
+{
+    const char*      nl = std::find(pos, end, '\n');
+    std::string_view line(pos, nl - pos);
+    pos = nl == end ? end : nl + 1;
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    return line;
+}
+
+/**
+ * @brief Returns true if the line contains at least a token, that is a
+ * character that is not a space or a tab. If skipComments is true, lines
+ * starting with '#' are considered empty.
+ *
+ * These are the lines that are not skipped by the
+ * readAndTokenizeNextNonEmptyLine and readAndTokenizeNextNonCommentLine
+ * functions.
+ */
+inline bool isNonEmptyLine(std::string_view line, bool skipComments = false)
+{
+    if (line.empty() || (skipComments && line[0] == '#'))
+        return false;
+    return line.find_first_not_of(" \t") != std::string_view::npos;
+}
+
+/**
+ * @brief Calls the function f(chunk, c) for each chunk, in parallel, where c
+ * is the index of the chunk.
+ *
+ * Exceptions thrown by f are caught and, once all the chunks have been
+ * processed, the exception thrown by the first chunk (in buffer order) is
+ * rethrown.
+ */
+template<typename Lambda>
+void parallelForLineChunks(std::vector<LineChunk>& chunks, Lambda&& f)
+{
+    std::vector<std::exception_ptr> errors(chunks.size());
+    parallelForBlocks(chunks.size(), 1, [&](std::size_t c, std::size_t) {
+        try {
+            f(chunks[c], uint(c));
+        }
+        catch (...) {
+            errors[c] = std::current_exception();
+        }
+    });
+    for (const std::exception_ptr& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
+/**
+ * @brief Counts, in parallel, the non-empty lines of each chunk (see
+ * isNonEmptyLine), and stores in each chunk the number of its non-empty lines
+ * and the index of its first non-empty line.
+ *
+ * @return the total number of non-empty lines.
+ */
+inline uint countLines(std::vector<LineChunk>& chunks, bool skipComments)
+{
+    parallelForLineChunks(chunks, [&](LineChunk& c, uint) {
+        c.lineCount = 0;
+        for (const char* pos = c.begin; pos < c.end;) {
+            if (isNonEmptyLine(nextLine(pos, c.end), skipComments))
+                ++c.lineCount;
+        }
+    });
+    uint n = 0;
+    for (LineChunk& c : chunks) {
+        c.firstLine = n;
+        n += c.lineCount;
+    }
+    return n;
+}
+
+/**
+ * @brief Splits the buffer [begin, end) in line chunks of approximately
+ * chunkSize bytes, and keeps only the chunks that contain the first n non-empty
+ * lines of the buffer. The last chunk is shortened to end right after the n-th
+ * non-empty line.
+ *
+ * @throws MalformedFileException if the buffer contains less than n non-empty
+ * lines.
+ *
+ * @return the chunks containing the first n non-empty lines of the buffer.
+ */
+inline std::vector<LineChunk> lineChunks(
+    const char* begin,
+    const char* end,
+    uint        n,
+    std::size_t chunkSize,
+    bool        skipComments = false)
+{
+    std::vector<LineChunk> chunks = splitInLineChunks(begin, end, chunkSize);
+    if (countLines(chunks, skipComments) < n)
+        throw MalformedFileException("Unexpected end of file.");
+
+    if (n == 0) {
+        chunks.clear();
+        return chunks;
+    }
+
+    uint c = 0;
+    while (chunks[c].firstLine + chunks[c].lineCount < n)
+        ++c;
+    chunks.resize(c + 1);
+
+    // shorten the last chunk after its last needed line
+    LineChunk&  last = chunks.back();
+    const char* pos  = last.begin;
+    for (uint l = last.firstLine; l < n;) {
+        if (isNonEmptyLine(nextLine(pos, last.end), skipComments))
+            ++l;
+    }
+    last.end       = pos;
+    last.lineCount = n - last.firstLine;
+    return chunks;
+}
+
+/**
+ * @brief Calls the function f(line, i) for each non-empty line of the chunk,
+ * where i is the index of the line among the non-empty lines of the buffer.
+ */
+template<typename Lambda>
+void forEachNonEmptyLine(
+    const LineChunk& chunk,
+    Lambda&&         f,
+    bool             skipComments = false)
+{
+    uint i = chunk.firstLine;
+    for (const char* pos = chunk.begin; pos < chunk.end;) {
+        std::string_view line = nextLine(pos, chunk.end);
+        if (isNonEmptyLine(line, skipComments))
+            f(line, i++);
+    }
+}
+
+} // namespace vcl::detail
+
+#endif // VCL_IO_LINE_CHUNKS_H
@@ -0,0 +1,220 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_IO_MEMORY_MAPPED_FILE_H
+#define VCL_IO_MEMORY_MAPPED_FILE_H
+
+#include <vclib/io/exceptions.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vcl {
+
+/**
+ * @brief The MemoryMappedFile class maps the whole content of a file in
+ * read-only memory.
+ *
+ * The content of the file can be accessed through the data() member function
+ * as a contiguous array of size() bytes, without copying it in a user buffer.
+ * The pages of the file are loaded lazily by the operating system when they
+ * are accessed, and the mapping is released when the object is destroyed.
+ *
+ * Example of usage:
+ *
+ * @code{.cpp}
+ * vcl::MemoryMappedFile file("mesh.ply");
+ * const char* data = file.data();
+ * for (std::size_t i = 0; i < file.size(); ++i) {
+ *     // read data[i]
+ * }
+ * @endcode
+ *
+ * @ingroup io
+ */
+class MemoryMappedFile
+{
+    const char* mData = nullptr;
+    std::size_t mSize = 0;
+
+#ifdef _WIN32
+    HANDLE mFile    = INVALID_HANDLE_VALUE;
+    HANDLE mMapping = nullptr;
+#endif
+
+public:
+    /**
+     * @brief Creates an empty MemoryMappedFile, that does not map any file.
+     */
+    MemoryMappedFile() = default;
+
+    /**
+     * @brief Maps the file having the given filename.
+     *
+     * @throws CannotOpenFileException if the file cannot be opened or mapped.
+     *
+     * @param[in] filename: the name of the file to map.
+     */
+    MemoryMappedFile(const std::string& filename) { open(filename); }
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+
+    MemoryMappedFile(MemoryMappedFile&& other) noexcept { swap(other); }
+
+    ~MemoryMappedFile() { close(); }
+
+    /**
+     * @brief Maps the file having the given filename. If the object was
+     * already mapping a file, the previous mapping is released.
+     *
+     * @throws CannotOpenFileException if the file cannot be opened or mapped.
+     *
+     * @param[in] filename: the name of the file to map.
+     */
+    void open(const std::string& filename)
+    {
+        close();
+#ifdef _WIN32
+        mFile = CreateFileA(
+            filename.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (mFile == INVALID_HANDLE_VALUE)
+            throw CannotOpenFileException(filename);
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFile, &size)) {
+            close();
+            throw CannotOpenFileException(filename);
+        }
+        mSize = static_cast<std::size_t>(size.QuadPart);
+
+        if (mSize > 0) {
+            mMapping = CreateFileMappingA(
+                mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mMapping == nullptr) {
+                close();
+                throw CannotOpenFileException(filename);
+            }
+            mData = static_cast<const char*>(
+                MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+            if (mData == nullptr) {
+                close();
+                throw CannotOpenFileException(filename);
+            }
+        }
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw CannotOpenFileException(filename);
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw CannotOpenFileException(filename);
+        }
+        mSize = static_cast<std::size_t>(st.st_size);
+
+        if (mSize > 0) {
+            void* ptr = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr == MAP_FAILED) {
+                ::close(fd);
+                mSize = 0;
+                throw CannotOpenFileException(filename);
+            }
+            // the file is read sequentially by the loaders
+            madvise(ptr, mSize, MADV_SEQUENTIAL);
+            mData = static_cast<const char*>(ptr);
+        }
+        // the mapping is still valid after closing the file descriptor
+        ::close(fd);
+#endif
+    }
+
+    /**
+     * @brief Releases the mapping of the file, if any.
+     */
+    void close()
+    {
+#ifdef _WIN32
+        if (mData)
+            UnmapViewOfFile(mData);
+        if (mMapping)
+            CloseHandle(mMapping);
+        if (mFile != INVALID_HANDLE_VALUE)
+            CloseHandle(mFile);
+        mMapping = nullptr;
+        mFile    = INVALID_HANDLE_VALUE;
+#else
+        if (mData)
+            munmap(const_cast<char*>(mData), mSize);
+#endif
+        mData = nullptr;
+        mSize = 0;
+    }
+
+    /**
+     * @brief Returns true if the object is currently mapping a non empty file.
+     * @return true if the object is currently mapping a non empty file.
+     */
+    bool isOpen() const { return mData != nullptr; }
+
+    /**
+     * @brief Returns a pointer to the first byte of the mapped file.
+     * @return a pointer to the first byte of the mapped file.
+     */
+    const char* data() const { return mData; }
+
+    /**
+     * @brief Returns the size in bytes of the mapped file.
+     * @return the size in bytes of the mapped file.
+     */
+    std::size_t size() const { return mSize; }
+
+    void swap(MemoryMappedFile& other) noexcept
+    {
+        using std::swap;
+        swap(mData, other.mData);
+        swap(mSize, other.mSize);
+#ifdef _WIN32
+        swap(mFile, other.mFile);
+        swap(mMapping, other.mMapping);
+#endif
+    }
+
+    MemoryMappedFile& operator=(MemoryMappedFile other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    friend void swap(MemoryMappedFile& a, MemoryMappedFile& b) noexcept
+    {
+        a.swap(b);
+    }
+};
+
+} // namespace vcl
+
+#endif // VCL_IO_MEMORY_MAPPED_FILE_H
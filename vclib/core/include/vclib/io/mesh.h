@@ -9,8 +9,11 @@
 #define VCL_IO_MESH_H
 
 #include "mesh/capability.h"
+#include "mesh/face_block.h"
 #include "mesh/load_mesh.h"
+#include "mesh/load_mesh_blocks.h"
 #include "mesh/load_meshes.h"
+#include "mesh/mesh_block_writer.h"
 #include "mesh/save_mesh.h"
 #include "mesh/save_meshes.h"
 
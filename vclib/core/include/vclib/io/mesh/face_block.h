@@ -0,0 +1,77 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_IO_MESH_FACE_BLOCK_H
+#define VCL_IO_MESH_FACE_BLOCK_H
+
+#include <vclib/space/core.h>
+
+#include <vector>
+
+namespace vcl {
+
+/**
+ * @brief The FaceBlock struct stores a block of consecutive faces of a mesh
+ * file, in flat arrays.
+ *
+ * It is the unit in which faces are read by the loadMeshBlocks function and
+ * written by the MeshBlockWriter class. The vertex indices of the faces are
+ * global, i.e. they refer to the vertices of the whole file, and not to the
+ * vertices of a single block.
+ *
+ * The vertex indices of the i-th face of the block are stored in the
+ * vertexIndices array, after the indices of the previous faces of the block:
+ *
+ * @code{.cpp}
+ * uint k = 0;
+ * for (uint i = 0; i < block.size(); ++i) {
+ *     for (uint j = 0; j < block.sizes[i]; ++j) {
+ *         uint vi = block.vertexIndices[k++];
+ *         // vi is the index of the j-th vertex of the face
+ *     }
+ * }
+ * @endcode
+ *
+ * The colors array is empty if the faces of the block have no color; otherwise
+ * it stores a color for each face of the block.
+ *
+ * @ingroup io_mesh
+ */
+struct FaceBlock
+{
+    // index of the first face of the block in the file
+    uint firstFace = 0;
+
+    std::vector<uint>  sizes;
+    std::vector<uint>  vertexIndices;
+    std::vector<Color> colors;
+
+    /**
+     * @brief Returns the number of faces in the block.
+     * @return the number of faces in the block.
+     */
+    uint size() const { return sizes.size(); }
+
+    bool empty() const { return sizes.empty(); }
+
+    bool hasColors() const { return !colors.empty(); }
+
+    /**
+     * @brief Removes all the faces from the block, without releasing the
+     * allocated memory, that is reused by the next block.
+     */
+    void clear()
+    {
+        sizes.clear();
+        vertexIndices.clear();
+        colors.clear();
+    }
+};
+
+} // namespace vcl
+
+#endif // VCL_IO_MESH_FACE_BLOCK_H
@@ -0,0 +1,587 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_IO_MESH_LOAD_MESH_BLOCKS_H
+#define VCL_IO_MESH_LOAD_MESH_BLOCKS_H
+
+#include "face_block.h"
+#include "off/load.h"
+#include "ply/load.h"
+#include "stl/load.h"
+
+namespace vcl {
+
+// default maximum number of elements passed to the callbacks of loadMeshBlocks
+constexpr uint MESH_BLOCK_SIZE = 1 << 16;
+
+namespace detail {
+
+/**
+ * @brief Prepares the block mesh to store the next block of vertices: the mesh
+ * is cleared (keeping the allocated memory) and, if required by the settings,
+ * the components stored in the file are enabled again (custom components are
+ * removed by the clear).
+ */
+template<MeshConcept MeshType>
+void clearMeshBlock(
+    MeshType&           block,
+    const MeshInfo&     loadedInfo,
+    const LoadSettings& settings)
+{
+    block.clear();
+    if (settings.enableOptionalComponents) {
+        MeshInfo info = loadedInfo;
+        enableOptionalComponentsFromInfo(info, block);
+    }
+}
+
+template<typename Stream>
+void readPlyFaceBlockProperty(
+    Stream&            file,
+    const PlyProperty& p,
+    FaceBlock&         faces,
+    Color&             c,
+    MeshInfo&          loadedInfo,
+    std::endian        end = std::endian::little)
+{
+    if (p.name == ply::vertex_indices) {
+        uint fSize = io::readPrimitiveType<uint>(file, p.listSizeType, end);
+        loadedInfo.updateMeshType(fSize);
+        faces.sizes.push_back(fSize);
+        for (uint i = 0; i < fSize; ++i) {
+            faces.vertexIndices.push_back(
+                io::readPrimitiveType<uint>(file, p.type, end));
+        }
+    }
+    else if (p.name >= ply::red && p.name <= ply::alpha) {
+        c[p.name - ply::red] =
+            io::readPrimitiveType<unsigned char>(file, p.type, end);
+    }
+    // other properties are read and discarded
+    else if (p.list) {
+        uint s = io::readPrimitiveType<uint>(file, p.listSizeType, end);
+        for (uint i = 0; i < s; ++i)
+            io::readPrimitiveType<int>(file, p.type, end);
+    }
+    else {
+        io::readPrimitiveType<int>(file, p.type, end);
+    }
+}
+
+inline void readPlyFaceBlockTxt(
+    std::istream&                 file,
+    const std::list<PlyProperty>& faceProperties,
+    FaceBlock&                    faces,
+    MeshInfo&                     loadedInfo,
+    bool                          hasColor)
+{
+    Color               c;
+    Tokenizer           spaceTokenizer = readAndTokenizeNextNonEmptyLine(file);
+    Tokenizer::iterator token          = spaceTokenizer.begin();
+    for (const PlyProperty& p : faceProperties) {
+        if (token == spaceTokenizer.end()) {
+            throw MalformedFileException("Unexpected end of line.");
+        }
+        readPlyFaceBlockProperty(token, p, faces, c, loadedInfo);
+    }
+    if (hasColor)
+        faces.colors.push_back(c);
+}
+
+inline void readPlyFaceBlockBin(
+    std::istream&                 file,
+    const std::list<PlyProperty>& faceProperties,
+    FaceBlock&                    faces,
+    MeshInfo&                     loadedInfo,
+    bool                          hasColor,
+    std::endian                   end)
+{
+    Color c;
+    for (const PlyProperty& p : faceProperties) {
+        readPlyFaceBlockProperty(file, p, faces, c, loadedInfo, end);
+    }
+    if (hasColor)
+        faces.colors.push_back(c);
+}
+
+template<
+    MeshConcept   MeshType,
+    typename VertexFunction,
+    typename FaceFunction,
+    LoggerConcept LogType>
+void loadPlyBlocks(
+    MeshType&           block,
+    std::istream&       file,
+    const std::string&  filename,
+    VertexFunction&&    vertexFunction,
+    FaceFunction&&      faceFunction,
+    uint                blockSize,
+    MeshInfo&           loadedInfo,
+    const LoadSettings& settings,
+    LogType&            log)
+{
+    PlyHeader header(file, filename);
+    if (header.errorWhileLoading())
+        throw MalformedFileException("Header not valid: " + filename);
+
+    // the loaded info describes the content of the file: faces are passed to
+    // the callback with their vertex indices and colors, regardless of the
+    // components of the block mesh
+    loadedInfo            = header.getInfo();
+    const bool faceColors = loadedInfo.hasPerFaceColor();
+
+    const std::endian end = header.format() == ply::BINARY_BIG_ENDIAN ?
+                                std::endian::big :
+                                std::endian::little;
+
+    FaceBlock faces;
+    for (const PlyElement& el : header) {
+        if (el.type == ply::VERTEX) {
+            log.startProgress("Reading vertices", el.elementCount);
+            for (uint first = 0, n = 0; first < el.elementCount; first += n) {
+                n = std::min(blockSize, el.elementCount - first);
+                clearMeshBlock(block, loadedInfo, settings);
+                block.addVertices(n);
+                for (uint i = 0; i < n; ++i) {
+                    if (header.format() == ply::ASCII) {
+                        readPlyVertexTxt(
+                            file,
+                            block.vertex(i),
+                            block,
+                            header.vertexProperties(),
+                            header.isVcgGenerated());
+                    }
+                    else {
+                        readPlyVertexBin(
+                            file,
+                            block.vertex(i),
+                            block,
+                            header.vertexProperties(),
+                            end,
+                            header.isVcgGenerated());
+                    }
+                }
+                vertexFunction(block, first);
+                log.progress(first + n);
+            }
+            log.endProgress();
+        }
+        else if (el.type == ply::FACE) {
+            log.startProgress("Reading faces", el.elementCount);
+            for (uint first = 0, n = 0; first < el.elementCount; first += n) {
+                n = std::min(blockSize, el.elementCount - first);
+                faces.clear();
+                faces.firstFace = first;
+                for (uint i = 0; i < n; ++i) {
+                    if (header.format() == ply::ASCII) {
+                        readPlyFaceBlockTxt(
+                            file,
+                            header.faceProperties(),
+                            faces,
+                            loadedInfo,
+                            faceColors);
+                    }
+                    else {
+                        readPlyFaceBlockBin(
+                            file,
+                            header.faceProperties(),
+                            faces,
+                            loadedInfo,
+                            faceColors,
+                            end);
+                    }
+                }
+                faceFunction(faces);
+                log.progress(first + n);
+            }
+            log.endProgress();
+        }
+        else {
+            readPlyUnknownElement(file, header, el, log);
+        }
+    }
+}
+
+template<
+    MeshConcept   MeshType,
+    typename VertexFunction,
+    typename FaceFunction,
+    LoggerConcept LogType>
+void loadOffBlocks(
+    MeshType&           block,
+    std::istream&       file,
+    VertexFunction&&    vertexFunction,
+    FaceFunction&&      faceFunction,
+    uint                blockSize,
+    MeshInfo&           loadedInfo,
+    const LoadSettings& settings,
+    LogType&            log)
+{
+    uint     nv, nf, ne;
+    MeshInfo fileInfo; // data that needs to be read from the file
+
+    readOffHeader(file, fileInfo, nv, nf, ne);
+    loadedInfo = fileInfo;
+
+    log.startProgress("Reading vertices", nv);
+    for (uint first = 0, n = 0; first < nv; first += n) {
+        n = std::min(blockSize, nv - first);
+        clearMeshBlock(block, loadedInfo, settings);
+        block.addVertices(n);
+        for (uint i = 0; i < n; ++i) {
+            Tokenizer tokens = readAndTokenizeNextNonCommentLine(file);
+            readOffVertex(block.vertex(i), block, tokens, fileInfo);
+        }
+        vertexFunction(block, first);
+        log.progress(first + n);
+    }
+    log.endProgress();
+
+    FaceBlock faces;
+    log.startProgress("Reading faces", nf);
+    for (uint first = 0, n = 0; first < nf; first += n) {
+        n = std::min(blockSize, nf - first);
+        faces.clear();
+        faces.firstFace = first;
+        for (uint i = 0; i < n; ++i) {
+            Tokenizer tokens          = readAndTokenizeNextNonCommentLine(file);
+            Tokenizer::iterator token = tokens.begin();
+
+            uint fSize = io::readUInt<uint>(token);
+            if (tokens.size() <= fSize) {
+                throw MalformedFileException("Unexpected end of line.");
+            }
+            loadedInfo.updateMeshType(fSize);
+            faces.sizes.push_back(fSize);
+            for (uint j = 0; j < fSize; ++j) {
+                faces.vertexIndices.push_back(io::readUInt<uint>(token));
+            }
+
+            // colors are optional for each face: once a face of the block has
+            // a color, all the faces of the block must have one
+            if (token != tokens.end()) {
+                loadedInfo.setPerFaceColor();
+                faces.colors.resize(faces.size() - 1);
+                faces.colors.push_back(readOffColor(
+                    token, tokens.size() - (token - tokens.begin())));
+            }
+            else if (faces.hasColors()) {
+                faces.colors.push_back(Color());
+            }
+        }
+        faceFunction(faces);
+        log.progress(first + n);
+    }
+    log.endProgress();
+}
+
+template<
+    MeshConcept   MeshType,
+    typename VertexFunction,
+    typename FaceFunction,
+    LoggerConcept LogType>
+void loadStlBlocks(
+    MeshType&           block,
+    std::istream&       file,
+    bool                isBinary,
+    VertexFunction&&    vertexFunction,
+    FaceFunction&&      faceFunction,
+    uint                blockSize,
+    MeshInfo&           loadedInfo,
+    const LoadSettings& settings,
+    LogType&            log)
+{
+    // each triangle of the stl has its own three vertices: a block contains
+    // blockSize / 3 triangles and their vertices
+    const uint nTris = std::max(blockSize / 3, 1u);
+
+    bool magicsMode = false, colored = false;
+    if (isBinary)
+        colored = isStlColored(file, magicsMode);
+
+    loadedInfo.clear();
+    loadedInfo.setVertices();
+    loadedInfo.setPerVertexPosition();
+    if (colored)
+        loadedInfo.setPerFaceColor();
+
+    FaceBlock faces;
+    uint      firstVertex = 0;
+
+    // passes the triangles read so far to the callbacks
+    auto flush = [&]() {
+        if (!faces.empty()) {
+            vertexFunction(block, firstVertex);
+            faceFunction(faces);
+            firstVertex += block.vertexCount();
+            faces.firstFace += faces.size();
+        }
+        clearMeshBlock(block, loadedInfo, settings);
+        faces.clear();
+    };
+
+    auto addTriangle = [&]() {
+        const uint vi = firstVertex + block.vertexCount();
+        block.addVertices(3);
+        faces.sizes.push_back(3);
+        for (uint j = 0; j < 3; ++j)
+            faces.vertexIndices.push_back(vi + j);
+    };
+
+    clearMeshBlock(block, loadedInfo, settings);
+    if (isBinary) {
+        file.seekg(80); // size of the header
+        uint fnum = io::readUInt<uint>(file, std::endian::little);
+        if (fnum > 0) {
+            loadedInfo.setFaces();
+            loadedInfo.setTriangleMesh();
+        }
+
+        log.startProgress("Reading STL triangles", fnum);
+        for (uint i = 0; i < fnum; ++i) {
+            addTriangle();
+
+            // the normal of the triangle is not passed to the callbacks
+            for (uint j = 0; j < 3; ++j)
+                io::readFloat<float>(file, std::endian::little);
+
+            const uint bvi = block.vertexCount() - 3;
+            for (uint j = 0; j < 3; ++j) {
+                for (uint k = 0; k < 3; ++k) {
+                    block.vertex(bvi + j).position()[k] =
+                        io::readFloat<float>(file, std::endian::little);
+                }
+            }
+
+            unsigned short attr =
+                io::readShort<unsigned short>(file, std::endian::little);
+            if (colored) {
+                Color c;
+                if (magicsMode)
+                    c.setBgr5(attr);
+                else
+                    c.setRgb5(attr);
+                faces.colors.push_back(c);
+            }
+
+            if (faces.size() == nTris) {
+                flush();
+                log.progress(i);
+            }
+        }
+    }
+    else {
+        log.startProgress("Reading STL triangles", 0);
+        Tokenizer tokens = readAndTokenizeNextNonEmptyLineNoThrow(file);
+        while (file) {
+            Tokenizer::iterator token = tokens.begin();
+            if (token != tokens.end() && *token == "facet") {
+                addTriangle();
+                readAndTokenizeNextNonEmptyLine(file); // outer loop
+
+                const uint bvi = block.vertexCount() - 3;
+                for (uint j = 0; j < 3; ++j) {
+                    tokens = readAndTokenizeNextNonEmptyLine(file);
+                    token  = tokens.begin();
+                    ++token; // skip the "vertex" word
+                    for (uint k = 0; k < 3; ++k) {
+                        block.vertex(bvi + j).position()[k] =
+                            io::readFloat<float>(token);
+                    }
+                }
+                readAndTokenizeNextNonEmptyLine(file); // endloop
+                readAndTokenizeNextNonEmptyLine(file); // endfacet
+
+                if (faces.size() == nTris)
+                    flush();
+            }
+            tokens = readAndTokenizeNextNonEmptyLineNoThrow(file);
+        }
+        if (faces.firstFace + faces.size() > 0) {
+            loadedInfo.setFaces();
+            loadedInfo.setTriangleMesh();
+        }
+    }
+    flush();
+    log.endProgress();
+}
+
+} // namespace detail
+
+/**
+ * @brief Loads the given mesh file in blocks of bounded size, passing each
+ * block to the given callbacks, without ever storing the whole mesh in memory.
+ *
+ * This function is meant for meshes and point clouds that do not fit in memory:
+ * the peak memory used by the function depends only on the size of the blocks,
+ * and not on the size of the file. Per-vertex filters like transformations or
+ * color mappings can be applied to each block inside the callbacks, and the
+ * result can be written to another file using the MeshBlockWriter class. The
+ * callbacks must not add or remove vertices of the block: the vertex indices of
+ * the faces refer to the vertices of the whole file, and are not remapped.
+ *
+ * The vertices are read in the `block` mesh, that is cleared (without releasing
+ * its memory) before each block of vertices. Once filled, the block is passed
+ * to the vertex callback together with the index, in the file, of its first
+ * vertex:
+ *
+ * @code{.cpp}
+ * void vertexFunction(MeshType& block, uint firstVertex);
+ * @endcode
+ *
+ * The faces are read in a FaceBlock, that stores their vertex indices (that
+ * are the indices of the vertices in the whole file) and, if available, their
+ * colors. Each FaceBlock is passed to the face callback:
+ *
+ * @code{.cpp}
+ * void faceFunction(const FaceBlock& faces);
+ * @endcode
+ *
+ * Blocks are passed to the callbacks in file order. Since STL files store the
+ * three vertices of each triangle together with the triangle, each block of
+ * triangles of an STL file is passed to the face callback right after the block
+ * of its vertices.
+ *
+ * Supported formats are PLY, OFF and STL. Elements of a PLY file other than
+ * vertices and faces are skipped.
+ *
+ * @tparam MeshType The type of the block mesh. It must satisfy the MeshConcept.
+ * @tparam LogType The type of logger to use. It must satisfy the LoggerConcept.
+ *
+ * @param[in, out] block: the mesh used to store each block of vertices.
+ * @param[in] filename: the name of the file to read from.
+ * @param[in] vertexFunction: the function called for each block of vertices.
+ * @param[in] faceFunction: the function called for each block of faces.
+ * @param[in] blockSize: the maximum number of vertices or faces of a block.
+ * @param[out] loadedInfo: the info about what elements and components are
+ * stored in the file (and passed to the callbacks).
+ * @param[in] settings: settings for loading the file. If
+ * enableOptionalComponents is true, the optional components of the block mesh
+ * that can be loaded from the file are enabled.
+ * @param[in] log: the logger to use.
+ *
+ * @throws vcl::UnknownFileFormatException if the file extension is not
+ * supported.
+ *
+ * @ingroup load_mesh
+ */
+template<
+    MeshConcept   MeshType,
+    typename VertexFunction,
+    typename FaceFunction,
+    LoggerConcept LogType = NullLogger>
+void loadMeshBlocks(
+    MeshType&           block,
+    const std::string&  filename,
+    VertexFunction&&    vertexFunction,
+    FaceFunction&&      faceFunction,
+    uint                blockSize,
+    MeshInfo&           loadedInfo,
+    const LoadSettings& settings = LoadSettings(),
+    LogType&            log      = nullLogger)
+{
+    FileFormat ff = FileInfo::fileFormat(filename);
+
+    loadedInfo.clear();
+    blockSize = std::max(blockSize, 1u);
+
+    if (ff == plyFileFormat()) {
+        std::ifstream file = openInputFileStream(filename);
+        detail::loadPlyBlocks(
+            block,
+            file,
+            filename,
+            vertexFunction,
+            faceFunction,
+            blockSize,
+            loadedInfo,
+            settings,
+            log);
+    }
+    else if (ff == offFileFormat()) {
+        std::ifstream file = openInputFileStream(filename);
+        detail::loadOffBlocks(
+            block,
+            file,
+            vertexFunction,
+            faceFunction,
+            blockSize,
+            loadedInfo,
+            settings,
+            log);
+    }
+    else if (ff == stlFileFormat()) {
+        bool        isBinary;
+        std::size_t filesize;
+        if (detail::isBinStlMalformed(filename, isBinary, filesize))
+            throw MalformedFileException(filename + " is malformed.");
+
+        std::ifstream file = openInputFileStream(filename);
+        detail::loadStlBlocks(
+            block,
+            file,
+            isBinary,
+            vertexFunction,
+            faceFunction,
+            blockSize,
+            loadedInfo,
+            settings,
+            log);
+    }
+    else {
+        throw UnknownFileFormatException(ff.extensions().front());
+    }
+}
+
+/**
+ * @brief Loads the given mesh file in blocks of bounded size, passing each
+ * block to the given callbacks, without ever storing the whole mesh in memory.
+ *
+ * See the documentation of the other overload of this function for details.
+ *
+ * @tparam MeshType The type of the block mesh. It must satisfy the MeshConcept.
+ * @tparam LogType The type of logger to use. It must satisfy the LoggerConcept.
+ *
+ * @param[in, out] block: the mesh used to store each block of vertices.
+ * @param[in] filename: the name of the file to read from.
+ * @param[in] vertexFunction: the function called for each block of vertices.
+ * @param[in] faceFunction: the function called for each block of faces.
+ * @param[in] blockSize: the maximum number of vertices or faces of a block.
+ * @param[in] settings: settings for loading the file.
+ * @param[in] log: the logger to use.
+ *
+ * @ingroup load_mesh
+ */
+template<
+    MeshConcept   MeshType,
+    typename VertexFunction,
+    typename FaceFunction,
+    LoggerConcept LogType = NullLogger>
+void loadMeshBlocks(
+    MeshType&           block,
+    const std::string&  filename,
+    VertexFunction&&    vertexFunction,
+    FaceFunction&&      faceFunction,
+    uint                blockSize = MESH_BLOCK_SIZE,
+    const LoadSettings& settings  = LoadSettings(),
+    LogType&            log       = nullLogger)
+{
+    MeshInfo loadedInfo;
+    loadMeshBlocks(
+        block,
+        filename,
+        vertexFunction,
+        faceFunction,
+        blockSize,
+        loadedInfo,
+        settings,
+        log);
+}
+
+} // namespace vcl
+
+#endif // VCL_IO_MESH_LOAD_MESH_BLOCKS_H
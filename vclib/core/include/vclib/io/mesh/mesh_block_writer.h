@@ -0,0 +1,490 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_IO_MESH_MESH_BLOCK_WRITER_H
+#define VCL_IO_MESH_MESH_BLOCK_WRITER_H
+
+#include "face_block.h"
+#include "off/save.h"
+#include "ply/save.h"
+#include "stl/save.h"
+
+#include <vclib/algorithms/core.h>
+#include <vclib/mesh/exceptions.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace vcl {
+
+/**
+ * @brief The MeshBlockWriter class writes a mesh file incrementally, one block
+ * of vertices or faces at a time, without ever storing the whole mesh in
+ * memory.
+ *
+ * It is the counterpart of the loadMeshBlocks function: blocks of vertices are
+ * written from a (small) block mesh, and blocks of faces are written from a
+ * FaceBlock, whose vertex indices refer to the vertices written so far.
+ * Blocks of vertices and faces can be interleaved (as they are when reading an
+ * STL file): in PLY and OFF files, where all the vertices must precede the
+ * faces, the faces are written in a temporary file placed next to the output
+ * file, that is appended to the output file when the writer is closed.
+ *
+ * The components written in the file are the ones given by the MeshInfo passed
+ * to the constructor: the block meshes must have the vertex components listed
+ * in it. Faces are written with their vertex indices and, if the MeshInfo has
+ * per face colors, with their colors.
+ *
+ * Supported formats are PLY, OFF and STL. The number of vertices and faces is
+ * not known when the header of a PLY or OFF file is written: the counts are
+ * written in fixed width fields (padded with zeros) that are filled when the
+ * writer is closed. Since STL files store the positions of the vertices of each
+ * triangle, the STL writer keeps a copy of the positions of the written
+ * vertices (three floats for each vertex); polygonal faces are triangulated.
+ *
+ * Example of usage, that applies a transformation to a mesh that does not fit
+ * in memory:
+ *
+ * @code{.cpp}
+ * vcl::MeshInfo info;
+ * info.setVertices();
+ * info.setPerVertexPosition();
+ * info.setFaces();
+ *
+ * vcl::MeshBlockWriter writer("out.ply", info);
+ * vcl::PointCloud      block;
+ * vcl::loadMeshBlocks(
+ *     block,
+ *     "in.ply",
+ *     [&](vcl::PointCloud& b, uint) {
+ *         vcl::applyTransformMatrix(b, matrix);
+ *         writer.writeVertices(b);
+ *     },
+ *     [&](const vcl::FaceBlock& f) { writer.writeFaces(f); });
+ * writer.close();
+ * @endcode
+ *
+ * @ingroup save_mesh
+ */
+class MeshBlockWriter
+{
+    // number of digits of the element counts written in the headers
+    static constexpr uint COUNT_WIDTH = 10;
+
+    std::ofstream     mFile;
+    std::fstream      mFaceFile; // faces of ply and off files
+    std::string       mFaceFileName;
+    FileFormat        mFormat = plyFileFormat();
+    MeshInfo          mInfo;
+    SaveSettings      mSettings;
+    detail::PlyHeader mPlyHeader;
+
+    // positions in the file of the element counts, filled on close
+    std::streamoff mVertexCountPos = -1;
+    std::streamoff mFaceCountPos   = -1;
+
+    uint mVertexCount = 0;
+    uint mFaceCount   = 0;
+
+    // positions of the written vertices, used only when writing STL files
+    std::vector<Point3f> mPositions;
+
+public:
+    /**
+     * @brief Creates a MeshBlockWriter that is not associated to any file.
+     */
+    MeshBlockWriter() = default;
+
+    /**
+     * @brief Creates a MeshBlockWriter and opens the given file, writing its
+     * header.
+     *
+     * @param[in] filename: the name of the file to write.
+     * @param[in] info: the elements and components to write in the file.
+     * @param[in] settings: the settings for writing the file.
+     *
+     * @throws vcl::UnknownFileFormatException if the file extension is not
+     * supported.
+     * @throws vcl::CannotOpenFileException if the file cannot be opened.
+     */
+    MeshBlockWriter(
+        const std::string&  filename,
+        const MeshInfo&     info,
+        const SaveSettings& settings = SaveSettings())
+    {
+        open(filename, info, settings);
+    }
+
+    MeshBlockWriter(MeshBlockWriter&&) = default;
+
+    MeshBlockWriter& operator=(MeshBlockWriter&& other)
+    {
+        if (this != &other) {
+            close();
+            mFile           = std::move(other.mFile);
+            mFaceFile       = std::move(other.mFaceFile);
+            mFaceFileName   = std::move(other.mFaceFileName);
+            mFormat         = other.mFormat;
+            mInfo           = other.mInfo;
+            mSettings       = other.mSettings;
+            mPlyHeader      = std::move(other.mPlyHeader);
+            mVertexCountPos = other.mVertexCountPos;
+            mFaceCountPos   = other.mFaceCountPos;
+            mVertexCount    = other.mVertexCount;
+            mFaceCount      = other.mFaceCount;
+            mPositions      = std::move(other.mPositions);
+        }
+        return *this;
+    }
+
+    ~MeshBlockWriter() noexcept
+    {
+        // errors while closing the file cannot be reported by the destructor:
+        // call close() explicitly to be notified of them
+        try {
+            close();
+        }
+        catch (...) {
+        }
+    }
+
+    /**
+     * @brief Opens the given file and writes its header. If the writer was
+     * already writing a file, the previous file is closed.
+     *
+     * @param[in] filename: the name of the file to write.
+     * @param[in] info: the elements and components to write in the file.
+     * @param[in] settings: the settings for writing the file.
+     *
+     * @throws vcl::UnknownFileFormatException if the file extension is not
+     * supported.
+     * @throws vcl::CannotOpenFileException if the file cannot be opened.
+     */
+    void open(
+        const std::string&  filename,
+        const MeshInfo&     info,
+        const SaveSettings& settings = SaveSettings())
+    {
+        close();
+
+        mFormat   = FileInfo::fileFormat(filename);
+        mInfo     = info;
+        mSettings = settings;
+
+        mVertexCountPos = -1;
+        mFaceCountPos   = -1;
+        mVertexCount    = 0;
+        mFaceCount      = 0;
+
+        // faces are written only with their vertex indices and colors (note
+        // that removing a component also removes its element from the info)
+        if (info.hasFaces()) {
+            mInfo.setPerFaceBitFlags(false);
+            mInfo.setPerFaceNormal(false);
+            mInfo.setPerFaceQuality(false);
+            mInfo.setPerFaceWedgeTexCoords(false);
+            mInfo.setPerFaceMaterialIndex(false);
+            mInfo.clearPerFaceCustomComponents();
+            mInfo.setFaces();
+            mInfo.setPerFaceVertexReferences();
+        }
+        mInfo.setEdges(false);
+        mInfo.setMaterials(false);
+
+        if (mFormat == plyFileFormat()) {
+            mFile = openOutputFileStream(filename, "ply");
+            writePlyHeader();
+            openFaceFile(filename);
+        }
+        else if (mFormat == offFileFormat()) {
+            mFile = openOutputFileStream(filename, "off");
+            writeOffHeader();
+            openFaceFile(filename);
+        }
+        else if (mFormat == stlFileFormat()) {
+            mFile = openOutputFileStream(filename, "stl");
+            detail::writeStlHeader(mFile, mSettings);
+            if (mSettings.binary) {
+                mFaceCountPos = mFile.tellp();
+                io::writeInt(mFile, 0);
+            }
+        }
+        else {
+            throw UnknownFileFormatException(mFormat.extensions().front());
+        }
+    }
+
+    /**
+     * @brief Returns true if the writer is currently writing a file.
+     * @return true if the writer is currently writing a file.
+     */
+    bool isOpen() const { return mFile.is_open(); }
+
+    /**
+     * @brief Returns the number of vertices written so far.
+     * @return the number of vertices written so far.
+     */
+    uint vertexCount() const { return mVertexCount; }
+
+    /**
+     * @brief Returns the number of faces written so far. For STL files, it is
+     * the number of written triangles.
+     * @return the number of faces written so far.
+     */
+    uint faceCount() const { return mFaceCount; }
+
+    /**
+     * @brief Writes all the (non-deleted) vertices of the given block mesh
+     * after the vertices written so far.
+     *
+     * @param[in] block: the mesh containing the vertices to write.
+     */
+    template<MeshConcept MeshType>
+    void writeVertices(const MeshType& block)
+    {
+        if (mFormat == plyFileFormat()) {
+            detail::writePlyVertices(mFile, mPlyHeader, block);
+        }
+        else if (mFormat == offFileFormat()) {
+            detail::writeOffVertices(mFile, block, mInfo);
+        }
+        else {
+            for (const auto& v : block.vertices()) {
+                mPositions.push_back(v.position().template cast<float>());
+            }
+        }
+        mVertexCount += block.vertexCount();
+    }
+
+    /**
+     * @brief Writes all the faces of the given block after the faces written
+     * so far. The vertex indices of the faces refer to the vertices written
+     * so far.
+     *
+     * @param[in] faces: the block of faces to write.
+     *
+     * @throws vcl::BadVertexIndexException if a face refers to a vertex that
+     * has not been written.
+     */
+    void writeFaces(const FaceBlock& faces)
+    {
+        const uint* vids = faces.vertexIndices.data();
+        for (uint i = 0; i < faces.size(); ++i) {
+            const uint n = faces.sizes[i];
+            for (uint j = 0; j < n; ++j) {
+                if (vids[j] >= mVertexCount) {
+                    throw BadVertexIndexException(
+                        "Bad vertex index for face " +
+                        std::to_string(faces.firstFace + i));
+                }
+            }
+            Color c = faces.hasColors() ? faces.colors[i] : Color();
+
+            if (mFormat == plyFileFormat())
+                writePlyFace(vids, n, c);
+            else if (mFormat == offFileFormat())
+                writeOffFace(vids, n, c);
+            else
+                writeStlFace(vids, n, c);
+
+            vids += n;
+        }
+    }
+
+    /**
+     * @brief Fills the element counts of the header and closes the file. It
+     * is called automatically by the destructor.
+     */
+    void close()
+    {
+        if (!mFile.is_open())
+            return;
+
+        if (mFormat == stlFileFormat()) {
+            if (mSettings.binary) {
+                mFile.seekp(mFaceCountPos);
+                io::writeInt(mFile, mFaceCount);
+            }
+            else {
+                mFile << "endsolid VCLib" << std::endl;
+            }
+        }
+        else {
+            writeCount(mVertexCountPos, mVertexCount);
+            writeCount(mFaceCountPos, mFaceCount);
+
+            // append the faces after the vertices
+            if (mFaceCount > 0) {
+                mFaceFile.seekg(0);
+                mFile << mFaceFile.rdbuf();
+            }
+            mFaceFile.close();
+
+            // a temporary file that cannot be removed is not an error
+            std::error_code ec;
+            std::filesystem::remove(mFaceFileName, ec);
+        }
+        mFile.close();
+
+        mPositions.clear();
+        mPositions.shrink_to_fit();
+    }
+
+private:
+    void openFaceFile(const std::string& filename)
+    {
+        mFaceFileName = filename + ".faces.tmp";
+        mFaceFile.open(
+            mFaceFileName,
+            std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!mFaceFile) {
+            mFile.close();
+            throw CannotOpenFileException(mFaceFileName);
+        }
+        mFaceFile.imbue(std::locale().classic());
+    }
+
+    /**
+     * @brief Replaces the (zero) count of the given element in the header
+     * string with a fixed width field, and returns the position of the field.
+     *
+     * @throws std::logic_error if the header does not declare the element.
+     */
+    static std::size_t reserveCount(std::string& header, const std::string& el)
+    {
+        const std::string key = "element " + el + " 0\n";
+        std::size_t       pos = header.find(key);
+        if (pos == std::string::npos) {
+            throw std::logic_error(
+                "The PLY header does not declare the element " + el + ".");
+        }
+        pos += key.size() - 2;
+        header.replace(pos, 1, std::string(COUNT_WIDTH, '0'));
+        return pos;
+    }
+
+    void writeCount(std::streamoff pos, uint count)
+    {
+        if (pos < 0)
+            return;
+        std::string s = std::to_string(count);
+        s.insert(0, COUNT_WIDTH - s.size(), '0');
+        mFile.seekp(pos);
+        mFile << s;
+        mFile.seekp(0, std::ios::end);
+    }
+
+    void writePlyHeader()
+    {
+        using namespace detail;
+
+        mPlyHeader = PlyHeader(
+            mSettings.binary ? ply::BINARY_LITTLE_ENDIAN : ply::ASCII, mInfo);
+        if (mPlyHeader.hasVertices())
+            mPlyHeader.setVertexCount(0);
+        if (mPlyHeader.hasFaces())
+            mPlyHeader.setFaceCount(0);
+
+        std::string header = mPlyHeader.toString(mSettings);
+        if (mPlyHeader.hasVertices())
+            mVertexCountPos = reserveCount(header, "vertex");
+        if (mPlyHeader.hasFaces())
+            mFaceCountPos = reserveCount(header, "face");
+        mFile << header;
+    }
+
+    void writeOffHeader()
+    {
+        detail::writeOffHeader(mFile, mInfo);
+        mVertexCountPos = mFile.tellp();
+        mFaceCountPos   = mVertexCountPos + COUNT_WIDTH + 1;
+        const std::string zeros(COUNT_WIDTH, '0');
+        mFile << zeros << " " << zeros << " 0" << std::endl;
+    }
+
+    void writePlyFace(const uint* vids, uint n, const Color& c)
+    {
+        using namespace detail;
+
+        FileType format;
+        format.isBinary = mSettings.binary;
+
+        for (const PlyProperty& p : mPlyHeader.faceProperties()) {
+            if (p.name == ply::vertex_indices) {
+                io::writeProperty(mFaceFile, n, p.listSizeType, format);
+                for (uint j = 0; j < n; ++j)
+                    io::writeProperty(mFaceFile, vids[j], p.type, format);
+            }
+            else if (p.name >= ply::red && p.name <= ply::alpha) {
+                io::writeProperty(
+                    mFaceFile, c[p.name - ply::red], p.type, format);
+            }
+            else {
+                io::writeProperty(mFaceFile, 0, p.type, format);
+            }
+        }
+        if (!format.isBinary)
+            mFaceFile << std::endl;
+        ++mFaceCount;
+    }
+
+    void writeOffFace(const uint* vids, uint n, const Color& c)
+    {
+        io::writeInt(mFaceFile, n, false);
+        for (uint j = 0; j < n; ++j)
+            io::writeInt(mFaceFile, vids[j], false);
+        if (mInfo.hasPerFaceColor()) {
+            io::writeInt(mFaceFile, c.red(), false);
+            io::writeInt(mFaceFile, c.green(), false);
+            io::writeInt(mFaceFile, c.blue(), false);
+            io::writeInt(mFaceFile, c.alpha(), false);
+        }
+        mFaceFile << std::endl;
+        ++mFaceCount;
+    }
+
+    void writeStlFace(const uint* vids, uint n, const Color& c)
+    {
+        unsigned short attributes = 0;
+        if (mInfo.hasPerFaceColor()) {
+            if (mSettings.magicsMode)
+                attributes = 32768 | c.bgr5();
+            else
+                attributes = 32768 | c.rgb5();
+        }
+
+        auto writeTriangle = [&](uint i0, uint i1, uint i2) {
+            const Point3f& p0 = mPositions[i0];
+            const Point3f& p1 = mPositions[i1];
+            const Point3f& p2 = mPositions[i2];
+            Point3f        nn = (p1 - p0).cross(p2 - p0).normalized();
+            detail::writeSTLTriangle(
+                mFile, p0, p1, p2, nn, attributes, mSettings);
+            ++mFaceCount;
+        };
+
+        if (n == 3) {
+            writeTriangle(vids[0], vids[1], vids[2]);
+        }
+        else {
+            std::vector<Point3f> polygon(n);
+            for (uint j = 0; j < n; ++j)
+                polygon[j] = mPositions[vids[j]];
+            std::vector<uint> tris = earCut(polygon);
+            for (uint i = 0; i < tris.size(); i += 3) {
+                writeTriangle(
+                    vids[tris[i]], vids[tris[i + 1]], vids[tris[i + 2]]);
+            }
+        }
+    }
+};
+
+} // namespace vcl
+
+#endif // VCL_IO_MESH_MESH_BLOCK_WRITER_H
@@ -12,6 +12,8 @@
 
 #include <vclib/io/file_info.h>
 #include <vclib/io/image/load.h>
+#include <vclib/io/line_chunks.h>
+#include <vclib/io/memory_mapped_file.h>
 #include <vclib/io/mesh/settings.h>
 #include <vclib/io/read.h>
 
@@ -20,6 +22,7 @@
 #include <vclib/space/core.h>
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 
 namespace vcl {
@@ -221,34 +224,29 @@ void readObjVertex(
     }
 }
 
-template<FaceMeshConcept MeshType>
-void readObjFace(
-    MeshType&                     m,
-    MeshInfo&                     loadedInfo,
-    const Tokenizer&              tokens,
-    const std::vector<Point3d>&   normals,
-    const std::vector<TexCoordd>& wedgeTexCoords,
-    const ObjMaterial&            currentMaterial,
-    const LoadSettings&           settings)
+/**
+ * @brief Reads the vertex, texcoord and normal indices of a face line, having
+ * tokens in the form `v/vt/vn`. The indices are appended to the given vectors.
+ *
+ * @param[in] tokens: the tokens of the face line, starting with "f".
+ * @param[in] subt: a tokenizer using '/' as separator, used to split each
+ * token of the line.
+ */
+template<typename Tokens>
+void readObjFaceIndices(
+    const Tokens&        tokens,
+    StringViewTokenizer& subt,
+    std::vector<uint>&   vids,
+    std::vector<uint>&   wids,
+    std::vector<uint>&   nids)
 {
-    using FaceType = MeshType::FaceType;
-
-    std::vector<uint> vids;
-    std::vector<uint> wids;
-    std::vector<uint> nids;
-
-    loadedInfo.updateMeshType(tokens.size() - 1);
-
     // actual read - load vertex indices and texcoords indices, if present
-    Tokenizer::iterator token = tokens.begin();
+    auto token = tokens.begin();
     ++token;
-    vids.resize(tokens.size() - 1);
-    wids.reserve(tokens.size() - 1);
-    nids.reserve(tokens.size() - 1);
     for (uint i = 0; i < tokens.size() - 1; ++i) {
-        Tokenizer subt(*token, '/', false);
-        auto      t = subt.begin();
-        vids[i]     = io::readUInt<uint>(t) - 1;
+        subt.split(*token, false);
+        auto t = subt.begin();
+        vids.push_back(io::readUInt<uint>(t) - 1);
         if (subt.size() > 1) {
             if (!t->empty()) {
                 wids.push_back(io::readUInt<uint>(t) - 1);
@@ -261,6 +259,27 @@ void readObjFace(
         }
         ++token;
     }
+}
+
+/**
+ * @brief Adds to the mesh a face having the given vertex, texcoord and normal
+ * indices, read from a face line.
+ */
+template<FaceMeshConcept MeshType>
+void addObjFace(
+    MeshType&                     m,
+    MeshInfo&                     loadedInfo,
+    const std::vector<uint>&      vids,
+    const std::vector<uint>&      wids,
+    const std::vector<uint>&      nids,
+    const std::vector<Point3d>&   normals,
+    const std::vector<TexCoordd>& wedgeTexCoords,
+    const ObjMaterial&            currentMaterial,
+    const LoadSettings&           settings)
+{
+    using FaceType = MeshType::FaceType;
+
+    loadedInfo.updateMeshType(vids.size());
 
     // add the face
     uint      fid = m.addFace();
@@ -271,9 +290,9 @@ void readObjFace(
     // we have a polygonal mesh, no need to split
     if constexpr (FaceType::VERTEX_COUNT < 0) {
         // need to resize to the right number of verts
-        f.resizeVertices(tokens.size() - 1);
+        f.resizeVertices(vids.size());
     }
-    else if (FaceType::VERTEX_COUNT != tokens.size() - 1) {
+    else if (FaceType::VERTEX_COUNT != vids.size()) {
         // we have faces with static sizes (triangles), but we are loading faces
         // with number of verts > 3. Need to split the face we are loading in n
         // faces!
@@ -420,6 +439,39 @@ void readObjFace(
     }
 }
 
+template<FaceMeshConcept MeshType>
+void readObjFace(
+    MeshType&                     m,
+    MeshInfo&                     loadedInfo,
+    const Tokenizer&              tokens,
+    const std::vector<Point3d>&   normals,
+    const std::vector<TexCoordd>& wedgeTexCoords,
+    const ObjMaterial&            currentMaterial,
+    const LoadSettings&           settings)
+{
+    std::vector<uint> vids;
+    std::vector<uint> wids;
+    std::vector<uint> nids;
+
+    vids.reserve(tokens.size() - 1);
+    wids.reserve(tokens.size() - 1);
+    nids.reserve(tokens.size() - 1);
+
+    StringViewTokenizer subt('/');
+    readObjFaceIndices(tokens, subt, vids, wids, nids);
+
+    addObjFace(
+        m,
+        loadedInfo,
+        vids,
+        wids,
+        nids,
+        normals,
+        wedgeTexCoords,
+        currentMaterial,
+        settings);
+}
+
 template<EdgeMeshConcept MeshType>
 void readObjEdge(
     MeshType&           m,
@@ -442,11 +494,211 @@ void readObjEdge(
     e.setVertices(vid1, vid2);
 }
 
+/**
+ * @brief The elements read from a chunk of lines of an obj file, stored in flat
+ * arrays, in the order in which they appear in the chunk.
+ */
+struct ObjChunk
+{
+    // mtllib and usemtl statements, with the number of faces of the chunk that
+    // precede them
+    struct Statement
+    {
+        uint        face;
+        std::string header;
+        std::string arg;
+    };
+
+    // 3 coordinates and 3 color components for each vertex
+    std::vector<double> positions;
+    std::vector<float>  colors;
+    std::vector<bool>   hasColor;
+
+    std::vector<Point3d>   normals;
+    std::vector<TexCoordd> texCoords;
+
+    // number of vertex, texcoord and normal indices of each face
+    std::vector<uint> faceSizes;
+    std::vector<uint> faceWSizes;
+    std::vector<uint> faceNSizes;
+    std::vector<uint> vids;
+    std::vector<uint> wids;
+    std::vector<uint> nids;
+
+    // 2 vertex indices for each edge
+    std::vector<uint> edges;
+
+    std::vector<Statement> statements;
+
+    bool hasFaces = false;
+    bool hasEdges = false;
+
+    uint vertexCount() const { return positions.size() / 3; }
+};
+
+template<MeshConcept MeshType>
+void readObjChunk(const LineChunk& chunk, ObjChunk& oc)
+{
+    StringViewTokenizer tokens;
+    StringViewTokenizer subt('/');
+
+    forEachNonEmptyLine(chunk, [&](std::string_view line, uint) {
+        tokens.split(line);
+        auto             token  = tokens.begin();
+        std::string_view header = *token++;
+        if (header == "mtllib" || header == "usemtl") {
+            std::string arg = token != tokens.end() ? std::string(*token) : "";
+            oc.statements.push_back(
+                {uint(oc.faceSizes.size()), std::string(header), arg});
+        }
+        // read vertex (and for some non-standard obj files, also vertex
+        // color)
+        if (header == "v") {
+            for (uint i = 0; i < 3; ++i) {
+                oc.positions.push_back(io::readDouble<double>(token));
+            }
+            bool hasColor = false;
+            if constexpr (HasPerVertexColor<MeshType>) {
+                hasColor = tokens.size() > 6;
+            }
+            for (uint i = 0; i < 3; ++i) {
+                oc.colors.push_back(
+                    hasColor ? io::readFloat<float>(token) : 0.0f);
+            }
+            oc.hasColor.push_back(hasColor);
+        }
+        if (header == "vn") {
+            if constexpr (HasPerVertexNormal<MeshType>) {
+                Point3d n;
+                for (uint i = 0; i < 3; ++i) {
+                    n[i] = io::readDouble<double>(token);
+                }
+                oc.normals.push_back(n);
+            }
+        }
+        if (header == "vt") {
+            if constexpr (
+                HasPerVertexTexCoord<MeshType> ||
+                HasPerFaceWedgeTexCoords<MeshType>) {
+                TexCoordd tf;
+                for (uint i = 0; i < 2; ++i) {
+                    tf[i] = io::readDouble<double>(token);
+                }
+                oc.texCoords.push_back(tf);
+            }
+        }
+        if (header == "f") {
+            oc.hasFaces = true;
+            if constexpr (HasFaces<MeshType>) {
+                std::size_t nv = oc.vids.size();
+                std::size_t nw = oc.wids.size();
+                std::size_t nn = oc.nids.size();
+                readObjFaceIndices(tokens, subt, oc.vids, oc.wids, oc.nids);
+                oc.faceSizes.push_back(oc.vids.size() - nv);
+                oc.faceWSizes.push_back(oc.wids.size() - nw);
+                oc.faceNSizes.push_back(oc.nids.size() - nn);
+            }
+        }
+        if (header == "l") {
+            oc.hasEdges = true;
+            if constexpr (HasEdges<MeshType>) {
+                oc.edges.push_back(io::readUInt<uint>(token) - 1);
+                oc.edges.push_back(io::readUInt<uint>(token) - 1);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Parses in parallel the chunks of lines of an obj file, and adds to the
+ * mesh the vertices read from all the chunks.
+ *
+ * @return the elements read from each chunk.
+ */
+template<MeshConcept MeshType, LoggerConcept LogType>
+std::vector<ObjChunk> readObjChunks(
+    MeshType&               m,
+    const MemoryMappedFile& mappedFile,
+    MeshInfo&               loadedInfo,
+    const LoadSettings&     settings,
+    LogType&                log)
+{
+    std::vector<LineChunk> chunks = splitInLineChunks(
+        mappedFile.data(),
+        mappedFile.data() + mappedFile.size(),
+        settings.textChunkSize);
+    std::vector<ObjChunk> objChunks(chunks.size());
+
+    std::atomic<std::size_t> parsed = 0;
+    parallelForLineChunks(chunks, [&](const LineChunk& c, uint ci) {
+        readObjChunk<MeshType>(c, objChunks[ci]);
+        // progress (in bytes) is reported once per chunk; the logger is thread
+        // safe
+        std::size_t size = c.end - c.begin;
+        log.progress(parsed.fetch_add(size) + size);
+    });
+
+    // first vertex of each chunk
+    std::vector<uint> firstVertex(objChunks.size());
+    uint              nv = m.vertexCount();
+    for (uint ci = 0; ci < objChunks.size(); ++ci) {
+        firstVertex[ci] = nv;
+        nv += objChunks[ci].vertexCount();
+    }
+    if (nv == m.vertexCount())
+        return objChunks;
+
+    loadedInfo.setVertices();
+    loadedInfo.setPerVertexPosition();
+
+    if constexpr (HasPerVertexColor<MeshType>) {
+        if (m.vertexCount() == 0) {
+            // if the file stores the vertex color in the non-standard way
+            // (color values after the positions)
+            auto it = std::find_if(
+                objChunks.begin(), objChunks.end(), [](const ObjChunk& oc) {
+                    return oc.vertexCount() > 0;
+                });
+            if (it->hasColor[0]) {
+                if (settings.enableOptionalComponents) {
+                    enableIfPerVertexColorOptional(m);
+                    loadedInfo.setPerVertexColor();
+                }
+                else {
+                    if (isPerVertexColorAvailable(m))
+                        loadedInfo.setPerVertexColor();
+                }
+            }
+        }
+    }
+
+    m.addVertices(nv - m.vertexCount());
+    parallelForLineChunks(chunks, [&](const LineChunk&, uint ci) {
+        const ObjChunk& oc = objChunks[ci];
+        for (uint i = 0; i < oc.vertexCount(); ++i) {
+            auto& v = m.vertex(firstVertex[ci] + i);
+            for (uint j = 0; j < 3; ++j) {
+                v.position()[j] = oc.positions[i * 3 + j];
+            }
+            if constexpr (HasPerVertexColor<MeshType>) {
+                if (loadedInfo.hasPerVertexColor() && oc.hasColor[i]) {
+                    v.color().setRedF(oc.colors[i * 3]);
+                    v.color().setGreenF(oc.colors[i * 3 + 1]);
+                    v.color().setBlueF(oc.colors[i * 3 + 2]);
+                }
+            }
+        }
+    });
+    return objChunks;
+}
+
 /**
  * @brief Actual implementation of loading an obj from a stream or a file.
  *
  * @param[in] m: The mesh to fill with the data read from the file.
  * @param[in] inputObjStream: The stream from which to read the obj file.
+ * @param[in] mappedFile: The memory mapping of the obj file. If it is open, the
+ * file is parsed in parallel from the mapped memory instead of the stream.
  * @param[in] inputMtlStreams: A vector of streams from which to read the mtl
  * files. It is used if the list of material files are known before reading the
  * obj file.
@@ -465,6 +717,7 @@ template<MeshConcept MeshType, LoggerConcept LogType = NullLogger>
 void loadObj(
     MeshType&                         m,
     std::istream&                     inputObjStream,
+    const MemoryMappedFile&           mappedFile,
     const std::vector<std::istream*>& inputMtlStreams,
     MeshInfo&                         loadedInfo,
     const std::string&                filename     = "",
@@ -500,107 +753,181 @@ void loadObj(
         m.name() = FileInfo::fileNameWithoutExtension(filename);
     }
 
+    auto loadMtlLib = [&](const std::string& mtllib) {
+        // we load the material file if they are not ignored
+        std::string mtlfile = FileInfo::pathWithoutFileName(filename) + mtllib;
+        try {
+            detail::loadObjMaterials(
+                materialMap, m, mtlfile, loadedInfo, settings);
+        }
+        catch (CannotOpenFileException) {
+            log.log(
+                "Cannot open material file " + mtlfile, LogType::WARNING_LOG);
+        }
+    };
+
+    auto useMtl = [&](const std::string& matname) {
+        auto it = materialMap.find(matname);
+        if (it != materialMap.end()) {
+            currentMaterial = it->second;
+        }
+        else { // material not found - warning
+            log.log(
+                "Material " + matname + " not found.", LogType::WARNING_LOG);
+        }
+    };
+
     inputObjStream.seekg(0, inputObjStream.end);
     std::size_t fsize = inputObjStream.tellg();
     inputObjStream.seekg(0, inputObjStream.beg);
     log.startProgress("Loading OBJ file", fsize);
 
-    // cycle that reads line by line
-    do {
-        Tokenizer tokens =
-            readAndTokenizeNextNonEmptyLineNoThrow(inputObjStream);
-        if (inputObjStream) {
-            Tokenizer::iterator token  = tokens.begin();
-            std::string         header = *token++;
-            if (header == "mtllib" && !ignoreMtlLib) { // material file
-                // we load the material file if they are not ignored
-                std::string mtlfile =
-                    FileInfo::pathWithoutFileName(filename) + *token;
-                try {
-                    detail::loadObjMaterials(
-                        materialMap, m, mtlfile, loadedInfo, settings);
-                }
-                catch (CannotOpenFileException) {
-                    log.log(
-                        "Cannot open material file " + mtlfile,
-                        LogType::WARNING_LOG);
-                }
-            }
-            // use a new material - change currentMaterial
-            if (header == "usemtl") {
-                std::string matname = *token;
-                auto        it      = materialMap.find(matname);
-                if (it != materialMap.end()) {
-                    currentMaterial = it->second;
-                }
-                else { // material not found - warning
-                    log.log(
-                        "Material " + matname + " not found.",
-                        LogType::WARNING_LOG);
-                }
-            }
-            // read vertex (and for some non-standard obj files, also vertex
-            // color)
-            if (header == "v") {
-                loadedInfo.setVertices();
-                loadedInfo.setPerVertexPosition();
-                detail::readObjVertex(m, token, loadedInfo, tokens, settings);
-            }
-            // read normals and save them in the vector of normasl, we will
-            // store them in the mesh later
-            if (header == "vn") {
-                if constexpr (HasPerVertexNormal<MeshType>) {
-                    Point3d n;
-                    for (uint i = 0; i < 3; ++i) {
-                        n[i] = io::readDouble<double>(token);
-                    }
-                    normals.push_back(n);
-                }
-            }
-            // read texcoords and save them in the vector of texcoords, we will
-            // store them in the mesh later
-            if (header == "vt") {
-                if constexpr (
-                    HasPerVertexTexCoord<MeshType> ||
-                    HasPerFaceWedgeTexCoords<MeshType>) {
-                    // save the texcoord for later
-                    TexCoordd tf;
-                    for (uint i = 0; i < 2; ++i) {
-                        tf[i] = io::readDouble<double>(token);
-                    }
-                    texCoords.push_back(tf);
-                }
-            }
-            // read faces and manage:
-            // - color
-            // - eventual texcoords
-            // - possibility to split polygonal face into several triangles
-            if (header == "f") {
+    if (mappedFile.isOpen()) {
+        std::vector<ObjChunk> chunks =
+            readObjChunks(m, mappedFile, loadedInfo, settings, log);
+
+        for (const ObjChunk& oc : chunks) {
+            normals.insert(normals.end(), oc.normals.begin(), oc.normals.end());
+            texCoords.insert(
+                texCoords.end(), oc.texCoords.begin(), oc.texCoords.end());
+        }
+
+        // faces are added sequentially, in the order of the file, since
+        // materials and triangulated polygons depend on the previous faces
+        std::vector<uint> vids, wids, nids;
+        for (const ObjChunk& oc : chunks) {
+            if (oc.hasFaces) {
                 loadedInfo.setFaces();
                 loadedInfo.setPerFaceVertexReferences();
+            }
+            if (oc.hasEdges) {
+                loadedInfo.setEdges();
+                loadedInfo.setPerEdgeVertexReferences();
+            }
+
+            const uint* v = oc.vids.data();
+            const uint* w = oc.wids.data();
+            const uint* n = oc.nids.data();
+            uint        s = 0;
+            for (uint k = 0; k <= oc.faceSizes.size(); ++k) {
+                for (; s < oc.statements.size() && oc.statements[s].face == k;
+                     ++s) {
+                    const ObjChunk::Statement& st = oc.statements[s];
+                    if (st.header == "mtllib" && !ignoreMtlLib)
+                        loadMtlLib(st.arg);
+                    if (st.header == "usemtl")
+                        useMtl(st.arg);
+                }
+                if (k == oc.faceSizes.size())
+                    break;
+
                 if constexpr (HasFaces<MeshType>) {
-                    detail::readObjFace(
+                    vids.assign(v, v + oc.faceSizes[k]);
+                    wids.assign(w, w + oc.faceWSizes[k]);
+                    nids.assign(n, n + oc.faceNSizes[k]);
+                    v += oc.faceSizes[k];
+                    w += oc.faceWSizes[k];
+                    n += oc.faceNSizes[k];
+                    detail::addObjFace(
                         m,
                         loadedInfo,
-                        tokens,
+                        vids,
+                        wids,
+                        nids,
                         normals,
                         texCoords,
                         currentMaterial,
                         settings);
                 }
             }
-            // read edges and manage their color
-            if (header == "l") {
-                loadedInfo.setEdges();
-                loadedInfo.setPerEdgeVertexReferences();
-                if constexpr (HasEdges<MeshType>) {
-                    detail::readObjEdge(
-                        m, loadedInfo, tokens, currentMaterial, settings);
+
+            if constexpr (HasEdges<MeshType>) {
+                for (uint i = 0; i < oc.edges.size(); i += 2) {
+                    uint eid = m.addEdge();
+                    m.edge(eid).setVertices(oc.edges[i], oc.edges[i + 1]);
                 }
             }
-            log.progress(inputObjStream.tellg());
         }
-    } while (inputObjStream);
+    }
+    else {
+        // cycle that reads line by line
+        do {
+            Tokenizer tokens =
+                readAndTokenizeNextNonEmptyLineNoThrow(inputObjStream);
+            if (inputObjStream) {
+                Tokenizer::iterator token  = tokens.begin();
+                std::string         header = *token++;
+                if (header == "mtllib" && !ignoreMtlLib) { // material file
+                    loadMtlLib(*token);
+                }
+                // use a new material - change currentMaterial
+                if (header == "usemtl") {
+                    useMtl(*token);
+                }
+                // read vertex (and for some non-standard obj files, also vertex
+                // color)
+                if (header == "v") {
+                    loadedInfo.setVertices();
+                    loadedInfo.setPerVertexPosition();
+                    detail::readObjVertex(
+                        m, token, loadedInfo, tokens, settings);
+                }
+                // read normals and save them in the vector of normasl, we will
+                // store them in the mesh later
+                if (header == "vn") {
+                    if constexpr (HasPerVertexNormal<MeshType>) {
+                        Point3d n;
+                        for (uint i = 0; i < 3; ++i) {
+                            n[i] = io::readDouble<double>(token);
+                        }
+                        normals.push_back(n);
+                    }
+                }
+                // read texcoords and save them in the vector of texcoords, we
+                // will store them in the mesh later
+                if (header == "vt") {
+                    if constexpr (
+                        HasPerVertexTexCoord<MeshType> ||
+                        HasPerFaceWedgeTexCoords<MeshType>) {
+                        // save the texcoord for later
+                        TexCoordd tf;
+                        for (uint i = 0; i < 2; ++i) {
+                            tf[i] = io::readDouble<double>(token);
+                        }
+                        texCoords.push_back(tf);
+                    }
+                }
+                // read faces and manage:
+                // - color
+                // - eventual texcoords
+                // - possibility to split polygonal face into several triangles
+                if (header == "f") {
+                    loadedInfo.setFaces();
+                    loadedInfo.setPerFaceVertexReferences();
+                    if constexpr (HasFaces<MeshType>) {
+                        detail::readObjFace(
+                            m,
+                            loadedInfo,
+                            tokens,
+                            normals,
+                            texCoords,
+                            currentMaterial,
+                            settings);
+                    }
+                }
+                // read edges and manage their color
+                if (header == "l") {
+                    loadedInfo.setEdges();
+                    loadedInfo.setPerEdgeVertexReferences();
+                    if constexpr (HasEdges<MeshType>) {
+                        detail::readObjEdge(
+                            m, loadedInfo, tokens, currentMaterial, settings);
+                    }
+                }
+                log.progress(inputObjStream.tellg());
+            }
+        } while (inputObjStream);
+    }
 
     if constexpr (HasPerVertexNormal<MeshType>) {
         using NormalType = typename MeshType::VertexType::NormalType;
@@ -724,6 +1051,7 @@ void loadObj(
     detail::loadObj(
         m,
         inputObjStream,
+        MemoryMappedFile(),
         inputMtlStreams,
         loadedInfo,
         "",
@@ -787,8 +1115,26 @@ void loadObj(
         // some type of files...
     }
 
+    MemoryMappedFile mappedFile;
+    if (settings.parallelTextParsing) {
+        try {
+            mappedFile.open(filename);
+        }
+        catch (const CannotOpenFileException&) {
+            // the file will be read from the stream
+        }
+    }
+
     detail::loadObj(
-        m, file, mtlStreams, loadedInfo, filename, false, settings, log);
+        m,
+        file,
+        mappedFile,
+        mtlStreams,
+        loadedInfo,
+        filename,
+        false,
+        settings,
+        log);
 }
 
 } // namespace vcl
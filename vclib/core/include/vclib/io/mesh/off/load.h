@@ -9,12 +9,16 @@
 #define VCL_IO_MESH_OFF_LOAD_H
 
 #include <vclib/io/file_info.h>
+#include <vclib/io/line_chunks.h>
+#include <vclib/io/memory_mapped_file.h>
 #include <vclib/io/mesh/settings.h>
 #include <vclib/io/read.h>
 
 #include <vclib/algorithms/mesh.h>
 #include <vclib/space/complex.h>
 
+#include <atomic>
+
 namespace vcl {
 
 namespace detail {
@@ -257,7 +261,8 @@ inline void readOffHeader(
     //    loadedInfo.setEdges();
 }
 
-inline Color readOffColor(Tokenizer::iterator& token, int nColorComponents)
+template<typename TokenIterator>
+Color readOffColor(TokenIterator& token, int nColorComponents)
 {
     uint red, green, blue, alpha = 255;
 
@@ -293,92 +298,128 @@ inline Color readOffColor(Tokenizer::iterator& token, int nColorComponents)
     return Color(red, green, blue, alpha);
 }
 
-template<MeshConcept MeshType, LoggerConcept LogType>
-void readOffVertices(
+template<MeshConcept MeshType, VertexConcept VertexType, typename Tokens>
+void readOffVertex(
+    VertexType&     v,
     MeshType&       mesh,
-    std::istream&   file,
-    const MeshInfo& fileInfo,
-    uint            nv,
-    LogType&        log)
+    const Tokens&   tokens,
+    const MeshInfo& fileInfo)
 {
-    using VertexType = MeshType::VertexType;
-
     const uint nTexCoords = fileInfo.hasPerVertexTexCoord() ? 2 : 0;
 
-    log.startProgress("Reading vertices", nv);
-    mesh.addVertices(nv);
-    for (uint i = 0; i < nv; i++) {
-        VertexType& v = mesh.vertex(i);
-
-        Tokenizer           tokens = readAndTokenizeNextNonCommentLine(file);
-        Tokenizer::iterator token  = tokens.begin();
+    auto token = tokens.begin();
 
-        // Read 3 vertex coordinates
-        for (unsigned int j = 0; j < 3; j++) {
-            // Read vertex coordinate
-            v.position()[j] = io::readDouble<double>(token);
-        }
+    // Read 3 vertex coordinates
+    for (unsigned int j = 0; j < 3; j++) {
+        // Read vertex coordinate
+        v.position()[j] = io::readDouble<double>(token);
+    }
 
-        if constexpr (HasPerVertexNormal<MeshType>) {
-            if (isPerVertexNormalAvailable(mesh) &&
-                fileInfo.hasPerVertexNormal()) {
-                // Read 3 normal coordinates
-                for (unsigned int j = 0; j < 3; j++) {
-                    v.normal()[j] = io::readDouble<double>(token);
-                }
-            }
-        }
-        // need to read and throw away data
-        else if (fileInfo.hasPerVertexNormal()) {
+    if constexpr (HasPerVertexNormal<MeshType>) {
+        if (isPerVertexNormalAvailable(mesh) && fileInfo.hasPerVertexNormal()) {
+            // Read 3 normal coordinates
             for (unsigned int j = 0; j < 3; j++) {
-                io::readDouble<double>(token);
+                v.normal()[j] = io::readDouble<double>(token);
             }
         }
-
-        const uint nReadComponents = token - tokens.begin();
-        const int  nColorComponents =
-            (int) tokens.size() - nReadComponents - nTexCoords;
-
-        if constexpr (HasPerVertexColor<MeshType>) {
-            if (isPerVertexColorAvailable(mesh) &&
-                fileInfo.hasPerVertexColor()) {
-                if (nColorComponents != 1 && nColorComponents != 3 &&
-                    nColorComponents != 4)
-                    throw MalformedFileException(
-                        "Wrong number of components in line.");
-                v.color() = readOffColor(token, nColorComponents);
-            }
+    }
+    // need to read and throw away data
+    else if (fileInfo.hasPerVertexNormal()) {
+        for (unsigned int j = 0; j < 3; j++) {
+            io::readDouble<double>(token);
         }
-        // need to read and throw away data
-        else if (fileInfo.hasPerVertexColor()) {
+    }
+
+    const uint nReadComponents = token - tokens.begin();
+    const int  nColorComponents =
+        (int) tokens.size() - nReadComponents - nTexCoords;
+
+    if constexpr (HasPerVertexColor<MeshType>) {
+        if (isPerVertexColorAvailable(mesh) && fileInfo.hasPerVertexColor()) {
             if (nColorComponents != 1 && nColorComponents != 3 &&
                 nColorComponents != 4)
                 throw MalformedFileException(
                     "Wrong number of components in line.");
-            readOffColor(token, nColorComponents);
+            v.color() = readOffColor(token, nColorComponents);
         }
+    }
+    // need to read and throw away data
+    else if (fileInfo.hasPerVertexColor()) {
+        if (nColorComponents != 1 && nColorComponents != 3 &&
+            nColorComponents != 4)
+            throw MalformedFileException("Wrong number of components in line.");
+        readOffColor(token, nColorComponents);
+    }
 
-        if constexpr (HasPerVertexTexCoord<MeshType>) {
-            if (isPerVertexTexCoordAvailable(mesh) &&
-                fileInfo.hasPerVertexTexCoord()) {
-                // Read 2 tex coordinates
-                for (unsigned int j = 0; j < 2; j++) {
-                    v.texCoord()[j] = io::readDouble<double>(token);
-                }
-            }
-        }
-        // need to read and throw away data
-        else if (fileInfo.hasPerVertexTexCoord()) {
+    if constexpr (HasPerVertexTexCoord<MeshType>) {
+        if (isPerVertexTexCoordAvailable(mesh) &&
+            fileInfo.hasPerVertexTexCoord()) {
+            // Read 2 tex coordinates
             for (unsigned int j = 0; j < 2; j++) {
-                io::readDouble<double>(token);
+                v.texCoord()[j] = io::readDouble<double>(token);
             }
         }
+    }
+    // need to read and throw away data
+    else if (fileInfo.hasPerVertexTexCoord()) {
+        for (unsigned int j = 0; j < 2; j++) {
+            io::readDouble<double>(token);
+        }
+    }
+}
+
+template<MeshConcept MeshType, LoggerConcept LogType>
+void readOffVertices(
+    MeshType&       mesh,
+    std::istream&   file,
+    const MeshInfo& fileInfo,
+    uint            nv,
+    LogType&        log)
+{
+    log.startProgress("Reading vertices", nv);
+    mesh.addVertices(nv);
+    for (uint i = 0; i < nv; i++) {
+        Tokenizer tokens = readAndTokenizeNextNonCommentLine(file);
+        readOffVertex(mesh.vertex(i), mesh, tokens, fileInfo);
 
         log.progress(i);
     }
     log.endProgress();
 }
 
+template<FaceMeshConcept MeshType, FaceConcept FaceType>
+void setOffFaceVertices(
+    MeshType&                mesh,
+    FaceType&                f,
+    const std::vector<uint>& vids)
+{
+    bool splitFace = false;
+    // we have a polygonal mesh
+    if constexpr (FaceType::VERTEX_COUNT < 0) {
+        // need to resize to the right number of verts
+        f.resizeVertices(vids.size());
+    }
+    else if (FaceType::VERTEX_COUNT != vids.size()) {
+        // we have faces with static sizes (triangles), but we are loading faces
+        // with number of verts > 3. Need to split the face we are loading in n
+        // faces!
+        splitFace = true;
+    }
+    if (!splitFace) { // classic load, no split needed
+        for (uint i = 0; i < vids.size(); ++i) {
+            if (vids[i] >= mesh.vertexCount()) {
+                throw MalformedFileException(
+                    "Bad vertex index for face " +
+                    std::to_string(mesh.index(f)));
+            }
+            f.setVertex(i, vids[i]);
+        }
+    }
+    else { // split needed
+        addTriangleFacesFromPolygon(mesh, f, vids);
+    }
+}
+
 template<FaceMeshConcept MeshType, LoggerConcept LogType>
 void readOffFaces(
     MeshType&           mesh,
@@ -397,8 +438,7 @@ void readOffFaces(
         for (uint fid = 0; fid < nf; ++fid) {
             Tokenizer tokens          = readAndTokenizeNextNonCommentLine(file);
             Tokenizer::iterator token = tokens.begin();
-            mesh.addFace();
-            FaceType& f = mesh.face(mesh.faceCount() - 1);
+            uint ffid = mesh.addFace();
 
             // read vertex indices
             uint fSize = io::readUInt<uint>(token);
@@ -412,30 +452,10 @@ void readOffFaces(
             }
 
             // load vertex indices into face
-            bool splitFace = false;
-            // we have a polygonal mesh
-            if constexpr (FaceType::VERTEX_COUNT < 0) {
-                // need to resize to the right number of verts
-                f.resizeVertices(vids.size());
-            }
-            else if (FaceType::VERTEX_COUNT != vids.size()) {
-                // we have faces with static sizes (triangles), but we are
-                // loading faces with number of verts > 3. Need to split the
-                // face we are loading in n faces!
-                splitFace = true;
-            }
-            if (!splitFace) { // classic load, no split needed
-                for (uint i = 0; i < vids.size(); ++i) {
-                    if (vids[i] >= mesh.vertexCount()) {
-                        throw MalformedFileException(
-                            "Bad vertex index for face " + std::to_string(i));
-                    }
-                    f.setVertex(i, vids[i]);
-                }
-            }
-            else { // split needed
-                addTriangleFacesFromPolygon(mesh, f, vids);
-            }
+            setOffFaceVertices(mesh, mesh.face(ffid), vids);
+            // the face is accessed by index: the container may have been
+            // reallocated if the polygon has been triangulated
+            FaceType& f = mesh.face(ffid);
 
             // read face color
             if (token != tokens.end()) { // there are colors to read
@@ -448,8 +468,7 @@ void readOffFaces(
                             token, tokens.size() - (token - tokens.begin()));
                         // in case the loaded polygon has been triangulated in
                         // the last n triangles
-                        for (uint ff = mesh.index(f); ff < mesh.faceCount();
-                             ++ff) {
+                        for (uint ff = ffid; ff < mesh.faceCount(); ++ff) {
                             mesh.face(ff).color() = f.color();
                         }
                     }
@@ -465,6 +484,263 @@ void readOffFaces(
     }
 }
 
+/**
+ * @brief The faces read from a chunk of lines of an off file, stored in flat
+ * arrays: the vertex indices of the k-th face of the chunk are stored in the
+ * vids array, after the ones of the previous faces of the chunk.
+ */
+struct OffFaceChunk
+{
+    uint               firstFace = 0;
+    std::vector<uint>  sizes;
+    std::vector<uint>  vids;
+    std::vector<Color> colors;
+    std::vector<bool>  hasColor;
+};
+
+template<typename Tokens>
+void readOffFace(const Tokens& tokens, OffFaceChunk& chunk, bool readColor)
+{
+    auto token = tokens.begin();
+    uint fSize = io::readUInt<uint>(token);
+    if (tokens.size() <= fSize) {
+        throw MalformedFileException("Unexpected end of line.");
+    }
+    chunk.sizes.push_back(fSize);
+    for (uint i = 0; i < fSize; ++i) {
+        chunk.vids.push_back(io::readUInt<uint>(token));
+    }
+
+    // read face color
+    Color c;
+    bool  hasColor = readColor && token != tokens.end();
+    if (hasColor) {
+        c = readOffColor(token, tokens.size() - (token - tokens.begin()));
+    }
+    chunk.colors.push_back(c);
+    chunk.hasColor.push_back(hasColor);
+}
+
+template<FaceMeshConcept MeshType>
+void mergeOffFaces(
+    MeshType&                        mesh,
+    std::vector<LineChunk>&          chunks,
+    const std::vector<OffFaceChunk>& faceChunks,
+    MeshInfo&                        loadedInfo,
+    uint                             nf,
+    const LoadSettings&              settings)
+{
+    using FaceType = MeshType::FaceType;
+
+    bool splitFaces = false;
+    bool hasColors  = false;
+    for (const OffFaceChunk& fc : faceChunks) {
+        for (uint fSize : fc.sizes) {
+            loadedInfo.updateMeshType(fSize);
+            if constexpr (FaceType::VERTEX_COUNT > 0) {
+                if (fSize != FaceType::VERTEX_COUNT)
+                    splitFaces = true;
+            }
+        }
+        hasColors = hasColors || std::find(
+                                     fc.hasColor.begin(),
+                                     fc.hasColor.end(),
+                                     true) != fc.hasColor.end();
+    }
+
+    bool readColors = false;
+    if constexpr (HasPerFaceColor<MeshType>) {
+        if (hasColors && (isPerFaceColorAvailable(mesh) ||
+                          (settings.enableOptionalComponents &&
+                           enableIfPerFaceColorOptional(mesh)))) {
+            loadedInfo.setPerFaceColor();
+            readColors = true;
+        }
+    }
+
+    auto setColor = [&](uint fid, const OffFaceChunk& fc, uint k) {
+        if constexpr (HasPerFaceColor<MeshType>) {
+            if (readColors && fc.hasColor[k]) {
+                // in case the loaded polygon has been triangulated in the
+                // last n triangles
+                for (uint ff = fid; ff < mesh.faceCount(); ++ff) {
+                    mesh.face(ff).color() = fc.colors[k];
+                }
+            }
+        }
+    };
+
+    if (splitFaces) {
+        // triangles are added at the end of the container: faces are added
+        // sequentially
+        mesh.reserveFaces(nf);
+        std::vector<uint> vids;
+        for (const OffFaceChunk& fc : faceChunks) {
+            const uint* v = fc.vids.data();
+            for (uint k = 0; k < fc.sizes.size(); ++k) {
+                vids.assign(v, v + fc.sizes[k]);
+                v += fc.sizes[k];
+                uint fid = mesh.addFace();
+                setOffFaceVertices(mesh, mesh.face(fid), vids);
+                setColor(fid, fc, k);
+            }
+        }
+    }
+    else {
+        const uint first = mesh.faceCount();
+        mesh.addFaces(nf);
+        parallelForLineChunks(chunks, [&](const LineChunk&, uint c) {
+            const OffFaceChunk& fc = faceChunks[c];
+            const uint*         v  = fc.vids.data();
+            for (uint k = 0; k < fc.sizes.size(); ++k) {
+                uint      fid = first + fc.firstFace + k;
+                FaceType& f   = mesh.face(fid);
+                if constexpr (FaceType::VERTEX_COUNT < 0) {
+                    f.resizeVertices(fc.sizes[k]);
+                }
+                for (uint i = 0; i < fc.sizes[k]; ++i) {
+                    if (v[i] >= mesh.vertexCount()) {
+                        throw MalformedFileException(
+                            "Bad vertex index for face " +
+                            std::to_string(fid));
+                    }
+                    f.setVertex(i, v[i]);
+                }
+                v += fc.sizes[k];
+                if constexpr (HasPerFaceColor<MeshType>) {
+                    if (readColors && fc.hasColor[k])
+                        f.color() = fc.colors[k];
+                }
+            }
+        });
+    }
+}
+
+/**
+ * @brief Reads the vertices and the faces of an off file directly from its
+ * memory mapping, starting from the current position of the stream.
+ *
+ * The lines containing vertices and faces are split in chunks that are parsed
+ * in parallel. Vertices are read directly into the vertex container of the
+ * mesh, while faces are first stored in flat per-chunk arrays, that are merged
+ * into the face container once the size of all the faces is known. The merge
+ * is done in parallel, unless some polygon must be split in triangles.
+ */
+template<MeshConcept MeshType, LoggerConcept LogType>
+void readOffMapped(
+    MeshType&               mesh,
+    std::istream&           file,
+    const MemoryMappedFile& mappedFile,
+    MeshInfo&               fileInfo,
+    uint                    nv,
+    uint                    nf,
+    const LoadSettings&     settings,
+    LogType&                log)
+{
+    const uint nLines = HasFaces<MeshType> ? nv + nf : nv;
+
+    std::size_t            offset = file.tellg();
+    std::vector<LineChunk> chunks = lineChunks(
+        mappedFile.data() + offset,
+        mappedFile.data() + mappedFile.size(),
+        nLines,
+        settings.textChunkSize,
+        true);
+
+    log.startProgress("Reading vertices and faces", nLines);
+
+    mesh.addVertices(nv);
+    std::vector<OffFaceChunk> faceChunks(chunks.size());
+    std::atomic<uint>         processed = 0;
+    parallelForLineChunks(chunks, [&](const LineChunk& c, uint ci) {
+        StringViewTokenizer tokens;
+        OffFaceChunk&       fc = faceChunks[ci];
+        fc.firstFace           = c.firstLine > nv ? c.firstLine - nv : 0;
+        forEachNonEmptyLine(
+            c,
+            [&](std::string_view line, uint i) {
+                tokens.split(line);
+                if (i < nv)
+                    readOffVertex(mesh.vertex(i), mesh, tokens, fileInfo);
+                else
+                    readOffFace(tokens, fc, HasPerFaceColor<MeshType>);
+            },
+            true);
+        // progress is reported once per chunk; the logger is thread safe
+        log.progress(processed.fetch_add(c.lineCount) + c.lineCount);
+    });
+
+    if constexpr (HasFaces<MeshType>) {
+        mergeOffFaces(mesh, chunks, faceChunks, fileInfo, nf, settings);
+    }
+
+    log.endProgress();
+}
+
+/**
+ * @brief Actual implementation of loading an off from a stream or a file.
+ *
+ * @param[in] mappedFile: the memory mapping of the loaded file. If it is open,
+ * vertices and faces are parsed in parallel from the mapped memory, starting
+ * from the position of the stream after the header; otherwise they are read
+ * from the stream.
+ */
+template<MeshConcept MeshType, LoggerConcept LogType = NullLogger>
+void loadOff(
+    MeshType&               m,
+    std::istream&           inputOffStream,
+    const MemoryMappedFile& mappedFile,
+    MeshInfo&               loadedInfo,
+    const LoadSettings&     settings = LoadSettings(),
+    LogType&                log      = nullLogger)
+{
+    uint nVertices, nFaces, nEdges;
+
+    MeshInfo fileInfo; // data that needs to be read from the file
+
+    readOffHeader(inputOffStream, fileInfo, nVertices, nFaces, nEdges);
+    loadedInfo = fileInfo; // data that will be stored in the mesh!
+    if (settings.enableOptionalComponents)
+        enableOptionalComponentsFromInfo(loadedInfo, m);
+
+    if (nVertices == 0) {
+        log.log("The file has no vertices", LogType::WARNING_LOG);
+        return;
+    }
+
+    int percVertices = nVertices / (nVertices + nFaces) * 100;
+    int percFaces    = 100 - percVertices;
+
+    if (mappedFile.isOpen()) {
+        log.startNewTask(0, 100, "Reading vertices and faces");
+        readOffMapped(
+            m,
+            inputOffStream,
+            mappedFile,
+            fileInfo,
+            nVertices,
+            nFaces,
+            settings,
+            log);
+        log.endTask("Reading vertices and faces");
+    }
+    else {
+        log.startNewTask(0, percVertices, "Reading vertices");
+        readOffVertices(m, inputOffStream, fileInfo, nVertices, log);
+        log.endTask("Reading vertices");
+        if constexpr (HasFaces<MeshType>) {
+            log.startNewTask(percVertices, 100, "Reading faces");
+            readOffFaces(m, inputOffStream, fileInfo, nFaces, settings, log);
+            log.endTask("Reading faces");
+        }
+        else {
+            log.log(100, "Ignored faces reading");
+        }
+    }
+    if (settings.enableOptionalComponents)
+        loadedInfo = fileInfo;
+}
+
 } // namespace detail
 
 /**
@@ -499,37 +775,8 @@ void loadOff(
     const LoadSettings& settings = LoadSettings(),
     LogType&            log      = nullLogger)
 {
-    uint nVertices, nFaces, nEdges;
-
-    MeshInfo fileInfo; // data that needs to be read from the file
-
-    detail::readOffHeader(inputOffStream, fileInfo, nVertices, nFaces, nEdges);
-    loadedInfo = fileInfo; // data that will be stored in the mesh!
-    if (settings.enableOptionalComponents)
-        enableOptionalComponentsFromInfo(loadedInfo, m);
-
-    if (nVertices == 0) {
-        log.log("The file has no vertices", LogType::WARNING_LOG);
-        return;
-    }
-
-    int percVertices = nVertices / (nVertices + nFaces) * 100;
-    int percFaces    = 100 - percVertices;
-
-    log.startNewTask(0, percVertices, "Reading vertices");
-    detail::readOffVertices(m, inputOffStream, fileInfo, nVertices, log);
-    log.endTask("Reading vertices");
-    if constexpr (HasFaces<MeshType>) {
-        log.startNewTask(percVertices, 100, "Reading faces");
-        detail::readOffFaces(
-            m, inputOffStream, fileInfo, nFaces, settings, log);
-        log.endTask("Reading faces");
-    }
-    else {
-        log.log(100, "Ignored faces reading");
-    }
-    if (settings.enableOptionalComponents)
-        loadedInfo = fileInfo;
+    detail::loadOff(
+        m, inputOffStream, MemoryMappedFile(), loadedInfo, settings, log);
 }
 
 /**
@@ -570,7 +817,17 @@ void loadOff(
         m.name() = FileInfo::fileNameWithoutExtension(filename);
     }
 
-    loadOff(m, file, loadedInfo, settings, log);
+    MemoryMappedFile mappedFile;
+    if (settings.parallelTextParsing) {
+        try {
+            mappedFile.open(filename);
+        }
+        catch (const CannotOpenFileException&) {
+            // the file will be read from the stream
+        }
+    }
+
+    detail::loadOff(m, file, mappedFile, loadedInfo, settings, log);
 }
 
 } // namespace vcl
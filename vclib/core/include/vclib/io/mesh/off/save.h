@@ -16,6 +16,65 @@
 
 namespace vcl {
 
+namespace detail {
+
+inline void writeOffHeader(std::ostream& fp, const MeshInfo& meshInfo)
+{
+    if (meshInfo.hasPerVertexNormal())
+        fp << "N";
+    if (meshInfo.hasPerVertexColor())
+        fp << "C";
+    if (meshInfo.hasPerVertexTexCoord())
+        fp << "ST";
+    fp << "OFF" << std::endl;
+
+    fp << "####" << std::endl;
+    fp << "#" << std::endl;
+    fp << "# Generated by VCLib " << VCLIB_VERSION_STRING << std::endl;
+    fp << "#" << std::endl;
+    fp << "####" << std::endl;
+}
+
+template<MeshConcept MeshType>
+void writeOffVertices(
+    std::ostream&   fp,
+    const MeshType& m,
+    const MeshInfo& meshInfo)
+{
+    using VertexType = MeshType::VertexType;
+    for (const VertexType& v : m.vertices()) {
+        io::writeDouble(fp, v.position().x(), false);
+        io::writeDouble(fp, v.position().y(), false);
+        io::writeDouble(fp, v.position().z(), false);
+
+        if constexpr (HasPerVertexColor<MeshType>) {
+            if (meshInfo.hasPerVertexColor()) {
+                io::writeInt(fp, v.color().red(), false);
+                io::writeInt(fp, v.color().green(), false);
+                io::writeInt(fp, v.color().blue(), false);
+                io::writeInt(fp, v.color().alpha(), false);
+            }
+        }
+        if constexpr (HasPerVertexNormal<MeshType>) {
+            if (meshInfo.hasPerVertexNormal()) {
+                io::writeDouble(fp, v.normal().x(), false);
+                io::writeDouble(fp, v.normal().y(), false);
+                io::writeDouble(fp, v.normal().z(), false);
+            }
+        }
+        if constexpr (HasPerVertexTexCoord<MeshType>) {
+            if (meshInfo.hasPerVertexTexCoord()) {
+                io::writeDouble(fp, v.texCoord().u(), false);
+                io::writeDouble(fp, v.texCoord().v(), false);
+            }
+        }
+
+        fp << std::endl;
+    }
+}
+
+} // namespace detail
+
 template<MeshConcept MeshType, LoggerConcept LogType = NullLogger>
 void saveOff(
     const MeshType&     m,
@@ -32,19 +91,7 @@ void saveOff(
     if (!settings.info.isEmpty())
         meshInfo = settings.info.intersect(meshInfo);
 
-    if (meshInfo.hasPerVertexNormal())
-        fp << "N";
-    if (meshInfo.hasPerVertexColor())
-        fp << "C";
-    if (meshInfo.hasPerVertexTexCoord())
-        fp << "ST";
-    fp << "OFF" << std::endl;
-
-    fp << "####" << std::endl;
-    fp << "#" << std::endl;
-    fp << "# Generated by VCLib " << VCLIB_VERSION_STRING << std::endl;
-    fp << "#" << std::endl;
-    fp << "####" << std::endl;
+    detail::writeOffHeader(fp, meshInfo);
 
     uint vn = 0;
     uint fn = 0;
@@ -63,36 +110,7 @@ void saveOff(
 
     // vertices
     if constexpr (HasVertices<MeshType>) {
-        using VertexType = MeshType::VertexType;
-        for (const VertexType& v : m.vertices()) {
-            io::writeDouble(fp, v.position().x(), false);
-            io::writeDouble(fp, v.position().y(), false);
-            io::writeDouble(fp, v.position().z(), false);
-
-            if constexpr (HasPerVertexColor<MeshType>) {
-                if (meshInfo.hasPerVertexColor()) {
-                    io::writeInt(fp, v.color().red(), false);
-                    io::writeInt(fp, v.color().green(), false);
-                    io::writeInt(fp, v.color().blue(), false);
-                    io::writeInt(fp, v.color().alpha(), false);
-                }
-            }
-            if constexpr (HasPerVertexNormal<MeshType>) {
-                if (meshInfo.hasPerVertexNormal()) {
-                    io::writeDouble(fp, v.normal().x(), false);
-                    io::writeDouble(fp, v.normal().y(), false);
-                    io::writeDouble(fp, v.normal().z(), false);
-                }
-            }
-            if constexpr (HasPerVertexTexCoord<MeshType>) {
-                if (meshInfo.hasPerVertexTexCoord()) {
-                    io::writeDouble(fp, v.texCoord().u(), false);
-                    io::writeDouble(fp, v.texCoord().v(), false);
-                }
-            }
-
-            fp << std::endl;
-        }
+        detail::writeOffVertices(fp, m, meshInfo);
     }
 
     // faces
@@ -9,14 +9,19 @@
 #define VCL_IO_MESH_PLY_DETAIL_FACE_H
 
 #include "header.h"
+#include "record_layout.h"
 
 #include <vclib/io/file_type.h>
+#include <vclib/io/line_chunks.h>
+#include <vclib/io/memory_mapped_file.h>
 #include <vclib/io/read.h>
 #include <vclib/io/write.h>
 
 #include <vclib/algorithms/mesh.h>
 #include <vclib/mesh.h>
 
+#include <atomic>
+
 namespace vcl::detail {
 
 template<FaceMeshConcept MeshType, FaceConcept FaceType>
@@ -107,6 +112,19 @@ void setPlyFaceWedgeTexCoords(
     }
 }
 
+/**
+ * @brief Reads the property p of the face f from the given stream.
+ *
+ * When a polygon is loaded in a mesh having faces with static size, it is
+ * split in triangles that are added at the end of the face container, and the
+ * other properties of the face are copied in all the triangles. The faceEnd
+ * argument allows to bound the triangles generated by f when they are not the
+ * last faces of the container: all the faces in [index(f), faceEnd) are
+ * considered as generated by f.
+ *
+ * @param[in] faceEnd: one past the last face generated by f; if UINT_NULL, the
+ * faces generated by f are the last faces of the mesh.
+ */
 template<FaceMeshConcept MeshType, FaceConcept FaceType, typename Stream>
 void readPlyFaceProperty(
     Stream&     file,
@@ -115,8 +133,11 @@ void readPlyFaceProperty(
     PlyProperty p,
     MeshInfo&   loadedInfo,
     bool        vcgGenerated = false,
-    std::endian end          = std::endian::little)
+    std::endian end          = std::endian::little,
+    uint        faceEnd      = UINT_NULL)
 {
+    const uint lastFace = faceEnd == UINT_NULL ? mesh.faceCount() : faceEnd;
+
     bool              hasBeenRead = false;
     std::vector<uint> vids; // contains the vertex ids of the actual face
     if (p.name == ply::vertex_indices) { // loading vertex indices
@@ -171,7 +192,7 @@ void readPlyFaceProperty(
                 hasBeenRead = true;
                 // in case the loaded polygon has been triangulated in the last
                 // n triangles of mesh
-                for (uint ff = mesh.index(f); ff < mesh.faceCount(); ++ff) {
+                for (uint ff = mesh.index(f); ff < lastFace; ++ff) {
                     mesh.face(ff).materialIndex() = n;
                 }
             }
@@ -187,7 +208,7 @@ void readPlyFaceProperty(
                 hasBeenRead  = true;
                 // in case the loaded polygon has been triangulated in the last
                 // n triangles of mesh
-                for (uint ff = mesh.index(f); ff < mesh.faceCount(); ++ff) {
+                for (uint ff = mesh.index(f); ff < lastFace; ++ff) {
                     mesh.face(ff).normal()[a] = n;
                 }
             }
@@ -203,7 +224,7 @@ void readPlyFaceProperty(
                 hasBeenRead = true;
                 // in case the loaded polygon has been triangulated in the last
                 // n triangles of mesh
-                for (uint ff = mesh.index(f); ff < mesh.faceCount(); ++ff) {
+                for (uint ff = mesh.index(f); ff < lastFace; ++ff) {
                     mesh.face(ff).color()[a] = c;
                 }
             }
@@ -218,7 +239,7 @@ void readPlyFaceProperty(
                 hasBeenRead = true;
                 // in case the loaded polygon has been triangulated in the last
                 // n triangles of mesh
-                for (uint ff = mesh.index(f); ff < mesh.faceCount(); ++ff) {
+                for (uint ff = mesh.index(f); ff < lastFace; ++ff) {
                     mesh.face(ff).quality() = s;
                 }
             }
@@ -281,6 +302,123 @@ void readPlyFaceBin(
     }
 }
 
+template<FaceMeshConcept MeshType>
+void readPlyFaceRecords(
+    const char*            data,
+    std::size_t            begin,
+    std::size_t            end,
+    const PlyRecordLayout& layout,
+    uint                   faceSize,
+    MeshType&              mesh,
+    std::endian            endian,
+    std::atomic<uint>&     badFace,
+    bool                   vcgGenerated = false)
+{
+    using FaceType = MeshType::FaceType;
+
+    for (uint k = 0; k < layout.properties.size(); ++k) {
+        const PlyProperty& p = layout.properties[k];
+
+        auto forEachValue = [&](uint offset, auto&& f) {
+            forEachPlyRecordValue(
+                data, begin, end, layout.stride, offset, p.type, endian, f);
+        };
+
+        if (p.name == ply::vertex_indices) {
+            if constexpr (FaceType::VERTEX_COUNT < 0) {
+                for (std::size_t i = begin; i < end; ++i)
+                    mesh.face(i).resizeVertices(faceSize);
+            }
+            uint offset = layout.offsets[k] + sizeOf(p.listSizeType);
+            for (uint j = 0; j < faceSize; ++j) {
+                forEachValue(offset, [&](uint i, auto val) {
+                    uint vid = static_cast<uint>(val);
+                    if (val != static_cast<decltype(val)>(vid) ||
+                        vid >= mesh.vertexCount()) {
+                        badFace = i;
+                        return;
+                    }
+                    mesh.face(i).setVertex(j, vid);
+                });
+                offset += sizeOf(p.type);
+            }
+        }
+        else if (p.name == ply::bit_flags) {
+            if (vcgGenerated) {
+                forEachValue(layout.offsets[k], [&](uint i, auto val) {
+                    mesh.face(i).importFlagsFromVCGFormat(
+                        static_cast<int>(val));
+                });
+            }
+            else {
+                using FlagsType = FaceType::FlagsType;
+                forEachValue(layout.offsets[k], [&](uint i, auto val) {
+                    mesh.face(i).setUnderlyingBitFlags(
+                        static_cast<FlagsType>(val));
+                });
+            }
+        }
+        else if (p.name == ply::material_index) {
+            if constexpr (HasPerFaceMaterialIndex<MeshType>) {
+                if (isPerFaceMaterialIndexAvailable(mesh)) {
+                    forEachValue(layout.offsets[k], [&](uint i, auto val) {
+                        mesh.face(i).materialIndex() = static_cast<uint>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name >= ply::nx && p.name <= ply::nz) {
+            if constexpr (HasPerFaceNormal<MeshType>) {
+                if (isPerFaceNormalAvailable(mesh)) {
+                    using Scalar = FaceType::NormalType::ScalarType;
+                    int a        = p.name - ply::nx;
+                    forEachValue(layout.offsets[k], [&](uint i, auto val) {
+                        mesh.face(i).normal()[a] = static_cast<Scalar>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name >= ply::red && p.name <= ply::alpha) {
+            if constexpr (HasPerFaceColor<MeshType>) {
+                if (isPerFaceColorAvailable(mesh)) {
+                    int a = p.name - ply::red;
+                    forEachValue(layout.offsets[k], [&](uint i, auto val) {
+                        mesh.face(i).color()[a] =
+                            static_cast<unsigned char>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name == ply::quality) {
+            if constexpr (HasPerFaceQuality<MeshType>) {
+                using QualityType = FaceType::QualityType;
+                if (isPerFaceQualityAvailable(mesh)) {
+                    forEachValue(layout.offsets[k], [&](uint i, auto val) {
+                        mesh.face(i).quality() = static_cast<QualityType>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name == ply::unknown) {
+            if constexpr (HasPerFaceCustomComponents<MeshType>) {
+                if (mesh.hasPerFaceCustomComponent(p.unknownPropertyName)) {
+                    readPlyCustomComponentRecords(
+                        data,
+                        begin,
+                        end,
+                        layout.stride,
+                        layout.offsets[k],
+                        p,
+                        endian,
+                        [&](uint i) -> FaceType& {
+                            return mesh.face(i);
+                        });
+                }
+            }
+        }
+    }
+}
+
 template<FaceMeshConcept MeshType>
 void writePlyFaces(
     std::ostream&    file,
@@ -413,6 +551,249 @@ void readPlyFaces(
     log.endProgress();
 }
 
+/**
+ * @brief Reads the faces of an ascii ply file directly from its memory mapping,
+ * starting from the current position of the stream.
+ *
+ * The lines containing the faces are split in chunks that are parsed in
+ * parallel, directly into the face container of the mesh. Since the triangles
+ * obtained by splitting a polygon are added at the end of the face container,
+ * the parallel path is taken only when all the faces of the file can be stored
+ * in the faces of the mesh without splitting them. At the end, the stream is
+ * moved after the last face line.
+ *
+ * @return false if some face of the file must be split, or if the vertex
+ * indices are preceded by another list property in the face lines: in this
+ * case nothing is read, and the faces must be read from the stream.
+ */
+template<FaceMeshConcept MeshType, LoggerConcept LogType>
+bool readPlyFacesTxtMapped(
+    std::istream&           file,
+    const MemoryMappedFile& mappedFile,
+    const PlyHeader&        header,
+    MeshType&               mesh,
+    MeshInfo&               loadedInfo,
+    LogType&                log,
+    std::size_t             chunkSize)
+{
+    using FaceType = MeshType::FaceType;
+
+    // position of the size of the vertex indices list in the face lines
+    uint listToken = 0;
+    bool found     = false;
+    for (const PlyProperty& p : header.faceProperties()) {
+        if (p.name == ply::vertex_indices) {
+            found = true;
+            break;
+        }
+        if (p.list)
+            return false;
+        ++listToken;
+    }
+    if (!found)
+        return false;
+
+    std::size_t offset = file.tellg();
+    const char* begin  = mappedFile.data() + offset;
+    std::vector<LineChunk> chunks = lineChunks(
+        begin,
+        mappedFile.data() + mappedFile.size(),
+        header.faceCount(),
+        chunkSize);
+
+    if constexpr (FaceType::VERTEX_COUNT > 0) {
+        std::atomic<bool> sameSize = true;
+        parallelForLineChunks(chunks, [&](const LineChunk& c, uint) {
+            StringViewTokenizer tokens;
+            forEachNonEmptyLine(c, [&](std::string_view line, uint) {
+                tokens.split(line);
+                if (tokens.size() <= listToken) {
+                    throw MalformedFileException("Unexpected end of line.");
+                }
+                if (parseTxtNumber<long long>(tokens[listToken]) !=
+                    FaceType::VERTEX_COUNT)
+                    sameSize = false;
+            });
+        });
+        if (!sameSize)
+            return false;
+    }
+
+    uint first = mesh.faceCount();
+    mesh.addFaces(header.faceCount());
+
+    log.startProgress("Reading faces", header.faceCount());
+
+    // each chunk stores in its own info what it reads (e.g. the type of mesh
+    // given by the size of its faces); the infos are merged at the end
+    std::vector<MeshInfo> chunkInfos(chunks.size());
+    std::atomic<uint>     processed = 0;
+    parallelForLineChunks(chunks, [&](const LineChunk& c, uint ci) {
+        StringViewTokenizer tokens;
+        forEachNonEmptyLine(c, [&](std::string_view line, uint i) {
+            tokens.split(line);
+            auto      token = tokens.begin();
+            FaceType& f     = mesh.face(first + i);
+            for (const PlyProperty& p : header.faceProperties()) {
+                if (token == tokens.end()) {
+                    throw MalformedFileException("Unexpected end of line.");
+                }
+                readPlyFaceProperty(
+                    token,
+                    mesh,
+                    f,
+                    p,
+                    chunkInfos[ci],
+                    header.isVcgGenerated(),
+                    std::endian::little,
+                    first + i + 1);
+            }
+        });
+        // progress is reported once per chunk; the logger is thread safe
+        log.progress(processed.fetch_add(c.lineCount) + c.lineCount);
+    });
+
+    for (const MeshInfo& info : chunkInfos)
+        loadedInfo.merge(info);
+
+    log.endProgress();
+
+    if (!chunks.empty())
+        file.seekg(offset + (chunks.back().end - begin));
+    return true;
+}
+
+/**
+ * @brief Reads the faces of a ply file directly from its memory mapping,
+ * starting from the current position of the stream.
+ *
+ * Ascii files are parsed in parallel by the readPlyFacesTxtMapped function.
+ *
+ * For binary files, the fast path is taken only when the vertex indices are
+ * the only list property of the faces, and all the faces have the same number
+ * of vertices that can be stored in the faces of the mesh without splitting
+ * them (e.g. triangles in a triangle mesh). In this case the face records have
+ * a fixed size and are decoded in parallel, in blocks, directly into the face
+ * container of the mesh. At the end, the stream is moved after the last face
+ * record.
+ *
+ * @return false if the fast path cannot be taken: in this case nothing is read,
+ * and the faces must be read from the stream.
+ */
+template<FaceMeshConcept MeshType, LoggerConcept LogType>
+bool readPlyFacesMapped(
+    std::istream&           file,
+    const MemoryMappedFile& mappedFile,
+    const PlyHeader&        header,
+    MeshType&               mesh,
+    MeshInfo&               loadedInfo,
+    LogType&                log,
+    std::size_t             chunkSize)
+{
+    using FaceType = MeshType::FaceType;
+
+    if (header.format() == ply::ASCII) {
+        return readPlyFacesTxtMapped(
+            file, mappedFile, header, mesh, loadedInfo, log, chunkSize);
+    }
+
+    const uint n = header.faceCount();
+    if (n == 0)
+        return false;
+
+    // position of the list of vertex indices in the records
+    const PlyProperty* lp         = nullptr;
+    uint               listOffset = 0;
+    for (const PlyProperty& p : header.faceProperties()) {
+        if (p.list) {
+            if (p.name != ply::vertex_indices || lp != nullptr)
+                return false;
+            lp = &p;
+        }
+        else if (lp == nullptr) {
+            listOffset += sizeOf(p.type);
+        }
+    }
+    if (lp == nullptr)
+        return false;
+
+    std::size_t offset = file.tellg();
+    const char* data   = mappedFile.data() + offset;
+    if (offset + listOffset + sizeOf(lp->listSizeType) > mappedFile.size())
+        return false;
+
+    std::endian end = header.format() == ply::BINARY_BIG_ENDIAN ?
+                          std::endian::big :
+                          std::endian::little;
+
+    // all the faces are expected to have the size of the first one
+    uint faceSize = 0;
+    forEachPlyRecordValue(
+        data, 0, 1, 0, listOffset, lp->listSizeType, end, [&](uint, auto val) {
+            faceSize = static_cast<uint>(val);
+        });
+    if constexpr (FaceType::VERTEX_COUNT > 0) {
+        if (faceSize != FaceType::VERTEX_COUNT)
+            return false;
+    }
+
+    PlyRecordLayout layout(header.faceProperties(), faceSize);
+    std::size_t     size = std::size_t(layout.stride) * n;
+    if (offset + size > mappedFile.size())
+        return false;
+
+    std::atomic<bool> sameSize = true;
+    parallelForBlocks(
+        n, PLY_RECORD_BLOCK_SIZE, [&](std::size_t begin, std::size_t last) {
+            forEachPlyRecordValue(
+                data,
+                begin,
+                last,
+                layout.stride,
+                listOffset,
+                lp->listSizeType,
+                end,
+                [&](uint, auto val) {
+                    if (static_cast<uint>(val) != faceSize)
+                        sameSize = false;
+                });
+        });
+    if (!sameSize)
+        return false;
+
+    loadedInfo.updateMeshType(faceSize);
+    mesh.addFaces(n);
+
+    log.startProgress("Reading faces", n);
+
+    std::atomic<uint> badFace   = UINT_NULL;
+    std::atomic<uint> processed = 0;
+    parallelForBlocks(
+        n, PLY_RECORD_BLOCK_SIZE, [&](std::size_t begin, std::size_t last) {
+            readPlyFaceRecords(
+                data,
+                begin,
+                last,
+                layout,
+                faceSize,
+                mesh,
+                end,
+                badFace,
+                header.isVcgGenerated());
+            // progress is reported once per block; the logger is thread safe
+            log.progress(processed.fetch_add(last - begin) + last - begin);
+        });
+    if (badFace != UINT_NULL) {
+        throw MalformedFileException(
+            "Bad vertex index for face " + std::to_string(badFace));
+    }
+
+    log.endProgress();
+
+    file.seekg(offset + size);
+    return true;
+}
+
 } // namespace vcl::detail
 
 #endif // VCL_IO_MESH_PLY_DETAIL_FACE_H
@@ -0,0 +1,189 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_IO_MESH_PLY_DETAIL_RECORD_LAYOUT_H
+#define VCL_IO_MESH_PLY_DETAIL_RECORD_LAYOUT_H
+
+#include "ply.h"
+
+#include <vclib/base.h>
+
+#include <cstring>
+#include <typeindex>
+#include <vector>
+
+namespace vcl::detail {
+
+// number of records decoded by each task when reading a memory mapped file
+constexpr uint PLY_RECORD_BLOCK_SIZE = 16384;
+
+/**
+ * @brief The PlyRecordLayout struct describes how the properties of an element
+ * are laid out in each record of a binary ply file.
+ *
+ * It is computed once per element, and allows to decode the records directly
+ * from a memory buffer, without going through a stream.
+ *
+ * Records have a fixed size only when the element has no list properties, or
+ * when all the lists of the element have the same (known) size: in this case
+ * the size of the record is stored in the stride member, otherwise the stride
+ * is zero.
+ */
+struct PlyRecordLayout
+{
+    std::vector<PlyProperty> properties;
+    // position in bytes of each property in a record (for lists, the position
+    // of the size of the list)
+    std::vector<uint> offsets;
+    uint              stride = 0;
+
+    PlyRecordLayout() = default;
+
+    /**
+     * @brief Computes the layout of the records of an element having the given
+     * properties.
+     *
+     * @param[in] props: the properties of the element.
+     * @param[in] listSize: the number of values of each list property of the
+     * element; if UINT_NULL, lists are considered of variable size.
+     */
+    PlyRecordLayout(
+        const std::list<PlyProperty>& props,
+        uint                          listSize = UINT_NULL) :
+            properties(props.begin(), props.end())
+    {
+        bool fixed = true;
+        uint size  = 0;
+        for (const PlyProperty& p : properties) {
+            offsets.push_back(size);
+            if (p.list) {
+                if (listSize == UINT_NULL)
+                    fixed = false;
+                else
+                    size += sizeOf(p.listSizeType) + listSize * sizeOf(p.type);
+            }
+            else {
+                size += sizeOf(p.type);
+            }
+        }
+        stride = fixed ? size : 0;
+    }
+
+    bool isFixedSize() const { return stride > 0; }
+};
+
+/**
+ * @brief Reads a value of type T stored at the given memory position, with the
+ * given endianness.
+ */
+template<typename T>
+T readPlyRecordValue(const char* data, std::endian end)
+{
+    T v;
+    std::memcpy(&v, data, sizeof(T));
+    if (end != std::endian::native)
+        v = swapEndian(v);
+    return v;
+}
+
+/**
+ * @brief Calls the function f(i, value) for each record i in [begin, end) of
+ * a fixed-size record buffer, where value is the primitive of type `type`
+ * stored at `offset` bytes from the beginning of the record.
+ *
+ * The type of the primitive is resolved once, and the value is passed to f
+ * with its original type: f is therefore expected to be a generic lambda.
+ */
+template<typename Lambda>
+void forEachPlyRecordValue(
+    const char*   data,
+    std::size_t   begin,
+    std::size_t   end,
+    uint          stride,
+    uint          offset,
+    PrimitiveType type,
+    std::endian   endian,
+    Lambda&&      f)
+{
+    auto forEach = [&]<typename T>() {
+        const char* ptr = data + begin * stride + offset;
+        for (std::size_t i = begin; i < end; ++i, ptr += stride) {
+            f(uint(i), readPlyRecordValue<T>(ptr, endian));
+        }
+    };
+
+    switch (type) {
+    case PrimitiveType::CHAR: forEach.template operator()<char>(); break;
+    case PrimitiveType::UCHAR: forEach.template operator()<uchar>(); break;
+    case PrimitiveType::SHORT: forEach.template operator()<int16_t>(); break;
+    case PrimitiveType::USHORT: forEach.template operator()<uint16_t>(); break;
+    case PrimitiveType::INT: forEach.template operator()<int32_t>(); break;
+    case PrimitiveType::UINT: forEach.template operator()<uint32_t>(); break;
+    case PrimitiveType::FLOAT: forEach.template operator()<float>(); break;
+    case PrimitiveType::DOUBLE: forEach.template operator()<double>(); break;
+    default: assert(0);
+    }
+}
+
+/**
+ * @brief Reads a custom component of the records in [begin, end) of a
+ * fixed-size record buffer. The element of each record i is returned by the
+ * function elem(i).
+ *
+ * The type of the custom component is resolved once for all the records.
+ */
+template<typename ElemFunction>
+void readPlyCustomComponentRecords(
+    const char*        data,
+    std::size_t        begin,
+    std::size_t        end,
+    uint               stride,
+    uint               offset,
+    const PlyProperty& p,
+    std::endian        endian,
+    ElemFunction&&     elem)
+{
+    const std::string& name = p.unknownPropertyName;
+
+    auto read = [&]<typename T>() {
+        forEachPlyRecordValue(
+            data,
+            begin,
+            end,
+            stride,
+            offset,
+            p.type,
+            endian,
+            [&](uint i, auto v) {
+                elem(i).template customComponent<T>(name) = static_cast<T>(v);
+            });
+    };
+
+    std::type_index ti = elem(uint(begin)).customComponentType(name);
+    if (ti == typeid(char))
+        read.template operator()<char>();
+    else if (ti == typeid(unsigned char))
+        read.template operator()<unsigned char>();
+    else if (ti == typeid(short))
+        read.template operator()<short>();
+    else if (ti == typeid(unsigned short))
+        read.template operator()<unsigned short>();
+    else if (ti == typeid(int))
+        read.template operator()<int>();
+    else if (ti == typeid(unsigned int))
+        read.template operator()<uint>();
+    else if (ti == typeid(float))
+        read.template operator()<float>();
+    else if (ti == typeid(double))
+        read.template operator()<double>();
+    else
+        assert(0);
+}
+
+} // namespace vcl::detail
+
+#endif // VCL_IO_MESH_PLY_DETAIL_RECORD_LAYOUT_H
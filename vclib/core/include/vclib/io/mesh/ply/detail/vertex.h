@@ -9,12 +9,17 @@
 #define VCL_IO_MESH_PLY_DETAIL_VERTEX_H
 
 #include "header.h"
+#include "record_layout.h"
 
+#include <vclib/io/line_chunks.h>
+#include <vclib/io/memory_mapped_file.h>
 #include <vclib/io/read.h>
 #include <vclib/io/write.h>
 
 #include <vclib/mesh.h>
 
+#include <atomic>
+
 namespace vcl::detail {
 
 template<MeshConcept MeshType, VertexConcept VertexType, typename Stream>
@@ -151,6 +156,131 @@ void readPlyVertexBin(
     }
 }
 
+template<MeshConcept MeshType>
+void readPlyVertexRecords(
+    const char*            data,
+    std::size_t            begin,
+    std::size_t            end,
+    const PlyRecordLayout& layout,
+    MeshType&              mesh,
+    std::endian            endian,
+    bool                   vcgGenerated = false)
+{
+    using VertexType = MeshType::VertexType;
+
+    for (uint k = 0; k < layout.properties.size(); ++k) {
+        const PlyProperty& p = layout.properties[k];
+
+        auto forEachValue = [&](auto&& f) {
+            forEachPlyRecordValue(
+                data,
+                begin,
+                end,
+                layout.stride,
+                layout.offsets[k],
+                p.type,
+                endian,
+                f);
+        };
+
+        if (p.name >= ply::x && p.name <= ply::z) {
+            using Scalar = VertexType::PositionType::ScalarType;
+            int a        = p.name - ply::x;
+            forEachValue([&](uint i, auto val) {
+                mesh.vertex(i).position()[a] = static_cast<Scalar>(val);
+            });
+        }
+        else if (p.name == ply::bit_flags) {
+            if (vcgGenerated) {
+                forEachValue([&](uint i, auto val) {
+                    mesh.vertex(i).importFlagsFromVCGFormat(
+                        static_cast<int>(val));
+                });
+            }
+            else {
+                using FlagsType = VertexType::FlagsType;
+                forEachValue([&](uint i, auto val) {
+                    mesh.vertex(i).setUnderlyingBitFlags(
+                        static_cast<FlagsType>(val));
+                });
+            }
+        }
+        else if (p.name >= ply::nx && p.name <= ply::nz) {
+            if constexpr (HasPerVertexNormal<MeshType>) {
+                if (isPerVertexNormalAvailable(mesh)) {
+                    using Scalar = VertexType::NormalType::ScalarType;
+                    int a        = p.name - ply::nx;
+                    forEachValue([&](uint i, auto val) {
+                        mesh.vertex(i).normal()[a] = static_cast<Scalar>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name >= ply::red && p.name <= ply::alpha) {
+            if constexpr (HasPerVertexColor<MeshType>) {
+                if (isPerVertexColorAvailable(mesh)) {
+                    int a = p.name - ply::red;
+                    forEachValue([&](uint i, auto val) {
+                        mesh.vertex(i).color()[a] =
+                            static_cast<unsigned char>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name == ply::quality) {
+            if constexpr (HasPerVertexQuality<MeshType>) {
+                using QualityType = VertexType::QualityType;
+                if (isPerVertexQualityAvailable(mesh)) {
+                    forEachValue([&](uint i, auto val) {
+                        mesh.vertex(i).quality() =
+                            static_cast<QualityType>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name >= ply::texture_u && p.name <= ply::texture_v) {
+            if constexpr (HasPerVertexTexCoord<MeshType>) {
+                using Scalar = VertexType::TexCoordType::ScalarType;
+                if (isPerVertexTexCoordAvailable(mesh)) {
+                    int a = p.name - ply::texture_u;
+                    forEachValue([&](uint i, auto val) {
+                        mesh.vertex(i).texCoord()[a] = static_cast<Scalar>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name == ply::material_index) {
+            if constexpr (HasPerVertexMaterialIndex<MeshType>) {
+                if (isPerVertexMaterialIndexAvailable(mesh)) {
+                    forEachValue([&](uint i, auto val) {
+                        mesh.vertex(i).materialIndex() =
+                            static_cast<ushort>(val);
+                    });
+                }
+            }
+        }
+        else if (p.name == ply::unknown) {
+            if constexpr (HasPerVertexCustomComponents<MeshType>) {
+                if (mesh.hasPerVertexCustomComponent(p.unknownPropertyName)) {
+                    readPlyCustomComponentRecords(
+                        data,
+                        begin,
+                        end,
+                        layout.stride,
+                        layout.offsets[k],
+                        p,
+                        endian,
+                        [&](uint i) -> VertexType& {
+                            return mesh.vertex(i);
+                        });
+                }
+            }
+        }
+        // properties that are not read are just skipped: the stride of the
+        // layout already accounts for them
+    }
+}
+
 template<MeshConcept MeshType>
 void writePlyVertices(
     std::ostream&    file,
@@ -267,6 +397,123 @@ void readPlyVertices(
     log.endProgress();
 }
 
+/**
+ * @brief Reads the vertices of an ascii ply file directly from its memory
+ * mapping, starting from the current position of the stream.
+ *
+ * The lines containing the vertices are split in chunks that are parsed in
+ * parallel, directly into the vertex container of the mesh. At the end, the
+ * stream is moved after the last vertex line.
+ */
+template<MeshConcept MeshType, LoggerConcept LogType>
+void readPlyVerticesTxtMapped(
+    std::istream&           file,
+    const MemoryMappedFile& mappedFile,
+    const PlyHeader&        header,
+    MeshType&               m,
+    LogType&                log,
+    std::size_t             chunkSize)
+{
+    std::size_t offset = file.tellg();
+    const char* begin  = mappedFile.data() + offset;
+    std::vector<LineChunk> chunks = lineChunks(
+        begin,
+        mappedFile.data() + mappedFile.size(),
+        header.vertexCount(),
+        chunkSize);
+
+    uint first = m.vertexCount();
+    m.addVertices(header.vertexCount());
+
+    log.startProgress("Reading vertices", header.vertexCount());
+
+    std::atomic<uint> processed = 0;
+    parallelForLineChunks(chunks, [&](const LineChunk& c, uint) {
+        StringViewTokenizer tokens;
+        forEachNonEmptyLine(c, [&](std::string_view line, uint i) {
+            tokens.split(line);
+            auto token = tokens.begin();
+            for (const PlyProperty& p : header.vertexProperties()) {
+                if (token == tokens.end()) {
+                    throw MalformedFileException("Unexpected end of line.");
+                }
+                readPlyVertexProperty(
+                    token, m, m.vertex(first + i), p, header.isVcgGenerated());
+            }
+        });
+        // progress is reported once per chunk; the logger is thread safe
+        log.progress(processed.fetch_add(c.lineCount) + c.lineCount);
+    });
+
+    log.endProgress();
+
+    if (!chunks.empty())
+        file.seekg(offset + (chunks.back().end - begin));
+}
+
+/**
+ * @brief Reads the vertices of a ply file directly from its memory mapping,
+ * starting from the current position of the stream.
+ *
+ * For binary files, the layout of the vertex records is computed once from
+ * the header, and the records are decoded in parallel, in blocks, directly
+ * into the vertex container of the mesh. Ascii files are parsed in parallel by
+ * the readPlyVerticesTxtMapped function. At the end, the stream is moved after
+ * the last vertex record.
+ *
+ * @return false if the vertex records of a binary file do not have a fixed
+ * size: in this case nothing is read, and the vertices must be read from the
+ * stream.
+ */
+template<MeshConcept MeshType, LoggerConcept LogType>
+bool readPlyVerticesMapped(
+    std::istream&           file,
+    const MemoryMappedFile& mappedFile,
+    const PlyHeader&        header,
+    MeshType&               m,
+    LogType&                log,
+    std::size_t             chunkSize)
+{
+    if (header.format() == ply::ASCII) {
+        readPlyVerticesTxtMapped(file, mappedFile, header, m, log, chunkSize);
+        return true;
+    }
+
+    PlyRecordLayout layout(header.vertexProperties());
+    if (!layout.isFixedSize())
+        return false;
+
+    std::size_t offset = file.tellg();
+    std::size_t size   = std::size_t(layout.stride) * header.vertexCount();
+    if (offset + size > mappedFile.size())
+        throw MalformedFileException("Unexpected end of file.");
+
+    std::endian end = header.format() == ply::BINARY_BIG_ENDIAN ?
+                          std::endian::big :
+                          std::endian::little;
+
+    m.addVertices(header.vertexCount());
+
+    log.startProgress("Reading vertices", header.vertexCount());
+
+    const char* data = mappedFile.data() + offset;
+    std::atomic<uint> processed = 0;
+    parallelForBlocks(
+        header.vertexCount(),
+        PLY_RECORD_BLOCK_SIZE,
+        [&](std::size_t begin, std::size_t last) {
+            readPlyVertexRecords(
+                data, begin, last, layout, m, end, header.isVcgGenerated());
+            // progress is reported once per block; the logger is thread safe
+            log.progress(processed.fetch_add(last - begin) + last - begin);
+        });
+
+    log.endProgress();
+
+    file.seekg(offset + size);
+    return true;
+}
+
 } // namespace vcl::detail
 
 #endif // VCL_IO_MESH_PLY_DETAIL_VERTEX_H
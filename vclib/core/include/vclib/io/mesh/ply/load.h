@@ -50,6 +50,20 @@ void loadPly(
         m.meshBasePath() = FileInfo::pathWithoutFileName(filename);
     }
 
+    // binary files loaded from the file system are also memory mapped, in
+    // order to decode vertex and face records directly from memory; ascii
+    // files are mapped only if they must be parsed in parallel
+    MemoryMappedFile mappedFile;
+    if ((header.format() != ply::ASCII || settings.parallelTextParsing) &&
+        !filename.empty()) {
+        try {
+            mappedFile.open(filename);
+        }
+        catch (const CannotOpenFileException&) {
+            // the records will be read from the stream
+        }
+    }
+
     // for logging
     std::vector<uint> eln;
     uint              sum = 0;
@@ -68,13 +82,31 @@ void loadPly(
             switch (el.type) {
             case ply::VERTEX:
                 log.startNewTask(beginPerc, endPerc, "Reading vertices");
-                readPlyVertices(file, header, m, log);
+                if (!mappedFile.isOpen() ||
+                    !readPlyVerticesMapped(
+                        file,
+                        mappedFile,
+                        header,
+                        m,
+                        log,
+                        settings.textChunkSize))
+                    readPlyVertices(file, header, m, log);
                 log.endTask("Reading vertices");
                 break;
             case ply::FACE:
                 log.startNewTask(beginPerc, endPerc, "Reading faces");
-                if constexpr (HasFaces<MeshType>)
-                    readPlyFaces(file, header, m, loadedInfo, log);
+                if constexpr (HasFaces<MeshType>) {
+                    if (!mappedFile.isOpen() ||
+                        !readPlyFacesMapped(
+                            file,
+                            mappedFile,
+                            header,
+                            m,
+                            loadedInfo,
+                            log,
+                            settings.textChunkSize))
+                        readPlyFaces(file, header, m, loadedInfo, log);
+                }
                 else
                     readPlyUnknownElement(file, header, el, log);
                 log.endTask("Reading faces");
@@ -37,6 +37,30 @@ struct LoadSettings
      * supports textures.
      */
     bool loadTextureImages = false;
+
+    /**
+     * @brief If true, txt files are memory mapped and split in chunks of lines
+     * that are parsed in parallel, without allocating a string for each read
+     * token. The per-chunk results are then merged into the mesh.
+     *
+     * It applies to the loading functions of OBJ, OFF and ascii PLY files, when
+     * they load from a file (and not from a stream).
+     *
+     * @note Some checks performed by the sequential loaders depend on the
+     * order of the lines of the file, and may be relaxed: e.g. an OBJ face can
+     * refer to vertices declared after it.
+     */
+    bool parallelTextParsing = false;
+
+    /**
+     * @brief The approximate size, in bytes, of the chunks of lines in which a
+     * txt file is split when parallelTextParsing is true. Each chunk is parsed
+     * by a single task.
+     *
+     * Smaller chunks give a better load balancing, but increase the cost of
+     * merging the per-chunk results.
+     */
+    std::size_t textChunkSize = 1 << 22;
 };
 
 /**
@@ -15,6 +15,10 @@
 #include <vclib/base.h>
 #include <vclib/mesh.h>
 
+#include <charconv>
+#include <cstdlib>
+#include <string_view>
+
 namespace vcl {
 
 namespace detail {
@@ -50,6 +54,56 @@ inline std::string readNextNonEmptyLine(std::istream& file)
     return line;
 }
 
+/**
+ * @brief Parses the number stored at the beginning of the given token, without
+ * allocating any string.
+ *
+ * It follows the semantics of std::stoi/std::stod: an optional '+' sign is
+ * accepted, and the characters following the number are ignored. If T is an
+ * integral type, the token is parsed as an integer number, otherwise as a
+ * floating point number.
+ *
+ * @throws MalformedFileException if the token does not start with a number.
+ *
+ * @tparam T: the type of the number to parse (e.g. long long or double).
+ * @param[in] token: the token to parse.
+ * @return the parsed number.
+ */
+template<typename T>
+T parseTxtNumber(std::string_view token)
+{
+    const char* first = token.data();
+    const char* last  = token.data() + token.size();
+    if (first != last && *first == '+')
+        ++first;
+
+    T    v  = 0;
+    bool ok = false;
+#ifndef __cpp_lib_to_chars
+    if constexpr (!std::integral<T>) {
+        // floating point from_chars not available: strtod needs a null
+        // terminated string
+        char        buf[64];
+        std::size_t n = std::min<std::size_t>(last - first, sizeof(buf) - 1);
+        std::copy(first, first + n, buf);
+        buf[n]    = '\0';
+        char* end = nullptr;
+        v         = static_cast<T>(std::strtod(buf, &end));
+        ok        = end != buf;
+    }
+    else
+#endif
+    {
+        auto [ptr, ec] = std::from_chars(first, last, v);
+        ok             = ec == std::errc();
+    }
+    if (!ok) {
+        throw MalformedFileException(
+            "Invalid number: " + std::string(token) + ".");
+    }
+    return v;
+}
+
 } // namespace detail
 
 /**
@@ -487,74 +541,79 @@ void readCustomComponent(
 
 // read/txt
 
-template<typename T>
-T readChar(Tokenizer::iterator& token, std::endian = std::endian::native)
+// The following functions read a primitive from a txt token, and advance the
+// token iterator. They accept the iterators of both Tokenizer and
+// StringViewTokenizer (any iterator over values convertible to a
+// std::string_view), and parse the numbers without allocating any string.
+
+template<typename T, InputIterator<std::string_view> TokenIterator>
+T readChar(TokenIterator& token, std::endian = std::endian::native)
 {
-    return std::stoi(*token++);
+    return detail::parseTxtNumber<long long>(*token++);
 }
 
-template<typename T>
-T readUChar(Tokenizer::iterator& token, std::endian = std::endian::native)
+template<typename T, InputIterator<std::string_view> TokenIterator>
+T readUChar(TokenIterator& token, std::endian = std::endian::native)
 {
-    return std::stoi(*token++);
+    return detail::parseTxtNumber<long long>(*token++);
 }
 
-template<typename T>
-T readShort(Tokenizer::iterator& token, std::endian = std::endian::native)
+template<typename T, InputIterator<std::string_view> TokenIterator>
+T readShort(TokenIterator& token, std::endian = std::endian::native)
 {
-    return std::stoi(*token++);
+    return detail::parseTxtNumber<long long>(*token++);
 }
 
-template<typename T>
-T readUShort(Tokenizer::iterator& token, std::endian = std::endian::native)
+template<typename T, InputIterator<std::string_view> TokenIterator>
+T readUShort(TokenIterator& token, std::endian = std::endian::native)
 {
-    return std::stoi(*token++);
+    return detail::parseTxtNumber<long long>(*token++);
 }
 
-template<typename T>
-T readInt(Tokenizer::iterator& token, std::endian = std::endian::native)
+template<typename T, InputIterator<std::string_view> TokenIterator>
+T readInt(TokenIterator& token, std::endian = std::endian::native)
 {
-    return std::stoi(*token++);
+    return detail::parseTxtNumber<long long>(*token++);
 }
 
-template<typename T>
-T readUInt(Tokenizer::iterator& token, std::endian = std::endian::native)
+template<typename T, InputIterator<std::string_view> TokenIterator>
+T readUInt(TokenIterator& token, std::endian = std::endian::native)
 {
-    return std::stoi(*token++);
+    return detail::parseTxtNumber<long long>(*token++);
 }
 
-template<typename T>
+template<typename T, InputIterator<std::string_view> TokenIterator>
 T readFloat(
-    Tokenizer::iterator& token,
+    TokenIterator& token,
     std::endian  = std::endian::native,
     bool isColor = false)
 {
     if (isColor && std::is_integral<T>::value) {
-        return std::stod(*token++) * 255;
+        return detail::parseTxtNumber<double>(*token++) * 255;
     }
     else {
-        return std::stod(*token++);
+        return detail::parseTxtNumber<double>(*token++);
     }
 }
 
-template<typename T>
+template<typename T, InputIterator<std::string_view> TokenIterator>
 T readDouble(
-    Tokenizer::iterator& token,
+    TokenIterator& token,
     std::endian  = std::endian::native,
     bool isColor = false)
 {
     if (isColor && std::is_integral<T>::value) {
-        return std::stod(*token++) * 255;
+        return detail::parseTxtNumber<double>(*token++) * 255;
     }
     else {
-        return std::stod(*token++);
+        return detail::parseTxtNumber<double>(*token++);
     }
 }
 
-template<typename T>
+template<typename T, InputIterator<std::string_view> TokenIterator>
 T readPrimitiveType(
-    Tokenizer::iterator& token,
-    PrimitiveType        type,
+    TokenIterator& token,
+    PrimitiveType  type,
     std::endian  = std::endian::native,
     bool isColor = false)
 {
@@ -565,14 +624,16 @@ T readPrimitiveType(
     case PrimitiveType::SHORT:
     case PrimitiveType::USHORT:
     case PrimitiveType::INT:
-    case PrimitiveType::UINT: p = std::stoi(*token++); break;
+    case PrimitiveType::UINT:
+        p = detail::parseTxtNumber<long long>(*token++);
+        break;
     case PrimitiveType::FLOAT:
     case PrimitiveType::DOUBLE:
         if (isColor) {
-            p = std::stod(*token++) * 255;
+            p = detail::parseTxtNumber<double>(*token++) * 255;
         }
         else {
-            p = std::stod(*token++);
+            p = detail::parseTxtNumber<double>(*token++);
         }
         break;
     default: assert(0); p = 0;
@@ -583,12 +644,12 @@ T readPrimitiveType(
     return p;
 }
 
-template<ElementConcept El>
+template<ElementConcept El, InputIterator<std::string_view> TokenIterator>
 void readCustomComponent(
-    Tokenizer::iterator& token,
-    El&                  elem,
-    const std::string&   cName,
-    PrimitiveType        type,
+    TokenIterator&     token,
+    El&                elem,
+    const std::string& cName,
+    PrimitiveType      type,
     std::endian = std::endian::native)
 {
     std::type_index ti = elem.customComponentType(cName);
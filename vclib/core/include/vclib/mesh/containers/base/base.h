@@ -152,6 +152,13 @@ concept HasPerElementOptionalComponent =
         typename ContainerOfElementType<ELEM_ID, MeshType>::ElementType,
         COMP_ID>;
 
+template<typename MeshType, uint ELEM_ID, uint COMP_ID>
+concept HasPerElementVerticalComponent =
+    HasElementContainer<MeshType, ELEM_ID> &&
+    comp::HasVerticalComponentOfType<
+        typename ContainerOfElementType<ELEM_ID, MeshType>::ElementType,
+        COMP_ID>;
+
 } // namespace mesh
 
 } // namespace vcl
@@ -10,8 +10,7 @@
 
 #include <vclib/base.h>
 
-#include <any>
-#include <vector>
+#include <span>
 
 namespace vcl {
 
@@ -20,11 +19,15 @@ namespace vcl {
  *
  * The class allows to access a custom component stored in a Contaner of
  * Elements without having to use the Container itself and avoiding copies, and
- * it can be used as a normal std::vector. The class stores references to the
- * custom components, therefore it allows to modify them.
+ * it can be used as a normal std::vector. The class is a view over the
+ * contiguous storage of the custom components, therefore it allows to modify
+ * them.
  *
- * It is meant to be created by a Container, that constructs it from the vector
- * of custom components and then returns it to the user.
+ * It is meant to be created by a Container, that resolves the name of the
+ * custom component and then returns the handle to the user: creating the handle
+ * and accessing the custom components through it costs the same of accessing a
+ * plain array. The underlying values are accessible as a std::span through the
+ * span() member function.
  *
  * @note A CustomComponentVectorHandle object is meant to be used to access the
  * custom components. It does not make sense to modify the size of the container
@@ -33,7 +36,7 @@ namespace vcl {
  *
  * @note If the Element Container is modified after the creation of a
  * CustomComponentVectorHandle, the CustomComponentVectorHandle is not updated
- * and still contains the old references to the custom components (that may be
+ * and still refers to the old storage of the custom components (that may be
  * invalidated).
  *
  * @tparam T: The type of the custom component.
@@ -41,81 +44,49 @@ namespace vcl {
 template<typename T>
 class CustomComponentVectorHandle
 {
-    std::vector<std::reference_wrapper<T>> mVec;
+    std::span<T> mSpan;
 
 public:
-    class Iterator : public std::vector<std::reference_wrapper<T>>::iterator
-    {
-        using Base = std::vector<std::reference_wrapper<T>>::iterator;
+    using Iterator      = T*;
+    using ConstIterator = const T*;
 
-    public:
-        using value_type = T;
-        using reference  = value_type&;
-        using pointer    = value_type*;
-
-        using Base::Base;
-
-        Iterator(Base it) : Base(it) {}
-
-        reference operator*() const { return Base::operator*().get(); }
-
-        pointer operator->() const { return &(Base::operator*().get()); }
-    };
-
-    class ConstIterator :
-            public std::vector<std::reference_wrapper<T>>::const_iterator
-    {
-        using Base = std::vector<std::reference_wrapper<T>>::const_iterator;
-
-    public:
-        using value_type = T;
-        using reference  = const value_type&;
-        using pointer    = const value_type*;
-
-        using Base::Base;
+    CustomComponentVectorHandle() {}
 
-        ConstIterator(Base it) : Base(it) {}
+    CustomComponentVectorHandle(std::span<T> cc) : mSpan(cc) {}
 
-        reference operator*() const { return Base::operator*().get(); }
+    T& at(uint i) { return mSpan[i]; }
 
-        pointer operator->() const { return &(Base::operator*().get()); }
-    };
+    const T& at(uint i) const { return mSpan[i]; }
 
-    CustomComponentVectorHandle() {}
+    T& front() { return mSpan.front(); }
 
-    CustomComponentVectorHandle(std::vector<std::any>& cc)
-    {
-        mVec.reserve(cc.size());
-        for (uint i = 0; i < cc.size(); ++i) {
-            mVec.push_back(std::any_cast<T&>(cc[i]));
-        }
-    }
+    const T& front() const { return mSpan.front(); }
 
-    T& at(uint i) { return mVec[i].get(); }
+    T& back() { return mSpan.back(); }
 
-    const T& at(uint i) const { return mVec[i].get(); }
+    const T& back() const { return mSpan.back(); }
 
-    T& front() { return mVec.begin()->get(); }
+    uint size() const { return mSpan.size(); }
 
-    const T& front() const { return mVec.begin()->get(); }
+    T* data() { return mSpan.data(); }
 
-    T& back() { return std::prev(mVec.end())->get(); }
+    const T* data() const { return mSpan.data(); }
 
-    const T& back() const { return std::prev(mVec.end())->get(); }
+    std::span<T> span() { return mSpan; }
 
-    uint size() const { return mVec.size(); }
+    std::span<const T> span() const { return mSpan; }
 
-    T& operator[](uint i) { return mVec[i].get(); }
+    T& operator[](uint i) { return mSpan[i]; }
 
-    const T& operator[](uint i) const { return mVec[i].get(); }
+    const T& operator[](uint i) const { return mSpan[i]; }
 
-    Iterator begin() { return Iterator(mVec.begin()); }
+    Iterator begin() { return mSpan.data(); }
 
-    Iterator end() { return Iterator(mVec.end()); }
+    Iterator end() { return mSpan.data() + mSpan.size(); }
 
-    ConstIterator begin() const { return ConstIterator(mVec.begin()); }
+    ConstIterator begin() const { return mSpan.data(); }
 
-    ConstIterator end() const { return ConstIterator(mVec.end()); }
+    ConstIterator end() const { return mSpan.data() + mSpan.size(); }
 };
 
 template<typename T>
@@ -12,6 +12,7 @@
 #include "custom_component_vector_handle.h"
 
 #include "../detail/custom_components_vector_map.h"
+#include "../detail/element_vector.h"
 #include "../detail/vertical_components_vector_tuple.h"
 
 #include <vclib/mesh/components/base/component.h>
@@ -21,6 +22,8 @@
 
 #include <vclib/base.h>
 
+#include <numeric>
+#include <span>
 #include <vector>
 
 namespace vcl::mesh {
@@ -47,8 +50,12 @@ public:
             ElementContainerTriggerer(other), mElemCount(other.mElemCount),
             mParentMesh(other.mParentMesh),
             mVerticalCompVecTuple(other.mVerticalCompVecTuple),
-            mCustomCompVecMap(other.mCustomCompVecMap)
+            mCustomCompVecMap(other.mCustomCompVecMap),
+            mDeletedElemIndices(other.mDeletedElemIndices)
     {
+        // keeps the storage policy of the other container
+        if (other.mElemVec.stableCapacity() > 0)
+            mElemVec.reserveStable(other.mElemVec.stableCapacity());
         mElemVec.resize(other.mElemVec.size());
         for (uint i = 0; i < mElemVec.size(); ++i) {
             mElemVec[i].rawCopyFrom(other.mElemVec[i]);
@@ -63,6 +70,7 @@ public:
         swap(mVerticalCompVecTuple, other.mVerticalCompVecTuple);
         swap(mCustomCompVecMap, other.mCustomCompVecMap);
         swap(mElemVec, other.mElemVec);
+        swap(mDeletedElemIndices, other.mDeletedElemIndices);
     }
 
     ElementContainer& operator=(ElementContainer other)
@@ -87,9 +95,11 @@ protected:
     /**
      * @brief The vector of elements: will contain the set of elements,
      * each one of these will contain the data of the horizontal components and
-     * a pointer to the parent mesh
+     * a pointer to the parent mesh. The elements are always contiguous, and
+     * they are not moved while growing if the stable storage policy has been
+     * enabled (see reserveStableElements()).
      */
-    std::vector<T> mElemVec;
+    detail::ElementVector<T> mElemVec;
 
     /**
      * @brief The tuple of vectors of all the vertical components of
@@ -105,6 +115,14 @@ protected:
     detail::CustomComponentsVectorMap<comp::HasCustomComponents<T>>
         mCustomCompVecMap;
 
+    /**
+     * @brief The indices of the elements deleted since the last compaction,
+     * used to compact the container without scanning all its elements. It is
+     * rebuilt when it is not consistent with the number of deleted elements
+     * (e.g. after importing deleted elements from another container).
+     */
+    std::vector<uint> mDeletedElemIndices;
+
 public:
     static const uint ELEMENT_ID = T::ELEMENT_ID;
 
@@ -115,8 +133,10 @@ public:
 
 protected:
     /* Members that are directly inherited by Containers (just renaming them) */
-    using ElementIterator      = ElementContainerIterator<std::vector, T>;
-    using ConstElementIterator = ConstElementContainerIterator<std::vector, T>;
+    using ElementIterator =
+        ElementContainerIterator<detail::ElementVector, T>;
+    using ConstElementIterator =
+        ConstElementContainerIterator<detail::ElementVector, T>;
 
     /**
      * @brief Returns a const reference of the element at the i-th position in
@@ -244,6 +264,7 @@ protected:
     {
         mElemVec.clear();
         mElemCount = 0;
+        mDeletedElemIndices.clear();
 
         // clear vertical and custom components
 
@@ -311,25 +332,69 @@ protected:
         }
     }
 
+    /**
+     * @brief Enables the stable storage policy of the container, making sure
+     * that the elements are not moved in memory while the number of elements
+     * in the container (deleted ones included) does not exceed `size`.
+     *
+     * The address space for `size` elements is reserved, but the memory is
+     * allocated only when the container grows. Therefore, `size` can be an
+     * upper bound much larger than the actual number of elements: pointers to
+     * the elements stay valid while adding elements, and no reference update
+     * is needed.
+     *
+     * @param[in] size: the number of elements that can be stored without moving
+     * them in memory.
+     */
+    void reserveStableElements(uint size)
+    {
+        T* oldB = mElemVec.data();
+        mElemVec.reserveStable(size);
+        T* newB = mElemVec.data();
+
+        if (oldB != newB && !mElemVec.empty()) {
+            setParentMeshPointers(mParentMesh);
+            mParentMesh->updateAllReferences(oldB);
+        }
+    }
+
     /**
      * @brief Compacts the element container, keeping only the non-deleted
      * elements.
      *
+     * If preserveOrder is true, the non-deleted elements keep their relative
+     * order. Otherwise, the holes left by the deleted elements are filled
+     * by moving the last non-deleted elements of the container: only the
+     * elements stored after the new end of the container are moved, and the
+     * cost of the compaction (excluding the update of the references) is
+     * proportional to the number of deleted elements instead of the size of
+     * the container.
+     *
+     * @param[in] preserveOrder: if true, the order of the non-deleted elements
+     * is preserved.
      * @return a vector that tells, for each old element index, the new index of
      * the element. Will contain UINT_NULL if the element has been deleted.
      */
-    std::vector<uint> compactElements()
+    std::vector<uint> compactElements(bool preserveOrder = true)
     {
-        std::vector<uint> newIndices = elementCompactIndices();
-        if (elementCount() != elementContainerSize()) {
+        if (elementCount() == elementContainerSize())
+            return elementCompactIndices();
+
+        std::vector<uint> newIndices;
+        if (preserveOrder) {
+            newIndices = elementCompactIndices();
             compactVector(mElemVec, newIndices);
 
             mVerticalCompVecTuple.compact(newIndices);
             if constexpr (comp::HasCustomComponents<T>)
                 mCustomCompVecMap.compact(newIndices);
-
-            updateElementReferences(newIndices);
         }
+        else {
+            newIndices = fillHolesWithLastElements();
+        }
+        mDeletedElemIndices.clear();
+
+        updateElementReferences(newIndices);
         return newIndices;
     }
 
@@ -353,6 +418,7 @@ protected:
         assert(i < mElemVec.size());
         mElemVec[i].deletedBit() = true;
         --mElemCount;
+        mDeletedElemIndices.push_back(i);
     }
 
     /**
@@ -444,23 +510,84 @@ protected:
      */
     void append(const ElementContainer<T>& other)
     {
-        using Comps = T::Components;
-
         uint on = other.elementContainerSize();
         uint n  = elementContainerSize();
         addElements(on);
-        for (uint i = 0; i < on; ++i) {
+        copyElementsFrom(n, other);
+        mElemCount -= on - other.elementCount();
+    }
+
+    /**
+     * @brief Appends the elements of the given container to this one, moving
+     * them. The other container is left empty.
+     *
+     * If this container is empty, and the two containers have the same
+     * enabled optional components and the same custom components, the storage
+     * of the other container is taken by this container without moving any
+     * element. Otherwise, the elements and their vertical components are moved
+     * at the end of this container.
+     *
+     * As for append(const ElementContainer&), this function does not update
+     * the pointers contained in the element container.
+     *
+     * @param[in] other: the container from which take the elements.
+     */
+    void append(ElementContainer<T>&& other)
+    {
+        if (mElemVec.empty() && mElemVec.stableCapacity() == 0 &&
+            hasSameComponentLayout(other)) {
+            using std::swap;
+            swap(mElemCount, other.mElemCount);
+            swap(mVerticalCompVecTuple, other.mVerticalCompVecTuple);
+            swap(mCustomCompVecMap, other.mCustomCompVecMap);
+            swap(mElemVec, other.mElemVec);
+            swap(mDeletedElemIndices, other.mDeletedElemIndices);
+            setParentMeshPointers(mParentMesh);
+        }
+        else {
+            uint on = other.elementContainerSize();
+            uint n  = elementContainerSize();
+            addElements(on);
+            for (uint i = 0; i < on; ++i) {
+                // move everything from the other elements, also the (not
+                // updated) pointers
+                element(n + i) = std::move(other.element(i));
+                element(n + i).setParentMesh(mParentMesh);
+            }
+            appendVerticalComponents(n, std::move(other), VertComps());
+            appendCustomComponents(n, other);
+            mElemCount -= on - other.elementCount();
+        }
+        other.clearElements();
+    }
+
+    /**
+     * @brief Copies the elements of the given container, with their vertical
+     * and custom components, in the positions [first, first + n) of this
+     * container, where n is the size of the other container.
+     *
+     * The elements in the destination positions must already exist. The
+     * function does not update the pointers contained in the copied elements,
+     * and does not update the number of elements of the container: the deleted
+     * elements of the other container are copied as deleted elements, and it
+     * is up to the caller to update the element count accordingly.
+     *
+     * Different ranges of this container can be filled concurrently.
+     *
+     * @param[in] first: the index of the first element to fill.
+     * @param[in] other: the container from which copy the elements.
+     */
+    void copyElementsFrom(uint first, const ElementContainer<T>& other)
+    {
+        for (uint i = 0; i < other.elementContainerSize(); ++i) {
             // copy everything from the other elements, also the (not updated)
             // pointers:
-            if (other.element(i).deleted()) {
-                deleteElement(n + i);
-            }
-            element(n + i).rawCopyFrom(other.element(i));
-            element(n + i).setParentMesh(mParentMesh);
+            element(first + i).rawCopyFrom(other.element(i));
+            element(first + i).setParentMesh(mParentMesh);
         }
         // importing also optional, vertical and custom components:
-        appendVerticalComponents(other, VertComps());
-        appendCustomComponents(other);
+        appendVerticalComponents(first, other, VertComps());
+        appendCustomComponents(first, other);
     }
 
     /**
@@ -778,6 +905,25 @@ protected:
         }
     }
 
+    template<uint COMP_ID>
+    auto componentSpan() requires comp::HasVerticalComponentOfType<T, COMP_ID>
+    {
+        using C = comp::ComponentOfType<COMP_ID, typename T::Components>;
+
+        assert(isComponentAvailable<COMP_ID>());
+        return std::span(mVerticalCompVecTuple.template vector<C>());
+    }
+
+    template<uint COMP_ID>
+    auto componentSpan() const
+        requires comp::HasVerticalComponentOfType<T, COMP_ID>
+    {
+        using C = comp::ComponentOfType<COMP_ID, typename T::Components>;
+
+        assert(isComponentAvailable<COMP_ID>());
+        return std::span(mVerticalCompVecTuple.template vector<C>());
+    }
+
     template<typename C>
     bool isOptionalComponentEnabled() const
     {
@@ -885,20 +1031,16 @@ protected:
     CustomComponentVectorHandle<K> customComponentVectorHandle(
         const std::string& name) requires comp::HasCustomComponents<T>
     {
-        std::vector<std::any>& cc =
-            mCustomCompVecMap.template componentVector<K>(name);
-        CustomComponentVectorHandle<K> v(cc);
-        return v;
+        return CustomComponentVectorHandle<K>(
+            mCustomCompVecMap.template componentVector<K>(name));
     }
 
     template<typename K>
     ConstCustomComponentVectorHandle<K> customComponentVectorHandle(
         const std::string& name) const requires comp::HasCustomComponents<T>
     {
-        const std::vector<std::any>& cc =
-            mCustomCompVecMap.template componentVector<K>(name);
-        ConstCustomComponentVectorHandle<K> v(cc);
-        return cc;
+        return ConstCustomComponentVectorHandle<K>(
+            mCustomCompVecMap.template componentVector<K>(name));
     }
 
     template<typename K>
@@ -934,12 +1076,17 @@ protected:
     void updateReferences(
         const Element* oldBase,
         uint           firstElementToProcess = 0,
-        uint           offset                = 0)
+        uint           offset                = 0,
+        uint           endElementToProcess   = UINT_NULL)
     {
         using Comps = T::Components;
 
         updateReferencesOnComponents(
-            oldBase, Comps(), firstElementToProcess, offset);
+            oldBase,
+            Comps(),
+            firstElementToProcess,
+            offset,
+            endElementToProcess);
     }
 
     template<typename Element>
@@ -1042,15 +1189,67 @@ protected:
     }
 
 private:
+    /*
+     * Moves the last non-deleted elements of the container (and their vertical
+     * components) in the positions of the deleted elements that are before the
+     * new end of the container, and then shrinks the container.
+     *
+     * Returns the vector that tells, for each old element index, the new index
+     * of the element (UINT_NULL for the deleted elements).
+     */
+    std::vector<uint> fillHolesWithLastElements()
+    {
+        const uint size    = elementContainerSize();
+        const uint newSize = elementCount();
+
+        // rebuild the deleted indices if they are not consistent
+        if (mDeletedElemIndices.size() != size - newSize) {
+            mDeletedElemIndices.clear();
+            for (uint i = 0; i < size; ++i) {
+                if (mElemVec[i].deleted())
+                    mDeletedElemIndices.push_back(i);
+            }
+        }
+
+        std::vector<uint> newIndices(size);
+        std::iota(newIndices.begin(), newIndices.end(), 0);
+        for (uint i : mDeletedElemIndices) {
+            newIndices[i] = UINT_NULL;
+        }
+
+        // the number of holes before newSize is equal to the number of
+        // non-deleted elements after newSize
+        uint last = size;
+        for (uint i : mDeletedElemIndices) {
+            if (i < newSize) {
+                do {
+                    --last;
+                } while (mElemVec[last].deleted());
+
+                mElemVec[i] = std::move(mElemVec[last]);
+                swapVerticalComponents(i, last);
+                newIndices[last] = i;
+            }
+        }
+
+        mElemVec.resize(newSize);
+        mVerticalCompVecTuple.resize(newSize);
+        if constexpr (comp::HasCustomComponents<T>)
+            mCustomCompVecMap.resize(newSize);
+
+        return newIndices;
+    }
+
     template<typename ElPtr, typename... Comps>
     void updateReferencesOnComponents(
         const ElPtr* oldBase,
         TypeWrapper<Comps...>,
         uint firstElementToProcess = 0,
-        uint offset                = 0)
+        uint offset                = 0,
+        uint endElementToProcess   = UINT_NULL)
     {
         (updateReferencesOnComponent<Comps>(
-             oldBase, firstElementToProcess, offset),
+             oldBase, firstElementToProcess, offset, endElementToProcess),
          ...);
     }
 
@@ -1074,18 +1273,24 @@ private:
      * ElPtr elements that have been appended (the offset that must be added
      * to the newBase w.r.t. the oldBase that was the other container from which
      * the elements have been copied).
+     *
+     * endElementToProcess limits the processed elements when several meshes
+     * are appended at once: UINT_NULL means up to the end of the container.
      */
     template<typename Comp, typename ElPtr>
     void updateReferencesOnComponent(
         const ElPtr* oldBase,
         uint         firstElementToProcess = 0,
-        uint         offset                = 0)
+        uint         offset                = 0,
+        uint         endElementToProcess   = UINT_NULL)
     {
         if constexpr (comp::HasReferencesOfType<Comp, ElPtr>) {
+            const uint end =
+                std::min(endElementToProcess, elementContainerSize());
+
             // lambda to avoid code duplication
             auto loop = [&]() {
-                for (uint i = firstElementToProcess; i < elementContainerSize();
-                     i++) {
+                for (uint i = firstElementToProcess; i < end; i++) {
                     T& e = element(i);
                     if (!e.deleted()) {
                         e.Comp::updateReferences(oldBase, offset);
@@ -1123,47 +1328,58 @@ private:
         }
     }
 
-    template<typename... Comps>
+    // true if the vertical and custom components of the two containers are
+    // stored in the same way
+    bool hasSameComponentLayout(const ElementContainer<T>& other) const
+    {
+        bool same = mVerticalCompVecTuple.hasSameEnabledComponents(
+            other.mVerticalCompVecTuple);
+        if constexpr (comp::HasCustomComponents<T>) {
+            same =
+                same && mCustomCompVecMap.hasSameComponents(
+                            other.mCustomCompVecMap);
+        }
+        return same;
+    }
+
+    // the vertical components of other are copied, or moved if other is an
+    // rvalue, starting from the position first
+    template<typename Container, typename... Comps>
     void appendVerticalComponents(
-        const ElementContainer<T>& other,
+        uint        first,
+        Container&& other,
         TypeWrapper<Comps...>)
     {
-        (appendVerticalComponent<Comps>(other), ...);
+        (appendVerticalComponent<Comps>(first, std::forward<Container>(other)),
+         ...);
     }
 
-    template<typename Comp>
-    void appendVerticalComponent(const ElementContainer<T>& other)
+    template<typename Comp, typename Container>
+    void appendVerticalComponent(uint first, Container&& other)
     {
         uint on = other.elementContainerSize();
-        uint n  = elementContainerSize() - on;
 
         if (mVerticalCompVecTuple.template isComponentEnabled<Comp>() &&
             other.mVerticalCompVecTuple.template isComponentEnabled<Comp>()) {
-            auto&       vc = mVerticalCompVecTuple.template vector<Comp>();
-            const auto& ovc =
-                other.mVerticalCompVecTuple.template vector<Comp>();
+            auto& vc  = mVerticalCompVecTuple.template vector<Comp>();
+            auto& ovc = other.mVerticalCompVecTuple.template vector<Comp>();
 
             for (uint i = 0; i < on; ++i) {
-                vc[n + i] = ovc[i];
+                if constexpr (std::is_lvalue_reference_v<Container>)
+                    vc[first + i] = ovc[i];
+                else
+                    vc[first + i] = std::move(ovc[i]);
             }
         }
     }
 
-    void appendCustomComponents(const ElementContainer<T>& other)
+    void appendCustomComponents(uint first, const ElementContainer<T>& other)
     {
         if constexpr (comp::HasCustomComponents<T>) {
             uint on = other.elementContainerSize();
-            uint n  = elementContainerSize() - on;
-
-            std::vector<std::string> ccNames =
-                mCustomCompVecMap.allComponentNames();
 
-            for (const std::string& name : ccNames) {
-                for (uint i = 0; i < on; ++i) {
-                    mCustomCompVecMap.importSameCustomComponentFrom(
-                        n + i, i, name, other.mCustomCompVecMap);
-                }
-            }
+            mCustomCompVecMap.importSameCustomComponentsFrom(
+                first, 0, on, other.mCustomCompVecMap);
         }
     }
 
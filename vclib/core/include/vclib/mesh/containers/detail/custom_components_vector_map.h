@@ -12,7 +12,9 @@
 
 #include <vclib/base.h>
 
-#include <any>
+#include <algorithm>
+#include <memory>
+#include <span>
 #include <string>
 #include <typeindex>
 #include <unordered_map>
@@ -20,6 +22,141 @@
 
 namespace vcl::mesh::detail {
 
+/**
+ * @brief Type erased interface of a vector of custom components.
+ *
+ * It exposes the operations that a CustomComponentsVectorMap must apply to all
+ * its vectors without knowing their types (resize, compaction, swap of
+ * elements...). The values are stored contiguously by the derived
+ * CustomComponentVector class, that knows their type.
+ */
+class CustomComponentVectorBase
+{
+public:
+    virtual ~CustomComponentVectorBase() = default;
+
+    virtual std::unique_ptr<CustomComponentVectorBase> clone() const = 0;
+
+    virtual std::type_index type() const = 0;
+
+    virtual uint size() const = 0;
+
+    virtual void reserve(uint size) = 0;
+
+    virtual void resize(uint size) = 0;
+
+    virtual void compact(const std::vector<uint>& newIndices) = 0;
+
+    virtual void swapElements(uint i, uint j) = 0;
+
+    // copies the values [otherFirst, otherFirst + n) of other, that must have
+    // the same type, in the positions [thisFirst, thisFirst + n)
+    virtual void importFrom(
+        uint                             thisFirst,
+        uint                             otherFirst,
+        uint                             n,
+        const CustomComponentVectorBase& other) = 0;
+};
+
+/**
+ * @brief Contiguous vector of custom components of type T.
+ *
+ * Values are value initialized when the vector is resized, and are accessed
+ * through a std::span, without any cast or indirection.
+ *
+ * @tparam T: the type of the custom component.
+ */
+template<typename T>
+class CustomComponentVector : public CustomComponentVectorBase
+{
+    // std::vector<bool> does not store bools contiguously, therefore bools are
+    // stored as wrappers having the same layout of a bool
+    struct BoolWrapper
+    {
+        bool value = false;
+    };
+
+    static_assert(sizeof(BoolWrapper) == sizeof(bool));
+
+    using StorageType =
+        std::conditional_t<std::is_same_v<T, bool>, BoolWrapper, T>;
+
+    std::vector<StorageType> mVec;
+
+public:
+    CustomComponentVector(uint size = 0) : mVec(size) {}
+
+    std::unique_ptr<CustomComponentVectorBase> clone() const override
+    {
+        return std::make_unique<CustomComponentVector<T>>(*this);
+    }
+
+    std::type_index type() const override { return typeid(T); }
+
+    uint size() const override { return mVec.size(); }
+
+    void reserve(uint size) override { mVec.reserve(size); }
+
+    void resize(uint size) override { mVec.resize(size); }
+
+    void compact(const std::vector<uint>& newIndices) override
+    {
+        compactVector(mVec, newIndices);
+    }
+
+    void swapElements(uint i, uint j) override
+    {
+        std::swap(mVec[i], mVec[j]);
+    }
+
+    void importFrom(
+        uint                             thisFirst,
+        uint                             otherFirst,
+        uint                             n,
+        const CustomComponentVectorBase& other) override
+    {
+        const auto& ov = static_cast<const CustomComponentVector<T>&>(other);
+        std::copy_n(
+            ov.mVec.begin() + otherFirst, n, mVec.begin() + thisFirst);
+    }
+
+    std::span<T> span()
+    {
+        return std::span<T>(reinterpret_cast<T*>(mVec.data()), mVec.size());
+    }
+
+    std::span<const T> span() const
+    {
+        return std::span<const T>(
+            reinterpret_cast<const T*>(mVec.data()), mVec.size());
+    }
+
+    void serialize(std::ostream& os) const
+    {
+        std::size_t size = mVec.size();
+        vcl::serialize(os, size);
+        for (const T& e : span()) {
+            if constexpr (Serializable<T>)
+                e.serialize(os);
+            else
+                vcl::serialize(os, e);
+        }
+    }
+
+    void deserialize(std::istream& is)
+    {
+        std::size_t size;
+        vcl::deserialize(is, size);
+        mVec.resize(size);
+        for (T& e : span()) {
+            if constexpr (Serializable<T>)
+                e.deserialize(is);
+            else
+                vcl::deserialize(is, e);
+        }
+    }
+};
+
 /**
  * @brief The CustomComponentsVectorMap class stores a map of vectors of custom
  * components.
@@ -33,9 +170,12 @@ namespace vcl::mesh::detail {
  * The class allows to access to the vectors of custom components trough their
  * name and type.
  *
- * For each custom component, the class stores a vector of std::any, that
- * allows to store any type of data. The actual type of the data stored in the
- * vectors is required to access to the vector data.
+ * For each custom component, the class stores a CustomComponentVector of the
+ * type of the component, behind the type erased CustomComponentVectorBase
+ * interface. The values of each custom component are therefore stored
+ * contiguously, and can be accessed through a std::span once the name has been
+ * resolved. The actual type of the data stored in the vectors is required to
+ * access to the vector data.
  *
  * @note This class is templated over a boolean value that enables the
  * functionalities of the class. If a CustomComponentsVectorMap<false> is
@@ -56,26 +196,46 @@ class CustomComponentsVectorMap<true>
 {
     // the actual map containing, for each name of a custom component, the
     // vector of values (a value for each element(vertex/face...) of the mesh)
-    std::unordered_map<std::string, std::vector<std::any>> mMap;
-    // map that stores if some custom components need to be initialized.
-    // this happens when we resize the container of an element: we need to
-    // resize also the vectors of the custom components, but we cannot
-    // initialize them with the right type (because we don't know it in resize
-    // phase). The initialization will be made when the type is known (get of
-    // the custom component vector).
-    mutable std::unordered_map<std::string, bool> mNeedToInitialize;
-    // types used for each custom component
-    std::unordered_map<std::string, std::type_index> mCompType;
+    std::unordered_map<std::string, std::unique_ptr<CustomComponentVectorBase>>
+        mMap;
 
 public:
+    CustomComponentsVectorMap() = default;
+
+    CustomComponentsVectorMap(const CustomComponentsVectorMap& other)
+    {
+        for (const auto& [name, vec] : other.mMap) {
+            mMap.emplace(name, vec->clone());
+        }
+    }
+
+    CustomComponentsVectorMap(CustomComponentsVectorMap&& other) = default;
+
+    CustomComponentsVectorMap& operator=(CustomComponentsVectorMap other)
+    {
+        mMap.swap(other.mMap);
+        return *this;
+    }
+
     /**
      * @brief Removes all the custom component vectors stored in the mMap.
      */
-    void clear()
+    void clear() { mMap.clear(); }
+
+    /**
+     * @brief Returns true if this and the other map contain custom components
+     * having the same names and types.
+     */
+    bool hasSameComponents(const CustomComponentsVectorMap& other) const
     {
-        mMap.clear();
-        mNeedToInitialize.clear();
-        mCompType.clear();
+        if (mMap.size() != other.mMap.size())
+            return false;
+        for (const auto& [name, vec] : mMap) {
+            auto it = other.mMap.find(name);
+            if (it == other.mMap.end() || it->second->type() != vec->type())
+                return false;
+        }
+        return true;
     }
 
     /**
@@ -85,27 +245,22 @@ public:
     void reserve(uint size)
     {
         for (auto& p : mMap) {
-            p.second.reserve(size);
+            p.second->reserve(size);
         }
     }
 
     /**
      * @brief For each custom component vector, it resizes the vector to the
      * given size.
+     *
+     * The new values are value initialized.
+     *
      * @param[in] size: the size to reserve for each custom component vector.
      */
     void resize(uint size)
     {
         for (auto& p : mMap) {
-            // At this call, we don't know statically the types of each custom
-            // component, therefore we cannot initialize them (std::any of each
-            // vector will be in an invalid state). Therefore, we mark all the
-            // resized custom components as 'needToInitialize'. Initiaization
-            // will be made just on the uninitialized values of the vectors at
-            // the first access of each custom component.
-            if (p.second.size() < size)
-                mNeedToInitialize.at(p.first) = true;
-            p.second.resize(size);
+            p.second->resize(size);
         }
     }
 
@@ -124,14 +279,14 @@ public:
     void compact(const std::vector<uint>& newIndices)
     {
         for (auto& p : mMap) {
-            compactVector(p.second, newIndices);
+            p.second->compact(newIndices);
         }
     }
 
     void swapCustomComponents(uint i, uint j)
     {
         for (auto& p : mMap) {
-            std::swap(p.second[i], p.second[j]);
+            p.second->swapElements(i, j);
         }
     }
 
@@ -151,10 +306,7 @@ public:
     template<typename CompType>
     void addNewComponent(const std::string& name, uint size)
     {
-        std::vector<std::any>& v = mMap[name];
-        v.resize(size, CompType());
-        mNeedToInitialize[name] = false;
-        mCompType.emplace(name, typeid(CompType));
+        mMap[name] = std::make_unique<CustomComponentVector<CompType>>(size);
     }
 
     /**
@@ -162,12 +314,7 @@ public:
      * It does nothing if the element does not exist.
      * @param[in] name: the name of the custom component vector to delete.
      */
-    void deleteComponent(const std::string& name)
-    {
-        mMap.erase(name);
-        mNeedToInitialize.erase(name);
-        mCompType.erase(name);
-    }
+    void deleteComponent(const std::string& name) { mMap.erase(name); }
 
     /**
      * @brief Asserts that the compName component exists.
@@ -218,7 +365,7 @@ public:
     {
         std::type_index t(typeid(CompType));
 
-        return t == mCompType.at(compName);
+        return t == componentType(compName);
     }
 
     /**
@@ -232,7 +379,7 @@ public:
      */
     std::type_index componentType(const std::string& compName) const
     {
-        return mCompType.at(compName);
+        return mMap.at(compName)->type();
     }
 
     /**
@@ -248,83 +395,72 @@ public:
     {
         std::vector<std::string> names;
         std::type_index          t(typeid(CompType));
-        for (const auto& p : mCompType) {
-            if (p.second == t)
+        for (const auto& p : mMap) {
+            if (p.second->type() == t)
                 names.push_back(p.first);
         }
         return names;
     }
 
     /**
-     * @brief Returns a const reference of std::vector<std::any> of the custom
-     * component with the given name and the given template argument CompType.
+     * @brief Returns a const span of the values of the custom component with
+     * the given name and the given template argument CompType.
      *
      * If the CompType does not mach with the type associated with compName,
      * thows a vcl::BadCustomComponentTypeException.
      *
      * @tparam CompType: the type of the custom component to return.
      * @param[in] compName: the name of the custom component to return.
-     * @return a const reference of std::vector<std::any> of the custom
-     * component with the given name and the given template argument CompType.
+     * @return a const span of the values of the custom component with the
+     * given name and the given template argument CompType.
      */
     template<typename CompType>
-    const std::vector<std::any>& componentVector(
+    std::span<const CompType> componentVector(
         const std::string& compName) const
     {
-        checkComponentType<CompType>(compName);
-        std::vector<std::any>& v =
-            const_cast<std::vector<std::any>&>(mMap.at(compName));
-        // if the component needs to be initialized (e.g. we made a resize)
-        if (mNeedToInitialize.at(compName)) {
-            for (std::any& a : v) {
-                if (!a.has_value())
-                    a = CompType();
-            }
-            mNeedToInitialize.at(compName) = false;
-        }
-        return v;
+        return typedVector<std::remove_const_t<CompType>>(compName).span();
     }
 
     /**
-     * @brief Returns a reference of std::vector<std::any> of the custom
-     * component with the given name and the given template argument CompType.
+     * @brief Returns a span of the values of the custom component with the
+     * given name and the given template argument CompType.
      *
      * If the CompType does not mach with the type associated with compName,
-     * thows a vcl::BadCustomComponentTypeException.
+     * thows a vcl::BadCustomComponentTypeException. CompType can be const
+     * qualified, to get a span of const values.
      *
-     * This function will initialize all the uninitialized values of the
-     * accessed custom component.
+     * The span is invalidated when the container of the elements is resized.
      *
      * @tparam CompType: the type of the custom component to return.
      * @param[in] compName: the name of the custom component to return.
-     * @return a reference of std::vector<std::any> of the custom component
-     * with the given name and the given template argument CompType.
+     * @return a span of the values of the custom component with the given
+     * name and the given template argument CompType.
      */
     template<typename CompType>
-    std::vector<std::any>& componentVector(const std::string& compName)
+    std::span<CompType> componentVector(const std::string& compName)
     {
-        checkComponentType<CompType>(compName);
-        std::vector<std::any>& v = mMap.at(compName);
-        // if the component needs to be initialized (e.g. we made a resize)
-        if (mNeedToInitialize.at(compName)) {
-            for (std::any& a : v) {
-                if (!a.has_value())
-                    a = CompType();
-            }
-            mNeedToInitialize.at(compName) = false;
-        }
-        return v;
+        return typedVector<std::remove_const_t<CompType>>(compName).span();
     }
 
-    void importSameCustomComponentFrom(
-        uint                                   thisPos,
-        uint                                   otherPos,
-        const std::string&                     compName,
+    /**
+     * @brief For each custom component of this map, copies the values of the
+     * custom component having the same name and type in the other map, in the
+     * range [otherFirst, otherFirst + n), to the range [thisFirst, thisFirst +
+     * n) of this map.
+     *
+     * Custom components that do not exist in the other map, or that have a
+     * different type, are left unchanged.
+     */
+    void importSameCustomComponentsFrom(
+        uint                                   thisFirst,
+        uint                                   otherFirst,
+        uint                                   n,
         const CustomComponentsVectorMap<true>& other)
     {
-        if (other.componentExists(compName) && componentExists(compName)) {
-            if (other.componentType(compName) == componentType(compName)) {
-                mMap.at(compName)[thisPos] = other.mMap.at(compName)[otherPos];
+        for (auto& [name, vec] : mMap) {
+            auto it = other.mMap.find(name);
+            if (it != other.mMap.end() && it->second->type() == vec->type()) {
+                vec->importFrom(thisFirst, otherFirst, n, *it->second);
             }
         }
     }
@@ -336,10 +472,11 @@ public:
             allComponentNamesOfType<CompType>();
         vcl::serialize(os, compNames);
         for (const auto& name : compNames) {
-            bool b = mNeedToInitialize.at(name);
+            // values are always initialized: the flag is kept for
+            // compatibility with the serialization format
+            bool b = false;
             vcl::serialize(os, b);
-            const std::vector<std::any>& v = componentVector<CompType>(name);
-            vcl::serialize<CompType>(os, v);
+            typedVector<CompType>(name).serialize(os);
         }
     }
 
@@ -351,24 +488,40 @@ public:
         for (const auto& name : compNames) {
             bool b;
             vcl::deserialize(is, b);
-            std::vector<std::any> v;
-            vcl::deserialize<CompType>(is, v);
-            mMap[name]              = v;
-            mNeedToInitialize[name] = b;
-            mCompType.emplace(name, typeid(CompType));
+            auto v = std::make_unique<CustomComponentVector<CompType>>();
+            v->deserialize(is);
+            mMap[name] = std::move(v);
         }
     }
 
 private:
     template<typename CompType>
-    void checkComponentType(const std::string& compName) const
+    const CustomComponentVector<CompType>& typedVector(
+        const std::string& compName) const
+    {
+        const CustomComponentVectorBase& v = *mMap.at(compName);
+        checkComponentType<CompType>(compName, v);
+        return static_cast<const CustomComponentVector<CompType>&>(v);
+    }
+
+    template<typename CompType>
+    CustomComponentVector<CompType>& typedVector(const std::string& compName)
+    {
+        CustomComponentVectorBase& v = *mMap.at(compName);
+        checkComponentType<CompType>(compName, v);
+        return static_cast<CustomComponentVector<CompType>&>(v);
+    }
+
+    template<typename CompType>
+    void checkComponentType(
+        const std::string&               compName,
+        const CustomComponentVectorBase& v) const
     {
         std::type_index t(typeid(CompType));
-        if (t != mCompType.at(compName)) {
+        if (t != v.type()) {
             throw BadCustomComponentTypeException(
-                "Expected type " + std::string(mCompType.at(compName).name()) +
-                " for " + compName + ", but was " + std::string(t.name()) +
-                ".");
+                "Expected type " + std::string(v.type().name()) + " for " +
+                compName + ", but was " + std::string(t.name()) + ".");
         }
     }
 };
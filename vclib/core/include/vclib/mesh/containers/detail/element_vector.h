@@ -0,0 +1,324 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_MESH_CONTAINERS_DETAIL_ELEMENT_VECTOR_H
+#define VCL_MESH_CONTAINERS_DETAIL_ELEMENT_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace vcl::mesh::detail {
+
+/*
+ * Functions that reserve a range of virtual addresses without backing it with
+ * memory, and then commit (make usable) a prefix of the range.
+ */
+
+inline std::size_t virtualMemoryPageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwPageSize;
+#else
+    return sysconf(_SC_PAGESIZE);
+#endif
+}
+
+inline void* reserveVirtualMemory(std::size_t bytes)
+{
+#ifdef _WIN32
+    void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS);
+    if (p == nullptr)
+        throw std::bad_alloc();
+#else
+    void* p = mmap(
+        nullptr,
+        bytes,
+        PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+        -1,
+        0);
+    if (p == MAP_FAILED)
+        throw std::bad_alloc();
+#endif
+    return p;
+}
+
+inline void commitVirtualMemory(void* p, std::size_t bytes)
+{
+#ifdef _WIN32
+    if (VirtualAlloc(p, bytes, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+        throw std::bad_alloc();
+#else
+    if (mprotect(p, bytes, PROT_READ | PROT_WRITE) != 0)
+        throw std::bad_alloc();
+#endif
+}
+
+inline void releaseVirtualMemory(void* p, std::size_t bytes)
+{
+#ifdef _WIN32
+    (void) bytes;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, bytes);
+#endif
+}
+
+/**
+ * @brief The ElementVector class is the contiguous storage of the elements of
+ * an ElementContainer.
+ *
+ * It behaves like a std::vector, with an optional stable storage policy,
+ * enabled by calling reserveStable(). The policy reserves a range of virtual
+ * addresses large enough for the given number of elements, without allocating
+ * memory: the memory is committed page by page while the vector grows. The
+ * elements are therefore never moved while the size of the vector does not
+ * exceed the reserved one, and the pointers to the elements stay valid.
+ *
+ * The elements are always contiguous: the index of an element is computed from
+ * its address in constant time, as for a std::vector.
+ *
+ * @tparam T: the type of the elements.
+ */
+template<typename T>
+class ElementVector
+{
+    T*          mData     = nullptr;
+    std::size_t mSize     = 0;
+    std::size_t mCapacity = 0;
+
+    // number of elements for which the virtual address space has been
+    // reserved; zero if the elements are stored in the heap
+    std::size_t mReserved = 0;
+
+public:
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+    ElementVector() = default;
+
+    ElementVector(const ElementVector& other)
+    {
+        if (other.mReserved > 0)
+            reserveStable(other.mReserved);
+        reserve(other.mSize);
+        std::uninitialized_copy(other.begin(), other.end(), mData);
+        mSize = other.mSize;
+    }
+
+    ElementVector(ElementVector&& other) noexcept { swap(other); }
+
+    ~ElementVector()
+    {
+        clear();
+        deallocate(mData, mCapacity, mReserved);
+    }
+
+    ElementVector& operator=(ElementVector other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    void swap(ElementVector& other) noexcept
+    {
+        std::swap(mData, other.mData);
+        std::swap(mSize, other.mSize);
+        std::swap(mCapacity, other.mCapacity);
+        std::swap(mReserved, other.mReserved);
+    }
+
+    friend void swap(ElementVector& a, ElementVector& b) noexcept { a.swap(b); }
+
+    std::size_t size() const { return mSize; }
+
+    bool empty() const { return mSize == 0; }
+
+    /**
+     * @brief Returns the number of elements for which memory has been
+     * allocated (or committed, if the stable storage policy is enabled).
+     */
+    std::size_t capacity() const { return mCapacity; }
+
+    /**
+     * @brief Returns the number of elements that can be stored without moving
+     * the elements if the stable storage policy is enabled, zero otherwise.
+     */
+    std::size_t stableCapacity() const { return mReserved; }
+
+    T* data() { return mData; }
+
+    const T* data() const { return mData; }
+
+    T& operator[](std::size_t i) { return mData[i]; }
+
+    const T& operator[](std::size_t i) const { return mData[i]; }
+
+    T& back() { return mData[mSize - 1]; }
+
+    const T& back() const { return mData[mSize - 1]; }
+
+    iterator begin() { return mData; }
+
+    iterator end() { return mData + mSize; }
+
+    const_iterator begin() const { return mData; }
+
+    const_iterator end() const { return mData + mSize; }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        grow(mSize + 1);
+        T* e = std::construct_at(mData + mSize, std::forward<Args>(args)...);
+        ++mSize;
+        return *e;
+    }
+
+    void resize(std::size_t size)
+    {
+        if (size > mSize) {
+            grow(size);
+            std::uninitialized_value_construct(mData + mSize, mData + size);
+        }
+        else {
+            std::destroy(mData + size, mData + mSize);
+        }
+        mSize = size;
+    }
+
+    void reserve(std::size_t size)
+    {
+        if (size > mCapacity) {
+            if (size <= mReserved)
+                commit(size);
+            else if (mReserved > 0)
+                relocate(size, size);
+            else
+                relocate(size, 0);
+        }
+    }
+
+    /**
+     * @brief Enables the stable storage policy, reserving the virtual address
+     * space for `size` elements.
+     *
+     * If the policy was already enabled with a larger or equal size, the
+     * function does nothing. Otherwise, the elements are moved in the new
+     * reserved range, and are not moved anymore until the size of the vector
+     * exceeds `size` (or the current size, if it is larger).
+     *
+     * @param[in] size: the number of elements that can be stored without
+     * moving them.
+     */
+    void reserveStable(std::size_t size)
+    {
+        if (size > mReserved) {
+            relocate(std::max(mSize, std::size_t(1)), std::max(size, mSize));
+        }
+    }
+
+    void clear()
+    {
+        std::destroy(mData, mData + mSize);
+        mSize = 0;
+    }
+
+private:
+    // makes room for at least size elements, growing geometrically
+    void grow(std::size_t size)
+    {
+        if (size > mCapacity) {
+            std::size_t cap = std::max(size, 2 * mCapacity);
+            if (mReserved > 0 && size <= mReserved)
+                commit(std::min(cap, mReserved));
+            else if (mReserved > 0)
+                relocate(cap, std::max(cap, 2 * mReserved));
+            else
+                relocate(cap, 0);
+        }
+    }
+
+    // commits the memory of the first size elements of the reserved range
+    void commit(std::size_t size)
+    {
+        std::size_t bytes = pageAligned(size * sizeof(T));
+        std::size_t old   = pageAligned(mCapacity * sizeof(T));
+        if (bytes > old)
+            commitVirtualMemory((char*) mData + old, bytes - old);
+        mCapacity = std::min(bytes / sizeof(T), mReserved);
+    }
+
+    // moves the elements in a new storage of capacity elements; if reserved is
+    // not zero, the new storage is a reserved range of reserved elements
+    void relocate(std::size_t capacity, std::size_t reserved)
+    {
+        ElementVector v;
+        if (reserved > 0) {
+            v.mData = static_cast<T*>(
+                reserveVirtualMemory(pageAligned(reserved * sizeof(T))));
+            v.mReserved = reserved;
+            v.commit(capacity);
+        }
+        else {
+            v.mData     = std::allocator<T>().allocate(capacity);
+            v.mCapacity = capacity;
+        }
+
+        if constexpr (
+            std::is_nothrow_move_constructible_v<T> ||
+            !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move(begin(), end(), v.mData);
+        }
+        else {
+            std::uninitialized_copy(begin(), end(), v.mData);
+        }
+        v.mSize = mSize;
+        swap(v);
+    }
+
+    static void deallocate(T* data, std::size_t capacity, std::size_t reserved)
+    {
+        if (reserved > 0)
+            releaseVirtualMemory(data, pageAligned(reserved * sizeof(T)));
+        else if (data != nullptr)
+            std::allocator<T>().deallocate(data, capacity);
+    }
+
+    static std::size_t pageAligned(std::size_t bytes)
+    {
+        static const std::size_t PAGE = virtualMemoryPageSize();
+        return (bytes + PAGE - 1) / PAGE * PAGE;
+    }
+};
+
+} // namespace vcl::mesh::detail
+
+#endif // VCL_MESH_CONTAINERS_DETAIL_ELEMENT_VECTOR_H
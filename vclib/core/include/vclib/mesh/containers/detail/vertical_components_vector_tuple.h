@@ -105,6 +105,16 @@ public:
 
     void swapComponents(uint i, uint j) { (swapComponent<Comp>(i, j), ...); }
 
+    /**
+     * @brief Returns true if the same components are enabled in this and in
+     * the other tuple.
+     */
+    bool hasSameEnabledComponents(
+        const VerticalComponentsVectorTuple& other) const
+    {
+        return mVecEnabled == other.mVecEnabled;
+    }
+
     template<typename C>
     bool isComponentEnabled() const
     {
@@ -244,13 +244,42 @@ public:
      */
     void reserveEdges(uint n) { Base::reserveElements(n); }
 
+    /**
+     * @brief Makes the Edge container stable up to `n` edges: until the
+     * number of edges in the container (deleted ones included) exceeds `n`,
+     * adding edges will never move the existing ones in memory, and the
+     * Edge pointers stored in the Mesh will stay valid.
+     *
+     * Unlike reserveEdges(), the memory is not allocated: only the
+     * address space for `n` edges is reserved, and the memory is allocated
+     * while the container grows. Therefore, `n` can be a generous upper bound
+     * of the expected number of edges.
+     *
+     * If the call of this function will cause a reallocation of the Edge
+     * container, the function will automatically take care of updating all the
+     * Edge pointers contained in the Mesh.
+     *
+     * @param n: the number of edges that can be stored without moving them.
+     */
+    void reserveStableEdges(uint n) { Base::reserveStableElements(n); }
+
     /**
      * @brief Compacts the EdgeContainer, removing all the Edges marked
      * as deleted. Edges indices will change accordingly. The function will
      * automatically take care of updating all the Edge pointers contained
      * in the Mesh.
+     *
+     * If preserveOrder is false, the holes left by the deleted Edges are
+     * filled with the last Edges of the container, and only the moved
+     * Edges change index: the cost of moving the Edges is proportional
+     * to the number of deleted Edges, and not to the size of the container.
+     *
+     * @param[in] preserveOrder: if true, the order of the Edges is preserved.
      */
-    void compactEdges() { Base::compactElements(); }
+    void compactEdges(bool preserveOrder = true)
+    {
+        Base::compactElements(preserveOrder);
+    }
 
     /**
      * @brief Marks as deleted the Edge with the given id.
@@ -264,13 +264,42 @@ public:
      */
     void reserveFaces(uint n) { Base::reserveElements(n); }
 
+    /**
+     * @brief Makes the Face container stable up to `n` faces: until the
+     * number of faces in the container (deleted ones included) exceeds `n`,
+     * adding faces will never move the existing ones in memory, and the
+     * Face pointers stored in the Mesh will stay valid.
+     *
+     * Unlike reserveFaces(), the memory is not allocated: only the
+     * address space for `n` faces is reserved, and the memory is allocated
+     * while the container grows. Therefore, `n` can be a generous upper bound
+     * of the expected number of faces.
+     *
+     * If the call of this function will cause a reallocation of the Face
+     * container, the function will automatically take care of updating all the
+     * Face pointers contained in the Mesh.
+     *
+     * @param n: the number of faces that can be stored without moving them.
+     */
+    void reserveStableFaces(uint n) { Base::reserveStableElements(n); }
+
     /**
      * @brief Compacts the FaceContainer, removing all the Faces marked as
      * deleted. Faces indices will change accordingly. The function will
      * automatically take care of updating all the Face pointers contained in
      * the Mesh.
+     *
+     * If preserveOrder is false, the holes left by the deleted Faces are
+     * filled with the last Faces of the container, and only the moved
+     * Faces change index: the cost of moving the Faces is proportional
+     * to the number of deleted Faces, and not to the size of the container.
+     *
+     * @param[in] preserveOrder: if true, the order of the Faces is preserved.
      */
-    void compactFaces() { Base::compactElements(); }
+    void compactFaces(bool preserveOrder = true)
+    {
+        Base::compactElements(preserveOrder);
+    }
 
     /**
      * @brief Marks as deleted the Face with the given id.
@@ -278,13 +278,43 @@ public:
      */
     void reserveVertices(uint n) { Base::reserveElements(n); }
 
+    /**
+     * @brief Makes the Vertex container stable up to `n` vertices: until the
+     * number of vertices in the container (deleted ones included) exceeds `n`,
+     * adding vertices will never move the existing ones in memory, and the
+     * Vertex pointers stored in the Mesh will stay valid.
+     *
+     * Unlike reserveVertices(), the memory is not allocated: only the
+     * address space for `n` vertices is reserved, and the memory is allocated
+     * while the container grows. Therefore, `n` can be a generous upper bound
+     * of the expected number of vertices.
+     *
+     * If the call of this function will cause a reallocation of the Vertex
+     * container, the function will automatically take care of updating all the
+     * Vertex pointers contained in the Mesh.
+     *
+     * @param n: the number of vertices that can be stored without moving them.
+     */
+    void reserveStableVertices(uint n) { Base::reserveStableElements(n); }
+
     /**
      * @brief Compacts the Vertex Container, removing all the vertices marked as
      * deleted. Vertices indices will change accordingly. The function will
      * automatically take care of updating all the Vertex pointers contained in
      * the Mesh.
+     *
+     * If preserveOrder is false, the holes left by the deleted vertices are
+     * filled with the last vertices of the container, and only the moved
+     * vertices change index: the cost of moving the vertices is proportional
+     * to the number of deleted vertices, and not to the size of the container.
+     *
+     * @param[in] preserveOrder: if true, the order of the vertices is
+     * preserved.
      */
-    void compactVertices() { Base::compactElements(); }
+    void compactVertices(bool preserveOrder = true)
+    {
+        Base::compactElements(preserveOrder);
+    }
 
     /**
      * @brief Marks as deleted the vertex with the given id.
@@ -240,6 +240,23 @@ public:
             HasPerElementOptionalComponent<Mesh<Args...>, ELEM_ID, COMP_ID>;
     }
 
+    /**
+     * @brief Returns true if this Mesh has a container of elements having the
+     * same Element ID of the template ELEM_ID and the Element of that container
+     * has a vertical Component (optional or not) having the same Component ID
+     * of the template COMP_ID.
+     *
+     * The values of a vertical component are stored contiguously in the
+     * container, and can be accessed without copies through the
+     * componentSpan() member function.
+     */
+    template<uint ELEM_ID, uint COMP_ID>
+    static constexpr bool hasPerElementVerticalComponent()
+    {
+        return mesh::
+            HasPerElementVerticalComponent<Mesh<Args...>, ELEM_ID, COMP_ID>;
+    }
+
     /* Constructors */
 
     /**
@@ -318,8 +335,18 @@ public:
      *
      * Removes all the deleted elements from each container, compacting the
      * the containers and then updating automatically all the pointers/indices.
+     *
+     * If preserveOrder is false, the holes left by the deleted elements are
+     * filled with the last elements of each container (see
+     * compactElements()).
+     *
+     * @param[in] preserveOrder: if true, the order of the elements is
+     * preserved.
      */
-    void compact() { (compactContainer<Args>(), ...); }
+    void compact(bool preserveOrder = true)
+    {
+        (compactContainer<Args>(preserveOrder), ...);
+    }
 
     /**
      * @brief Enables all the optional components of the elements of the
@@ -432,54 +459,118 @@ public:
         (updateReferencesOfContainerTypeAfterAppend<Args>(*this, bases, sizes),
          ...);
 
-        // manage transform matrix
-        if constexpr (mesh::HasTransformMatrix<Mesh<Args...>>) {
-            using Matrixtype = typename Mesh<Args...>::TransformMatrixType;
+        std::vector<uint> mapping = appendMaterialsOf(m);
+        updateComponentsAfterAppend(
+            m, sizes, Mesh<Args...>::getContainerSizes(*this), mapping);
+    }
 
-            Matrixtype matrix = this->transformMatrix();
-            matrix            = matrix.inverse().eval();
-            matrix *= m.transformMatrix();
+    /**
+     * @brief Appends all the elements contained in the mesh m to this mesh,
+     * moving them. After the call, the mesh m is empty.
+     *
+     * If a container of this mesh is empty and has the same enabled optional
+     * components and custom components of the container of m, its storage is
+     * taken from m without moving any element. Otherwise, the elements of the
+     * container are moved at the end of the container of this mesh.
+     *
+     * @note This function does not enable the optional components that are
+     * disabled in this mesh, but are available in m. Enabling the components
+     * that are available in m, but not in this mesh, is up to the user.
+     *
+     * @warning This function is applied only to the containers of the meshes.
+     * It does not import all the other components of the mesh m (e.g
+     * BoundingBox, TransformMatrix, ...).
+     *
+     * @param m
+     */
+    void append(Mesh&& m)
+    {
+        constexpr uint N_CONTAINERS =
+            NumberOfTypes<typename Mesh<Args...>::Containers>::value;
+        std::array<std::size_t, N_CONTAINERS> sizes =
+            Mesh<Args...>::getContainerSizes(*this);
+        std::array<const void*, N_CONTAINERS> bases =
+            Mesh<Args...>::getContainerBases(m);
 
-            if (matrix != Matrixtype::Identity()) {
-                (updatePosAndNormalsOfContainerTypeAfterAppend<Args>(
-                     *this, sizes, matrix),
-                 ...);
-            }
-        }
+        // each call moves only the container Args of m
+        (appendContainer<Args>(std::move(m)), ...);
 
-        if constexpr (mesh::HasMaterials<Mesh<Args...>>) {
-            uint nMaterials = this->materialCount();
+        // the bases of the containers that have been taken from m are the same
+        // of this mesh: their references are left unchanged
+        (updateReferencesOfContainerTypeAfterAppend<Args>(*this, bases, sizes),
+         ...);
 
-            // mapping from material indices of m to material indices of this
-            std::vector<uint> mapping(m.materialCount());
+        std::vector<uint> mapping = appendMaterialsOf(m);
+        updateComponentsAfterAppend(
+            m, sizes, Mesh<Args...>::getContainerSizes(*this), mapping);
 
-            // for each material of the other mesh, add it to this mesh
-            // if it does not exist yet
-            for (uint i = 0; i < m.materialCount(); ++i) {
-                auto it = std::find(
-                    this->materialBegin(), this->materialEnd(), m.material(i));
+        m.clear();
+    }
 
-                if (it == this->materialEnd()) {
-                    this->pushMaterial(m.material(i));
-                    mapping[i] = nMaterials++;
-                }
-                else {
-                    mapping[i] = std::distance(this->materialBegin(), it);
-                }
-            }
+    /**
+     * @brief Appends all the elements contained in the given range of meshes
+     * to this mesh.
+     *
+     * The result is the same of calling append(const Mesh&) for each mesh of
+     * the range, but the containers of this mesh grow only once, and then the
+     * elements of the meshes are copied, and their references updated, in
+     * parallel.
+     *
+     * @note This function does not enable the optional components that are
+     * disabled in this mesh, but are available in the meshes of the range.
+     *
+     * @warning This function is applied only to the containers of the meshes.
+     * It does not import all the other components of the meshes (e.g
+     * BoundingBox, TransformMatrix, ...).
+     *
+     * @param[in] meshes: the range of meshes to append.
+     */
+    template<Range R>
+    void append(R&& meshes)
+        requires (std::derived_from<std::ranges::range_value_t<R>, Mesh>)
+    {
+        constexpr uint N_CONTAINERS =
+            NumberOfTypes<typename Mesh<Args...>::Containers>::value;
+        using Sizes = std::array<std::size_t, N_CONTAINERS>;
+
+        std::vector<const Mesh*> ms;
+        for (const Mesh& m : meshes)
+            ms.push_back(&m);
+
+        // firsts[k] contains, for each container, the index of the first
+        // element appended from the k-th mesh
+        std::vector<Sizes> firsts(ms.size() + 1);
+        firsts[0] = Mesh<Args...>::getContainerSizes(*this);
+        for (uint k = 0; k < ms.size(); ++k) {
+            Sizes s = Mesh<Args...>::getContainerSizes(*ms[k]);
+            for (uint i = 0; i < N_CONTAINERS; ++i)
+                firsts[k + 1][i] = firsts[k][i] + s[i];
+        }
 
-            // update all the material indices in this mesh and add the texture
-            // images
-            if (nMaterials > 0 || mapping.size() > 0) {
-                for (const auto& p : m.textureImages()) {
-                    this->pushTextureImage(p.first, p.second);
-                }
+        // all the elements are added at once
+        (addElementsForAppend<Args>(firsts.front(), firsts.back(), ms), ...);
 
-                (updateMaterialIndicesOfContainerTypeAfterAppend<Args>(
-                     *this, sizes, mapping),
+        // materials are added serially, following the order of the meshes
+        std::vector<std::vector<uint>> mappings(ms.size());
+        for (uint k = 0; k < ms.size(); ++k)
+            mappings[k] = appendMaterialsOf(*ms[k]);
+
+        // each mesh fills its own range of each container
+        parallelForBlocks(ms.size(), 1, [&](std::size_t b, std::size_t e) {
+            for (std::size_t k = b; k < e; ++k) {
+                const Mesh& m = *ms[k];
+                (copyContainerForAppend<Args>(m, firsts[k]), ...);
+
+                std::array<const void*, N_CONTAINERS> bases =
+                    Mesh<Args...>::getContainerBases(m);
+                (updateReferencesOfContainerTypeAfterAppend<Args>(
+                     *this, bases, firsts[k], firsts[k + 1]),
                  ...);
+
+                updateComponentsAfterAppend(
+                    m, firsts[k], firsts[k + 1], mappings[k]);
             }
-        }
+        });
     }
 
     /**
@@ -878,18 +969,52 @@ public:
         Cont::reserveElements(n);
     }
 
+    /**
+     * @brief Makes the container of the elements of the given type stable up to
+     * `n` elements: the elements will not be moved in memory while the number
+     * of elements in the container does not exceed `n`, and therefore the
+     * pointers to the elements stored in the Mesh will stay valid.
+     *
+     * Unlike reserve(), the function does not allocate memory for `n` elements,
+     * but only reserves the address space for them: the memory is allocated
+     * while the container grows.
+     *
+     * The function requires that the Mesh has a Container of Elements having ID
+     * ELEM_ID. Otherwise, a compiler error will be triggered.
+     *
+     * @tparam ELEM_ID: the type ID of the element.
+     * @param[in] n: the number of elements that can be stored without moving
+     * them.
+     */
+    template<uint ELEM_ID>
+    void reserveStable(uint n) requires (hasContainerOf<ELEM_ID>())
+    {
+        using Cont = ContainerOfElement<ELEM_ID>::type;
+
+        Cont::reserveStableElements(n);
+    }
+
     /**
      * @brief Compacts the Container of the given element, removing all the
      * elements marked as deleted. Element indices will change accordingly. The
      * function will automatically take care of updating all the Element
      * pointers contained in the Mesh.
+     *
+     * If preserveOrder is false, the holes left by the deleted elements are
+     * filled with the last elements of the container, and only the moved
+     * elements change index.
+     *
+     * @tparam ELEM_ID: the type ID of the element.
+     * @param[in] preserveOrder: if true, the order of the elements is
+     * preserved.
      */
     template<uint ELEM_ID>
-    void compactElements() requires (hasContainerOf<ELEM_ID>())
+    void compactElements(bool preserveOrder = true)
+        requires (hasContainerOf<ELEM_ID>())
     {
         using Cont = ContainerOfElement<ELEM_ID>::type;
 
-        Cont::compactElements();
+        Cont::compactElements(preserveOrder);
     }
 
     /**
@@ -1266,6 +1391,55 @@ public:
         return Cont::elements(begin, end);
     }
 
+    /**
+     * @brief Returns a span over the contiguous storage of the vertical
+     * Component having ID `COMP_ID` of the elements having ID `ELEM_ID`.
+     *
+     * The i-th value of the span is the component of the element having index
+     * i in its container: the span has the size of the container, and contains
+     * also the values of the deleted elements. The span is invalidated by
+     * every operation that changes the size of the container.
+     *
+     * Since the values are contiguous, the span can be used to export or
+     * process the component without copies (e.g. through an `Eigen::Map`).
+     *
+     * The function requires that the Mesh has a Container of Elements having ID
+     * ELEM_ID, and that the Element has a vertical component having ID COMP_ID.
+     * If the component is optional, it must be enabled.
+     *
+     * @tparam ELEM_ID: the ID of the element.
+     * @tparam COMP_ID: the ID of the component.
+     * @return a span over the values of the component of all the elements.
+     */
+    template<uint ELEM_ID, uint COMP_ID>
+    auto componentSpan()
+        requires (hasPerElementVerticalComponent<ELEM_ID, COMP_ID>())
+    {
+        using Cont = ContainerOfElement<ELEM_ID>::type;
+
+        return Cont::template componentSpan<COMP_ID>();
+    }
+
+    /**
+     * @brief Returns a const span over the contiguous storage of the vertical
+     * Component having ID `COMP_ID` of the elements having ID `ELEM_ID`.
+     *
+     * @see componentSpan()
+     *
+     * @tparam ELEM_ID: the ID of the element.
+     * @tparam COMP_ID: the ID of the component.
+     * @return a const span over the values of the component of all the
+     * elements.
+     */
+    template<uint ELEM_ID, uint COMP_ID>
+    auto componentSpan() const
+        requires (hasPerElementVerticalComponent<ELEM_ID, COMP_ID>())
+    {
+        using Cont = ContainerOfElement<ELEM_ID>::type;
+
+        return Cont::template componentSpan<COMP_ID>();
+    }
+
     /**
      * @brief Returns `true` if optional Component having ID `COMP_ID` is
      * enabled for elements having ID `ELEM_ID` in the mesh.
@@ -1655,15 +1829,15 @@ protected:
      *
      * This function is made to be called trough pack expansion:
      * @code{.cpp}
-     * (compactContainer<Args>(), ...);
+     * (compactContainer<Args>(preserveOrder), ...);
      * @endcode
      */
     template<typename Cont>
-    void compactContainer()
+    void compactContainer(bool preserveOrder)
     {
         if constexpr (mesh::ElementContainerConcept<Cont>) {
             if (Cont::elementCount() != Cont::elementContainerSize()) {
-                Cont::compactElements();
+                Cont::compactElements(preserveOrder);
             }
         }
     }
@@ -1773,6 +1947,34 @@ protected:
         }
     }
 
+    // same of the function above, but the references are updated only in the
+    // range [sizes[I], ends[I]) of each container I
+    template<typename Element, std::size_t N, typename... A>
+    void updateReferences(
+        const Element* oldBase,
+        TypeWrapper<A...>,
+        const std::array<std::size_t, N>& sizes,
+        uint                              offset,
+        const std::array<std::size_t, N>& ends)
+    {
+        (updateReferences<A>(oldBase, sizes, offset, ends), ...);
+    }
+
+    template<typename Cont, typename Element, std::size_t N>
+    void updateReferences(
+        const Element*                    oldBase,
+        const std::array<std::size_t, N>& sizes,
+        uint                              offset,
+        const std::array<std::size_t, N>& ends)
+    {
+        if constexpr (mesh::ElementContainerConcept<Cont>) {
+            using Containers = Mesh<Args...>::Containers;
+            constexpr uint I = IndexInTypes<Cont, Containers>::value;
+            static_assert(I >= 0 && I != UINT_NULL);
+            Cont::updateReferences(oldBase, sizes[I], offset, ends[I]);
+        }
+    }
+
     template<ElementConcept Element>
     void updateAllReferences(const std::vector<uint>& newIndices)
     {
@@ -1823,6 +2025,129 @@ private:
         }
     }
 
+    template<typename Cont>
+    void appendContainer(Mesh&& m)
+    {
+        if constexpr (mesh::ElementContainerConcept<Cont>) {
+            Cont::append((Cont&&) m);
+        }
+    }
+
+    /*
+     * Adds to the container Cont the elements of all the given meshes, that
+     * will be stored in the range [firsts[I], ends[I]), where I is the index
+     * of Cont in the containers of the mesh. The element count takes into
+     * account the deleted elements of the meshes.
+     */
+    template<typename Cont, typename ArrayS>
+    void addElementsForAppend(
+        const ArrayS&                   firsts,
+        const ArrayS&                   ends,
+        const std::vector<const Mesh*>& ms)
+    {
+        if constexpr (mesh::ElementContainerConcept<Cont>) {
+            using Containers = Mesh<Args...>::Containers;
+            constexpr uint I = IndexInTypes<Cont, Containers>::value;
+            static_assert(I >= 0 && I != UINT_NULL);
+
+            Cont::addElements(ends[I] - firsts[I]);
+            for (const Mesh* m : ms) {
+                Cont::mElemCount -=
+                    m->Cont::elementContainerSize() - m->Cont::elementCount();
+            }
+        }
+    }
+
+    template<typename Cont, typename ArrayS>
+    void copyContainerForAppend(const Mesh& m, const ArrayS& firsts)
+    {
+        if constexpr (mesh::ElementContainerConcept<Cont>) {
+            using Containers = Mesh<Args...>::Containers;
+            constexpr uint I = IndexInTypes<Cont, Containers>::value;
+            static_assert(I >= 0 && I != UINT_NULL);
+
+            Cont::copyElementsFrom(firsts[I], (const Cont&) m);
+        }
+    }
+
+    /*
+     * Adds to this mesh the materials and the texture images of m that are
+     * not already in this mesh, and returns the mapping from the material
+     * indices of m to the material indices of this mesh.
+     */
+    std::vector<uint> appendMaterialsOf(const Mesh& m)
+    {
+        // mapping from material indices of m to material indices of this
+        std::vector<uint> mapping;
+
+        if constexpr (mesh::HasMaterials<Mesh<Args...>>) {
+            uint nMaterials = this->materialCount();
+
+            mapping.resize(m.materialCount());
+
+            // for each material of the other mesh, add it to this mesh
+            // if it does not exist yet
+            for (uint i = 0; i < m.materialCount(); ++i) {
+                auto it = std::find(
+                    this->materialBegin(), this->materialEnd(), m.material(i));
+
+                if (it == this->materialEnd()) {
+                    this->pushMaterial(m.material(i));
+                    mapping[i] = nMaterials++;
+                }
+                else {
+                    mapping[i] = std::distance(this->materialBegin(), it);
+                }
+            }
+
+            // add the texture images
+            if (nMaterials > 0 || mapping.size() > 0) {
+                for (const auto& p : m.textureImages()) {
+                    this->pushTextureImage(p.first, p.second);
+                }
+            }
+        }
+        return mapping;
+    }
+
+    /*
+     * Updates the elements appended from m, stored in the ranges
+     * [firsts[I], ends[I]) of each container I: positions and normals are
+     * transformed according to the transform matrices of the two meshes, and
+     * material indices are updated according to the given mapping.
+     */
+    template<typename ArrayS>
+    void updateComponentsAfterAppend(
+        const Mesh&              m,
+        const ArrayS&            firsts,
+        const ArrayS&            ends,
+        const std::vector<uint>& mapping)
+    {
+        // manage transform matrix
+        if constexpr (mesh::HasTransformMatrix<Mesh<Args...>>) {
+            using Matrixtype = typename Mesh<Args...>::TransformMatrixType;
+
+            Matrixtype matrix = this->transformMatrix();
+            matrix            = matrix.inverse().eval();
+            matrix *= m.transformMatrix();
+
+            if (matrix != Matrixtype::Identity()) {
+                (updatePosAndNormalsOfContainerTypeAfterAppend<Args>(
+                     *this, firsts, ends, matrix),
+                 ...);
+            }
+        }
+
+        // update all the material indices of the appended elements
+        if constexpr (mesh::HasMaterials<Mesh<Args...>>) {
+            if (mapping.size() > 0) {
+                (updateMaterialIndicesOfContainerTypeAfterAppend<Args>(
+                     *this, firsts, ends, mapping),
+                 ...);
+            }
+        }
+    }
+
     // private copy and swap member functions
 
     /**
@@ -1984,6 +2309,33 @@ private:
         }
     }
 
+    // same of the function above, but only the references contained in the
+    // range [sizes[I], ends[I]) of each container I are updated
+    template<typename Cont, typename ArrayB, typename ArrayS, typename... A>
+    static void updateReferencesOfContainerTypeAfterAppend(
+        Mesh<A...>&   m,
+        const ArrayB& bases,
+        const ArrayS& sizes,
+        const ArrayS& ends)
+    {
+        if constexpr (mesh::ElementContainerConcept<Cont>) {
+            using ElType = Cont::ElementType;
+
+            using Containers = Mesh<A...>::Containers;
+            constexpr uint I = IndexInTypes<Cont, Containers>::value;
+            static_assert(I >= 0 && I != UINT_NULL);
+
+            using ContainerWrapper = TypeWrapper<A...>;
+
+            m.updateReferences(
+                reinterpret_cast<const ElType*>(bases[I]),
+                ContainerWrapper(),
+                sizes,
+                sizes[I],
+                ends);
+        }
+    }
+
     // swap two elements
     template<typename ElementType>
     void swapVerticalComponents(ElementType& e1, ElementType& e2)
@@ -2003,6 +2355,7 @@ private:
     static void updatePosAndNormalsOfContainerTypeAfterAppend(
         Mesh<A...>&       m,
         const ArrayS&     sizes,
+        const ArrayS&     ends,
         const MatrixType& matrix)
     {
         // since this function is called using pack expansion, it means that
@@ -2020,8 +2373,10 @@ private:
             static_assert(I >= 0 && I != UINT_NULL);
 
             if constexpr (hasPerElementComponent<ELEM_ID, CompId::POSITION>()) {
-                auto posview = m.template elements<ELEM_ID>((uint) sizes[I]) |
-                               vcl::views::positions;
+                auto posview =
+                    m.template elements<ELEM_ID>(
+                        (uint) sizes[I], (uint) ends[I]) |
+                    vcl::views::positions;
 
                 multiplyPointsByMatrix(posview, matrix);
             }
@@ -2029,7 +2384,8 @@ private:
             if constexpr (hasPerElementComponent<ELEM_ID, CompId::NORMAL>()) {
                 if (m.Cont::template isComponentAvailable<CompId::NORMAL>()) {
                     auto norview =
-                        m.template elements<ELEM_ID>((uint) sizes[I]) |
+                        m.template elements<ELEM_ID>(
+                            (uint) sizes[I], (uint) ends[I]) |
                         vcl::views::normals;
 
                     multiplyNormalsByMatrix(norview, matrix);
@@ -2042,6 +2398,7 @@ private:
     static void updateMaterialIndicesOfContainerTypeAfterAppend(
         Mesh<A...>&              m,
         const ArrayS&            sizes,
+        const ArrayS&            ends,
         const std::vector<uint>& mapping)
     {
         // since this function is called using pack expansion, it means that
@@ -2063,7 +2420,8 @@ private:
                               CompId::MATERIAL_INDEX>()) {
                 if (m.Cont::template isComponentAvailable<
                         CompId::MATERIAL_INDEX>()) {
-                    auto elems = m.template elements<ELEM_ID>((uint) sizes[I]);
+                    auto elems = m.template elements<ELEM_ID>(
+                        (uint) sizes[I], (uint) ends[I]);
                     for (auto& e : elems) {
                         e.materialIndex() = mapping[e.materialIndex()];
                     }
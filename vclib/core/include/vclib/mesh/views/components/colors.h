@@ -8,6 +8,8 @@
 #ifndef VCL_MESH_VIEWS_COMPONENTS_COLORS_H
 #define VCL_MESH_VIEWS_COMPONENTS_COLORS_H
 
+#include "detail/vertex_component_values.h"
+
 #include <vclib/mesh/components/color.h>
 #include <vclib/mesh/components/wedge_colors.h>
 
@@ -36,6 +38,14 @@ struct ColorsView
         return std::forward<R>(r) | std::views::transform(color);
     }
 
+    // applied to a mesh, gives the colors of all the vertices of the
+    // container, without copies if they are stored contiguously
+    template<MeshWithPerVertexComponent<CompId::COLOR> M>
+    friend constexpr auto operator|(M&& m, ColorsView)
+    {
+        return vertexComponentValues<CompId::COLOR>(m, color);
+    }
+
     template<comp::HasWedgeColors R>
     friend constexpr auto operator|(R&& r, ColorsView)
     {
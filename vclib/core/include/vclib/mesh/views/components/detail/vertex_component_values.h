@@ -0,0 +1,51 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_MESH_VIEWS_COMPONENTS_DETAIL_VERTEX_COMPONENT_VALUES_H
+#define VCL_MESH_VIEWS_COMPONENTS_DETAIL_VERTEX_COMPONENT_VALUES_H
+
+#include <vclib/mesh/elements/base/base.h>
+
+#include <ranges>
+#include <type_traits>
+
+namespace vcl::views::detail {
+
+/*
+ * Evaluates to true if MeshType is a mesh having a container of vertices with
+ * the component COMP_ID.
+ */
+template<typename MeshType, uint COMP_ID>
+concept MeshWithPerVertexComponent =
+    std::remove_cvref_t<MeshType>::template hasPerElementComponent<
+        ElemId::VERTEX,
+        COMP_ID>();
+
+/*
+ * Returns a range over the values of the component COMP_ID of all the vertices
+ * of the container of the mesh m, deleted vertices included. If the component
+ * is vertical, the range is a span over its contiguous storage; otherwise, it
+ * is a view that applies the function f to each vertex.
+ */
+template<uint COMP_ID, typename MeshType>
+auto vertexComponentValues(MeshType& m, auto f)
+{
+    using M = std::remove_cvref_t<MeshType>;
+
+    if constexpr (M::template hasPerElementVerticalComponent<
+                      ElemId::VERTEX,
+                      COMP_ID>()) {
+        return m.template componentSpan<ElemId::VERTEX, COMP_ID>();
+    }
+    else {
+        return m.vertices(false) | std::views::transform(f);
+    }
+}
+
+} // namespace vcl::views::detail
+
+#endif // VCL_MESH_VIEWS_COMPONENTS_DETAIL_VERTEX_COMPONENT_VALUES_H
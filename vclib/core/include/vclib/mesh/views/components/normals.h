@@ -8,6 +8,8 @@
 #ifndef VCL_MESH_VIEWS_COMPONENTS_NORMALS_H
 #define VCL_MESH_VIEWS_COMPONENTS_NORMALS_H
 
+#include "detail/vertex_component_values.h"
+
 #include <vclib/mesh/components/normal.h>
 
 #include <vclib/base.h>
@@ -34,6 +36,14 @@ struct NormalsView
     {
         return std::forward<R>(r) | std::views::transform(normal);
     }
+
+    // applied to a mesh, gives the normals of all the vertices of the
+    // container, without copies if they are stored contiguously
+    template<MeshWithPerVertexComponent<CompId::NORMAL> M>
+    friend constexpr auto operator|(M&& m, NormalsView)
+    {
+        return vertexComponentValues<CompId::NORMAL>(m, normal);
+    }
 };
 
 } // namespace detail
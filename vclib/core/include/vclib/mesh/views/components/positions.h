@@ -8,6 +8,8 @@
 #ifndef VCL_MESH_VIEWS_COMPONENTS_POSITIONS_H
 #define VCL_MESH_VIEWS_COMPONENTS_POSITIONS_H
 
+#include "detail/vertex_component_values.h"
+
 #include <vclib/mesh/components/position.h>
 
 #include <vclib/base.h>
@@ -34,6 +36,14 @@ struct PositionsView
     {
         return std::forward<R>(r) | std::views::transform(position);
     }
+
+    // applied to a mesh, gives the positions of all the vertices of the
+    // container, without copies if they are stored contiguously
+    template<MeshWithPerVertexComponent<CompId::POSITION> M>
+    friend constexpr auto operator|(M&& m, PositionsView)
+    {
+        return vertexComponentValues<CompId::POSITION>(m, position);
+    }
 };
 
 } // namespace detail
@@ -14,6 +14,7 @@
 #include "meshes/poly_mesh.h"
 #include "meshes/tri_edge_mesh.h"
 #include "meshes/tri_mesh.h"
+#include "meshes/tri_mesh_soa.h"
 
 /**
  * @defgroup meshes Meshes
@@ -0,0 +1,203 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_MESHES_TRI_MESH_SOA_H
+#define VCL_MESHES_TRI_MESH_SOA_H
+
+#include <vclib/mesh.h>
+
+namespace vcl {
+
+template<typename ScalarType, bool INDEXED>
+class TriMeshSoAT;
+
+} // namespace vcl
+
+namespace vcl::trimeshsoa {
+
+template<typename Scalar, bool INDEXED>
+class Vertex;
+
+template<typename Scalar, bool INDEXED>
+class Face;
+
+/**
+ * @brief The Vertex type used by the TriMeshSoAT class.
+ *
+ * @extends vert::BitFlags
+ * @extends vert::VerticalPosition3
+ * @extends vert::VerticalNormal3
+ * @extends vert::OptionalColor
+ * @extends vert::OptionalQuality
+ * @extends vert::OptionalAdjacentFaces
+ * @extends vert::OptionalAdjacentVertices
+ * @extends vert::OptionalPrincipalCurvature
+ * @extends vert::OptionalTexCoord
+ * @extends vert::OptionalMaterialIndex
+ * @extends vert::OptionalTangent3
+ * @extends vert::OptionalMark
+ * @extends vert::CustomComponents
+ *
+ * @tparam Scalar: The scalar type used for the mesh.
+ * @tparam I: A boolean flag that indicates whether the mesh uses indices or
+ * pointers to store vertices of faces and adjacency information.
+ *
+ * @ingroup meshes
+ */
+template<typename Scalar, bool I>
+class Vertex :
+        public vcl::Vertex<
+            TriMeshSoAT<Scalar, I>,
+            vert::BitFlags,
+            vert::VerticalPosition3<Scalar, Vertex<Scalar, I>>,
+            vert::VerticalNormal3<Scalar, Vertex<Scalar, I>>,
+            vert::OptionalColor<Vertex<Scalar, I>>,
+            vert::OptionalQuality<Scalar, Vertex<Scalar, I>>,
+            vert::OptionalAdjacentFaces<I, Face<Scalar, I>, Vertex<Scalar, I>>,
+            vert::OptionalAdjacentVertices<I, Vertex<Scalar, I>>,
+            vert::OptionalPrincipalCurvature<Scalar, Vertex<Scalar, I>>,
+            vert::OptionalTexCoord<Scalar, Vertex<Scalar, I>>,
+            vert::OptionalMaterialIndex<Vertex<Scalar, I>>,
+            vert::OptionalTangent3<Scalar, Vertex<Scalar, I>>,
+            vert::OptionalMark<Vertex<Scalar, I>>,
+            vert::CustomComponents<Vertex<Scalar, I>>>
+{
+public:
+    friend void swap(Vertex& a, Vertex& b) { a.swap(b); }
+};
+
+/**
+ * @brief The Face type used by the TriMeshSoAT class.
+ *
+ * @extends face::TriangleBitFlags
+ * @extends face::TriangleVertexRefs
+ * @extends face::VerticalNormal3
+ * @extends face::OptionalColor
+ * @extends face::OptionalQuality
+ * @extends face::OptionalAdjacentTriangles
+ * @extends face::OptionalTriangleWedgeTexCoords
+ * @extends face::OptionalMaterialIndex
+ * @extends face::OptionalMark
+ * @extends face::CustomComponents
+ *
+ * @tparam Scalar: The scalar type used for the mesh.
+ * @tparam I: A boolean flag that indicates whether the mesh uses indices or
+ * pointers to store vertices of faces and adjacency information.
+ *
+ * @ingroup meshes
+ */
+template<typename Scalar, bool I>
+class Face :
+        public vcl::Face<
+            TriMeshSoAT<Scalar, I>,
+            face::TriangleBitFlags,
+            face::TriangleVertexRefs<I, Vertex<Scalar, I>, Face<Scalar, I>>,
+            face::VerticalNormal3<Scalar, Face<Scalar, I>>,
+            face::OptionalColor<Face<Scalar, I>>,
+            face::OptionalQuality<Scalar, Face<Scalar, I>>,
+            face::OptionalAdjacentTriangles<I, Face<Scalar, I>>,
+            face::OptionalTriangleWedgeTexCoords<Scalar, Face<Scalar, I>>,
+            face::OptionalMaterialIndex<Face<Scalar, I>>,
+            face::OptionalMark<Face<Scalar, I>>,
+            face::CustomComponents<Face<Scalar, I>>>
+{
+public:
+    friend void swap(Face& a, Face& b) { a.swap(b); }
+};
+
+} // namespace vcl::trimeshsoa
+
+namespace vcl {
+
+/**
+ * @brief The TriMeshSoAT class is a mesh class that represents a triangle mesh,
+ * storing positions and normals as structure of arrays.
+ *
+ * It allows to store trimeshsoa::Vertex and trimeshsoa::Face elements.
+ *
+ * It has the same components of the TriMeshT class, but the positions and the
+ * normals of the vertices and the normals of the faces are vertical components:
+ * they are stored in contiguous arrays in their containers (structure of
+ * arrays) instead of inside each element. They can be accessed without copies
+ * through the `componentSpan()` member function of the mesh, or applying the
+ * views::positions and views::normals views to the mesh (e.g.
+ * `mesh | views::positions`), and they can be exported to buffers with a single
+ * memory copy.
+ *
+ * The mesh is templated over the scalar type and a boolean flag that indicates
+ * whether the mesh uses indices to store vertices of faces and adjacency
+ * information.
+ *
+ * @tparam Scalar: The scalar type used for the mesh.
+ * @tparam INDEXED: A boolean flag that indicates whether the mesh uses indices
+ * or pointers to store references.
+ *
+ * @extends mesh::VertexContainer
+ * @extends mesh::FaceContainer
+ * @extends mesh::BoundingBox3
+ * @extends mesh::Color
+ * @extends mesh::Mark
+ * @extends mesh::Materials
+ * @extends mesh::Name
+ * @extends mesh::TransformMatrix
+ * @extends mesh::CustomComponents
+ *
+ * @ingroup meshes
+ */
+template<typename Scalar, bool INDEXED>
+class TriMeshSoAT :
+        public Mesh<
+            mesh::VertexContainer<trimeshsoa::Vertex<Scalar, INDEXED>>,
+            mesh::FaceContainer<trimeshsoa::Face<Scalar, INDEXED>>,
+            mesh::BoundingBox3<Scalar>,
+            mesh::Color,
+            mesh::Mark,
+            mesh::Materials,
+            mesh::Name,
+            mesh::TransformMatrix<Scalar>,
+            mesh::CustomComponents>
+{
+public:
+    /** @brief The scalar used to store all the data of the Mesh. */
+    using ScalarType = Scalar;
+};
+
+/**
+ * @brief The TriMeshSoAf class is a specialization of TriMeshSoAT that uses
+ * `float` as scalar and pointers to store vertices of faces and adjacency
+ * information.
+ * @ingroup meshes
+ */
+using TriMeshSoAf = TriMeshSoAT<float, false>;
+
+/**
+ * @brief The TriMeshSoA class is a specialization of TriMeshSoAT that uses
+ * `double` as scalar and pointers to store vertices of faces and adjacency
+ * information.
+ * @ingroup meshes
+ */
+using TriMeshSoA = TriMeshSoAT<double, false>;
+
+/**
+ * @brief The TriMeshSoAIndexedf class is a specialization of TriMeshSoAT that
+ * uses `float` as scalar and indices (`unsigned int`) to store vertices of
+ * faces and adjacency information.
+ * @ingroup meshes
+ */
+using TriMeshSoAIndexedf = TriMeshSoAT<float, true>;
+
+/**
+ * @brief The TriMeshSoAIndexed class is a specialization of TriMeshSoAT that
+ * uses `double` as scalar and indices (`unsigned int`) to store vertices of
+ * faces and adjacency information.
+ * @ingroup meshes
+ */
+using TriMeshSoAIndexed = TriMeshSoAT<double, true>;
+
+} // namespace vcl
+
+#endif // VCL_MESHES_TRI_MESH_SOA_H
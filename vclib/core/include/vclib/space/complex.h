@@ -8,6 +8,7 @@
 #ifndef VCL_SPACE_COMPLEX_H
 #define VCL_SPACE_COMPLEX_H
 
+#include "complex/face_bvh.h"
 #include "complex/graph.h"
 #include "complex/grid.h"
 #include "complex/kd_tree.h"
@@ -0,0 +1,722 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_SPACE_COMPLEX_FACE_BVH_H
+#define VCL_SPACE_COMPLEX_FACE_BVH_H
+
+#include <vclib/base.h>
+#include <vclib/mesh.h>
+#include <vclib/space/core.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace vcl {
+
+/**
+ * @brief The FaceBVH class is a Bounding Volume Hierarchy of axis aligned
+ * boxes built on the faces of a mesh, that allows to perform closest face, ray
+ * and box queries.
+ *
+ * The hierarchy is built top-down: the faces of each node are split along the
+ * axis of largest extent of their centroids, in the position that minimizes
+ * the Surface Area Heuristic (SAH), evaluated on a fixed number of bins. If the
+ * SAH does not find a valid split (e.g. all the centroids fall in the same
+ * bin), the faces are split at the median centroid.
+ *
+ * The nodes are stored in a flat array in depth-first order: the left child of
+ * an internal node is the node that immediately follows it, and each node
+ * stores only the index of its right child. The faces of each leaf are stored
+ * contiguously.
+ *
+ * Unlike the grids, the cost of the queries does not depend on the
+ * distribution of the sizes of the faces, therefore the BVH is well suited for
+ * meshes having very uneven triangle sizes.
+ *
+ * @note The BVH stores pointers to the faces of the mesh: it must be rebuilt
+ * if the face container of the mesh is reallocated.
+ *
+ * @tparam FaceType: the type of the faces stored in the BVH.
+ *
+ * @ingroup space_complex
+ */
+template<FaceConcept FaceType>
+class FaceBVH
+{
+public:
+    using PointType  = FaceType::VertexType::PositionType;
+    using ScalarType = PointType::ScalarType;
+    using BoxType    = Box<PointType>;
+    using RayType    = Ray<PointType>;
+
+private:
+    using Scalar = ScalarType;
+
+    struct Node
+    {
+        BoxType box;
+        uint    first; // leaf: first face in mFaces; otherwise: right child
+        uint    count; // number of faces of the leaf, 0 for internal nodes
+    };
+
+    // element of the traversal stack: a node and its distance from the query
+    struct QueryNode
+    {
+        uint   nodeId;
+        Scalar dist;
+    };
+
+    static const uint MAX_DEPTH = 64; // max tree depth
+    static const uint N_BINS    = 12; // number of bins used to evaluate SAH
+
+    // a node is pushed in the stack for each level, plus the root
+    using QueryStack = std::array<QueryNode, MAX_DEPTH + 2>;
+
+    std::vector<const FaceType*> mFaces;
+    std::vector<Node>            mNodes;
+
+    uint mFacesPerLeaf = 4; // max number of faces in a leaf
+
+public:
+    FaceBVH() {}
+
+    /**
+     * @brief Builds the BVH on the faces of the given mesh.
+     *
+     * Requirements:
+     * - Mesh:
+     *   - Faces
+     *
+     * @param[in] m: the mesh on which build the BVH.
+     * @param[in] facesPerLeaf: the maximum number of faces stored in a leaf.
+     */
+    template<FaceMeshConcept MeshType>
+    FaceBVH(const MeshType& m, uint facesPerLeaf = 4)
+        requires std::same_as<typename MeshType::FaceType, FaceType>
+            : mFacesPerLeaf(std::max(facesPerLeaf, 1u))
+    {
+        mFaces.reserve(m.faceCount());
+        for (const FaceType& f : m.faces())
+            mFaces.push_back(&f);
+
+        build();
+    }
+
+    /**
+     * @brief Returns the number of faces stored in the BVH.
+     */
+    uint size() const { return mFaces.size(); }
+
+    /**
+     * @brief Returns true if the BVH does not contain any face.
+     */
+    bool empty() const { return mFaces.empty(); }
+
+    /**
+     * @brief Returns the bounding box of all the faces stored in the BVH.
+     */
+    BoxType boundingBox() const
+    {
+        return mNodes.empty() ? BoxType() : mNodes[0].box;
+    }
+
+    /**
+     * @brief Searchs the closest face to the query point.
+     *
+     * Nodes are visited in order of distance from the query point, and are
+     * pruned using the distance of their box from the query point.
+     *
+     * @param[in] queryPoint: the query point.
+     * @param[out] dist: the distance between the query point and the closest
+     * face. It is not modified if no face is found.
+     * @param[out] closest: the point of the closest face that is closest to the
+     * query point. It is not modified if no face is found.
+     * @param[in] maxDist: only the faces having distance less than maxDist from
+     * the query point are considered.
+     * @return a pointer to the closest face, or nullptr if there are no faces
+     * having distance less than maxDist from the query point.
+     */
+    const FaceType* closestFace(
+        const PointType& queryPoint,
+        Scalar&          dist,
+        PointType&       closest,
+        Scalar           maxDist = std::numeric_limits<Scalar>::max()) const
+    {
+        const FaceType* res = nullptr;
+
+        if (mNodes.empty())
+            return res;
+
+        Scalar     minDist = maxDist;
+        QueryStack stack;
+        uint       count = 0;
+
+        stack[count++] = {0, boxDist(mNodes[0].box, queryPoint)};
+
+        while (count) {
+            const QueryNode qnode = stack[--count];
+
+            // the box of the node is farther than the closest face found so
+            // far: no face of the node can be closer
+            if (qnode.dist >= minDist)
+                continue;
+
+            const Node& node = mNodes[qnode.nodeId];
+
+            if (node.count > 0) {
+                uint end = node.first + node.count;
+                for (uint i = node.first; i < end; ++i) {
+                    PointType w;
+                    Scalar    d =
+                        boundedDistance(queryPoint, *mFaces[i], minDist, w);
+                    if (d < minDist) {
+                        minDist = d;
+                        closest = w;
+                        res     = mFaces[i];
+                    }
+                }
+            }
+            else {
+                QueryNode l = {
+                    qnode.nodeId + 1,
+                    boxDist(mNodes[qnode.nodeId + 1].box, queryPoint)};
+                QueryNode r = {
+                    node.first, boxDist(mNodes[node.first].box, queryPoint)};
+
+                // the closest child is pushed last, to be visited first
+                if (l.dist < r.dist)
+                    std::swap(l, r);
+                if (l.dist < minDist)
+                    stack[count++] = l;
+                if (r.dist < minDist)
+                    stack[count++] = r;
+            }
+        }
+
+        if (res)
+            dist = minDist;
+        return res;
+    }
+
+    /**
+     * @copydoc closestFace(const PointType&, Scalar&, PointType&, Scalar) const
+     */
+    const FaceType* closestFace(
+        const PointType& queryPoint,
+        Scalar&          dist,
+        Scalar           maxDist = std::numeric_limits<Scalar>::max()) const
+    {
+        PointType closest;
+        return closestFace(queryPoint, dist, closest, maxDist);
+    }
+
+    /**
+     * @brief Searchs the closest face to the query point.
+     *
+     * @param[in] queryPoint: the query point.
+     * @return a pointer to the closest face, or nullptr if the BVH is empty.
+     */
+    const FaceType* closestFace(const PointType& queryPoint) const
+    {
+        Scalar dist;
+        return closestFace(queryPoint, dist);
+    }
+
+    /**
+     * @brief Searchs the first face hit by the given ray.
+     *
+     * @param[in] ray: the query ray.
+     * @param[out] t: the parameter along the ray of the hit point, that is
+     * `ray.origin() + t * ray.direction()`. It is not modified if the ray does
+     * not hit any face.
+     * @return a pointer to the first face hit by the ray, or nullptr if the ray
+     * does not hit any face.
+     */
+    const FaceType* firstRayHit(const RayType& ray, Scalar& t) const
+    {
+        const FaceType* res = nullptr;
+
+        if (mNodes.empty())
+            return res;
+
+        const PointType invDir = inverseDirection(ray);
+
+        Scalar     minT = std::numeric_limits<Scalar>::max();
+        QueryStack stack;
+        uint       count = 0;
+
+        Scalar rootT = rayBoxEntry(mNodes[0].box, ray.origin(), invDir, minT);
+        if (rootT < minT)
+            stack[count++] = {0, rootT};
+
+        while (count) {
+            const QueryNode qnode = stack[--count];
+
+            if (qnode.dist >= minT)
+                continue;
+
+            const Node& node = mNodes[qnode.nodeId];
+
+            if (node.count > 0) {
+                uint end = node.first + node.count;
+                for (uint i = node.first; i < end; ++i) {
+                    Scalar tt;
+                    if (intersection(ray, *mFaces[i], tt) && tt < minT) {
+                        minT = tt;
+                        res  = mFaces[i];
+                    }
+                }
+            }
+            else {
+                QueryNode l = {
+                    qnode.nodeId + 1,
+                    rayBoxEntry(
+                        mNodes[qnode.nodeId + 1].box,
+                        ray.origin(),
+                        invDir,
+                        minT)};
+                QueryNode r = {
+                    node.first,
+                    rayBoxEntry(
+                        mNodes[node.first].box, ray.origin(), invDir, minT)};
+
+                // the closest child is pushed last, to be visited first
+                if (l.dist < r.dist)
+                    std::swap(l, r);
+                if (l.dist < minT)
+                    stack[count++] = l;
+                if (r.dist < minT)
+                    stack[count++] = r;
+            }
+        }
+
+        if (res)
+            t = minT;
+        return res;
+    }
+
+    /**
+     * @brief Searchs the first face hit by the given ray.
+     *
+     * @param[in] ray: the query ray.
+     * @return a pointer to the first face hit by the ray, or nullptr if the ray
+     * does not hit any face.
+     */
+    const FaceType* firstRayHit(const RayType& ray) const
+    {
+        Scalar t;
+        return firstRayHit(ray, t);
+    }
+
+    /**
+     * @brief Returns all the faces hit by the given ray, sorted along the ray.
+     *
+     * @param[in] ray: the query ray.
+     * @param[out] ts: the parameters along the ray of the hit points, in the
+     * same order of the returned faces.
+     * @return the vector of the faces hit by the ray.
+     */
+    std::vector<const FaceType*> allRayHits(
+        const RayType&       ray,
+        std::vector<Scalar>& ts) const
+    {
+        std::vector<std::pair<Scalar, const FaceType*>> hits;
+
+        if (!mNodes.empty()) {
+            const PointType invDir = inverseDirection(ray);
+            const Scalar    maxT   = std::numeric_limits<Scalar>::max();
+
+            std::array<uint, MAX_DEPTH + 2> stack;
+            uint                            count = 0;
+
+            stack[count++] = 0;
+
+            while (count) {
+                const uint  nodeId = stack[--count];
+                const Node& node   = mNodes[nodeId];
+
+                if (rayBoxEntry(node.box, ray.origin(), invDir, maxT) == maxT)
+                    continue;
+
+                if (node.count > 0) {
+                    uint end = node.first + node.count;
+                    for (uint i = node.first; i < end; ++i) {
+                        Scalar tt;
+                        if (intersection(ray, *mFaces[i], tt))
+                            hits.emplace_back(tt, mFaces[i]);
+                    }
+                }
+                else {
+                    stack[count++] = node.first;
+                    stack[count++] = nodeId + 1;
+                }
+            }
+
+            std::sort(hits.begin(), hits.end());
+        }
+
+        std::vector<const FaceType*> res(hits.size());
+        for (uint i = 0; i < hits.size(); ++i)
+            res[i] = hits[i].second;
+
+        ts.resize(hits.size());
+        for (uint i = 0; i < hits.size(); ++i)
+            ts[i] = hits[i].first;
+        return res;
+    }
+
+    /**
+     * @brief Returns all the faces hit by the given ray, sorted along the ray.
+     *
+     * @param[in] ray: the query ray.
+     * @return the vector of the faces hit by the ray.
+     */
+    std::vector<const FaceType*> allRayHits(const RayType& ray) const
+    {
+        std::vector<Scalar> ts;
+        return allRayHits(ray, ts);
+    }
+
+    /**
+     * @brief Returns all the faces that intersect the given box.
+     *
+     * @param[in] box: the query box.
+     * @return the vector of the faces that intersect the box, in the order in
+     * which they are stored in the BVH.
+     */
+    std::vector<const FaceType*> facesInBox(const BoxType& box) const
+    {
+        std::vector<const FaceType*> res;
+
+        if (mNodes.empty())
+            return res;
+
+        std::array<uint, MAX_DEPTH + 2> stack;
+        uint                            count = 0;
+
+        stack[count++] = 0;
+
+        while (count) {
+            const uint  nodeId = stack[--count];
+            const Node& node   = mNodes[nodeId];
+
+            if (!node.box.overlap(box))
+                continue;
+
+            if (node.count > 0) {
+                uint end = node.first + node.count;
+                for (uint i = node.first; i < end; ++i) {
+                    if (vcl::boundingBox(*mFaces[i]).overlap(box) &&
+                        intersect(*mFaces[i], box)) {
+                        res.push_back(mFaces[i]);
+                    }
+                }
+            }
+            else {
+                stack[count++] = node.first;
+                stack[count++] = nodeId + 1;
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief Returns all the faces that intersect the given sphere, that are
+     * the faces having distance from the center of the sphere not greater than
+     * its radius.
+     *
+     * Nodes are pruned using the distance of their box from the center of the
+     * sphere.
+     *
+     * @param[in] sphere: the query sphere.
+     * @return the vector of the faces that intersect the sphere, in the order
+     * in which they are stored in the BVH.
+     */
+    template<typename SScalar>
+    std::vector<const FaceType*> facesInSphere(
+        const Sphere<SScalar>& sphere) const
+    {
+        std::vector<const FaceType*> res;
+
+        if (mNodes.empty())
+            return res;
+
+        const PointType c = sphere.center().template cast<Scalar>();
+        const Scalar    r = sphere.radius();
+
+        std::array<uint, MAX_DEPTH + 2> stack;
+        uint                            count = 0;
+
+        stack[count++] = 0;
+
+        while (count) {
+            const uint  nodeId = stack[--count];
+            const Node& node   = mNodes[nodeId];
+
+            if (boxDist(node.box, c) > r)
+                continue;
+
+            if (node.count > 0) {
+                uint end = node.first + node.count;
+                for (uint i = node.first; i < end; ++i) {
+                    if (vcl::distance(c, *mFaces[i]) <= r)
+                        res.push_back(mFaces[i]);
+                }
+            }
+            else {
+                stack[count++] = node.first;
+                stack[count++] = nodeId + 1;
+            }
+        }
+        return res;
+    }
+
+private:
+    void build()
+    {
+        mNodes.clear();
+
+        const uint n = mFaces.size();
+        if (n == 0)
+            return;
+
+        std::vector<BoxType>   boxes(n);
+        std::vector<PointType> centroids(n);
+
+        parallelForBlocks(n, 4096, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                boxes[i]     = vcl::boundingBox(*mFaces[i]);
+                centroids[i] = boxes[i].center();
+            }
+        });
+
+        std::vector<uint> order(n);
+        std::iota(order.begin(), order.end(), 0);
+
+        mNodes.reserve(2 * ((n + mFacesPerLeaf - 1) / mFacesPerLeaf));
+        buildNode(order, boxes, centroids, 0, n, 0);
+
+        // faces are stored in the order of the leaves
+        std::vector<const FaceType*> faces(n);
+        for (uint i = 0; i < n; ++i)
+            faces[i] = mFaces[order[i]];
+        mFaces = std::move(faces);
+    }
+
+    /**
+     * @brief Recursively builds the node containing the faces in the range
+     * [begin, end) of order, and returns its index.
+     */
+    uint buildNode(
+        std::vector<uint>&            order,
+        const std::vector<BoxType>&   boxes,
+        const std::vector<PointType>& centroids,
+        uint                          begin,
+        uint                          end,
+        uint                          depth)
+    {
+        const uint nodeId = mNodes.size();
+        const uint count  = end - begin;
+
+        mNodes.emplace_back();
+
+        BoxType box, centroidBox;
+        for (uint i = begin; i < end; ++i) {
+            box.add(boxes[order[i]]);
+            centroidBox.add(centroids[order[i]]);
+        }
+        mNodes[nodeId].box = box;
+
+        if (count <= mFacesPerLeaf || depth >= MAX_DEPTH) {
+            mNodes[nodeId].first = begin;
+            mNodes[nodeId].count = count;
+            return nodeId;
+        }
+
+        uint axis = 0;
+        for (uint i = 1; i < 3; ++i) {
+            if (centroidBox.dim(i) > centroidBox.dim(axis))
+                axis = i;
+        }
+
+        uint mid =
+            splitSAH(order, boxes, centroids, begin, end, centroidBox, axis);
+
+        // SAH did not find a valid split: split at the median centroid
+        if (mid == begin || mid == end) {
+            mid = begin + count / 2;
+            std::nth_element(
+                order.begin() + begin,
+                order.begin() + mid,
+                order.begin() + end,
+                [&](uint a, uint b) {
+                    return centroids[a][axis] < centroids[b][axis];
+                });
+        }
+
+        buildNode(order, boxes, centroids, begin, mid, depth + 1);
+        uint right = buildNode(order, boxes, centroids, mid, end, depth + 1);
+
+        mNodes[nodeId].first = right;
+        mNodes[nodeId].count = 0;
+        return nodeId;
+    }
+
+    /**
+     * @brief Partitions the faces in the range [begin, end) of order along the
+     * given axis, in the bin boundary that minimizes the SAH cost, and returns
+     * the index of the first face of the second part.
+     *
+     * Returns begin if there is no valid split.
+     */
+    uint splitSAH(
+        std::vector<uint>&            order,
+        const std::vector<BoxType>&   boxes,
+        const std::vector<PointType>& centroids,
+        uint                          begin,
+        uint                          end,
+        const BoxType&                centroidBox,
+        uint                          axis) const
+    {
+        struct Bin
+        {
+            BoxType box;
+            uint    count = 0;
+        };
+
+        const Scalar minC   = centroidBox.min()[axis];
+        const Scalar extent = centroidBox.dim(axis);
+
+        if (!(extent > 0))
+            return begin;
+
+        auto binOf = [&](uint f) {
+            uint b = uint(N_BINS * ((centroids[f][axis] - minC) / extent));
+            return std::min(b, N_BINS - 1);
+        };
+
+        std::array<Bin, N_BINS> bins;
+        for (uint i = begin; i < end; ++i) {
+            Bin& b = bins[binOf(order[i])];
+            b.box.add(boxes[order[i]]);
+            b.count++;
+        }
+
+        // cost of the right part of each split, sweeping from the right
+        std::array<Scalar, N_BINS - 1> rightCost;
+        BoxType                        rightBox;
+        uint                           rightCount = 0;
+        for (uint b = N_BINS - 1; b > 0; --b) {
+            rightBox.add(bins[b].box);
+            rightCount += bins[b].count;
+            rightCost[b - 1] = rightCount * halfArea(rightBox);
+        }
+
+        // best split, sweeping from the left: the split b puts the bins
+        // [0, b] in the left part
+        Scalar  bestCost  = std::numeric_limits<Scalar>::max();
+        uint    bestSplit = N_BINS;
+        BoxType leftBox;
+        uint    leftCount = 0;
+        for (uint b = 0; b < N_BINS - 1; ++b) {
+            leftBox.add(bins[b].box);
+            leftCount += bins[b].count;
+            if (leftCount == 0 || leftCount == end - begin)
+                continue;
+
+            Scalar cost = leftCount * halfArea(leftBox) + rightCost[b];
+            if (cost < bestCost) {
+                bestCost  = cost;
+                bestSplit = b;
+            }
+        }
+
+        if (bestSplit == N_BINS)
+            return begin;
+
+        auto it = std::partition(
+            order.begin() + begin, order.begin() + end, [&](uint f) {
+                return binOf(f) <= bestSplit;
+            });
+        return it - order.begin();
+    }
+
+    // half of the surface area of a box (the SAH needs only the ratios)
+    static Scalar halfArea(const BoxType& b)
+    {
+        if (b.isNull())
+            return 0;
+        PointType s = b.size();
+        return s[0] * s[1] + s[1] * s[2] + s[2] * s[0];
+    }
+
+    // distance between a point and a box, 0 if the point is inside the box
+    static Scalar boxDist(const BoxType& b, const PointType& p)
+    {
+        Scalar sq = 0;
+        for (uint i = 0; i < 3; ++i) {
+            Scalar d = 0;
+            if (p[i] < b.min()[i])
+                d = b.min()[i] - p[i];
+            else if (p[i] > b.max()[i])
+                d = p[i] - b.max()[i];
+            sq += d * d;
+        }
+        return std::sqrt(sq);
+    }
+
+    static PointType inverseDirection(const RayType& ray)
+    {
+        PointType inv;
+        for (uint i = 0; i < 3; ++i)
+            inv[i] = Scalar(1) / ray.direction()[i];
+        return inv;
+    }
+
+    /**
+     * @brief Returns the parameter along the ray at which the ray enters the
+     * box (0 if the origin is inside the box), or the maximum value of the
+     * scalar type if the ray does not hit the box before maxT.
+     */
+    static Scalar rayBoxEntry(
+        const BoxType&   b,
+        const PointType& origin,
+        const PointType& invDir,
+        Scalar           maxT)
+    {
+        Scalar t0 = 0, t1 = maxT;
+        for (uint i = 0; i < 3; ++i) {
+            Scalar a = (b.min()[i] - origin[i]) * invDir[i];
+            Scalar c = (b.max()[i] - origin[i]) * invDir[i];
+            if (a > c)
+                std::swap(a, c);
+            // std::max and std::min discard NaNs given as second argument,
+            // that come from a zero direction component on a box plane
+            t0 = std::max(t0, a);
+            t1 = std::min(t1, c);
+            if (t0 > t1)
+                return std::numeric_limits<Scalar>::max();
+        }
+        return t0;
+    }
+};
+
+/* Deduction guides */
+
+template<FaceMeshConcept MeshType>
+FaceBVH(const MeshType& m) -> FaceBVH<typename MeshType::FaceType>;
+
+template<FaceMeshConcept MeshType>
+FaceBVH(const MeshType& m, uint facesPerLeaf)
+    -> FaceBVH<typename MeshType::FaceType>;
+
+} // namespace vcl
+
+#endif // VCL_SPACE_COMPLEX_FACE_BVH_H
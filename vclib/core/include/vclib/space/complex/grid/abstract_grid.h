@@ -107,6 +107,64 @@ protected:
        in cell */
     IntersectsCellFunction mIntersectsFun;
 
+    /**
+     * @brief Calls the given function for each cell of the grid where the
+     * given value must be stored.
+     *
+     * If the ValueType is Puntual (a Point or a Vertex), the function is called
+     * just for the cell containing the value. Otherwise, it is called for all
+     * the cells where the bounding box of the value lies (and that intersect
+     * the value, if a custom intersects function was given). If the value is a
+     * null pointer, the function is never called.
+     *
+     * @param[in] v: the value.
+     * @param[in] f: the function, that takes as input the cell position.
+     */
+    template<typename Function>
+    void forEachCellOfValue(const ValueType& v, Function&& f) const
+    {
+        const VT* vv = addressOfObj(v);
+
+        // if vv is a valid pointer (ValueType, or ValueType* if ValueType is
+        // not a pointer)
+        if (vv) {
+            // first and last cell where insert (could be the same)
+            KeyType bmin, bmax;
+
+            // if ValueType is Point, Point*, Vertex, Vertex*
+            if constexpr (PointConcept<VT> || VertexConcept<VT>) {
+                typename GridType::PointType p;
+                if constexpr (PointConcept<VT>)
+                    p = *vv;
+                else
+                    p = vv->position();
+                bmin = bmax = GridType::cell(p);
+            }
+            else { // else, call the boundingBox function
+                // bounding box of value
+                typename GridType::BBoxType bb = boundingBox(*vv);
+
+                bmin = GridType::cell(bb.min()); // first cell where insert
+                bmax = GridType::cell(bb.max()); // last cell where insert
+            }
+
+            // custom intersection function between cell and value
+            if (mIntersectsFun) {
+                for (const auto& cell : GridType::cells(bmin, bmax)) {
+                    if (mIntersectsFun(
+                            GridType::cellBox(cell), dereferencePtr(v))) {
+                        f(cell);
+                    }
+                }
+            }
+            else {
+                for (const auto& cell : GridType::cells(bmin, bmax)) {
+                    f(cell);
+                }
+            }
+        }
+    }
+
 public:
     using KeyType = GridType::CellPos;
 
@@ -165,50 +223,11 @@ public:
      */
     bool insert(const ValueType& v)
     {
-        const VT* vv = addressOfObj(v);
-
-        // if vv is a valid pointer (ValueType, or ValueType* if ValueType is
-        // not a pointer)
-        if (vv) {
-            // first and last cell where insert (could be the same)
-            KeyType bmin, bmax;
-
-            // if ValueType is Point, Point*, Vertex, Vertex*
-            if constexpr (PointConcept<VT> || VertexConcept<VT>) {
-                typename GridType::PointType p;
-                if constexpr (PointConcept<VT>)
-                    p = *vv;
-                else
-                    p = vv->position();
-                bmin = bmax = GridType::cell(p);
-            }
-            else { // else, call the boundingBox function
-                // bounding box of value
-                typename GridType::BBoxType bb = boundingBox(*vv);
-
-                bmin = GridType::cell(bb.min()); // first cell where insert
-                bmax = GridType::cell(bb.max()); // last cell where insert
-            }
-
-            bool ins = false;
-
-            // custom intersection function between cell and value
-            if (mIntersectsFun) {
-                for (const auto& cell : GridType::cells(bmin, bmax)) {
-                    if (mIntersectsFun(
-                            GridType::cellBox(cell), dereferencePtr(v))) {
-                        ins |= derived()->insertInCell(cell, v);
-                    }
-                }
-            }
-            else {
-                for (const auto& cell : GridType::cells(bmin, bmax)) {
-                    ins |= derived()->insertInCell(cell, v);
-                }
-            }
-            return ins;
-        }
-        return false;
+        bool ins = false;
+        forEachCellOfValue(v, [&](const KeyType& cell) {
+            ins |= derived()->insertInCell(cell, v);
+        });
+        return ins;
     }
 
     /**
@@ -9,10 +9,14 @@
 #define VCL_SPACE_COMPLEX_GRID_HASH_TABLE_GRID_H
 
 #include "abstract_grid.h"
+#include "iterators/hash_table_grid_iterator.h"
 #include "regular_grid.h"
 
-#include <set>
-#include <unordered_map>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 namespace vcl {
 
@@ -24,10 +28,22 @@ namespace vcl {
  *
  * This Grid allows to perform insertion, deletions and queries in a time that
  * depends only on the number of elements contained in the involved cell(s)
- * during the operation. The total overhead of managing this data structure is
- * the same of managing an std::unordered_multimap. The user can allow or
- * disallow the insertion of duplicate values by setting the boolean
- * AllowDuplicates template parameter, that is defaulted to `true`.
+ * during the operation. The user can allow or disallow the insertion of
+ * duplicate values by setting the boolean AllowDuplicates template parameter,
+ * that is defaulted to `true`.
+ *
+ * The grid is stored in flat arrays, without any per-value allocation:
+ * - the values are stored contiguously in a vector, where the values of each
+ *   cell are linked in a list (in insertion order); the slots of the erased
+ *   values are linked in a free list and reused by the next insertions;
+ * - the non-empty cells are stored in an open addressing hash table with
+ *   linear probing, where each slot stores the position of the cell and the
+ *   first and last value of its list.
+ *
+ * Clearing the grid keeps the allocated memory, that is reused by the next
+ * insertions. Inserting a range of values sorts the cells of the values by
+ * their hash before inserting them, so that the hash table is filled in slot
+ * order.
  *
  * @ingroup space_complex
  */
@@ -50,21 +66,45 @@ class HashTableGrid :
 
     friend AbsGrid;
 
+    template<typename, typename, typename, bool>
+    friend class HashTableGridIterator;
+
 public:
     using KeyType = AbsGrid::KeyType;
 
 private:
-    using MapType      = std::unordered_multimap<KeyType, ValueType>;
-    using MapValueType = MapType::value_type;
-
-    MapType mMap;
+    // a slot of the hash table: a cell that is used but has no values is kept
+    // in the table (its key is still valid for the probing) until the next
+    // rehash
+    struct Cell
+    {
+        KeyType key;
+        uint    first = UINT_NULL; // first value of the cell
+        uint    last  = UINT_NULL; // last value of the cell
+        uint    count = 0;         // number of values of the cell
+        bool    used  = false;     // true if the slot stores a cell
+    };
+
+    static constexpr uint MIN_TABLE_BITS = 4;
+
+    // the hash table of the cells, having a power of two size
+    std::vector<Cell> mCells;
+    uint              mTableBits = 0;
+    uint              mUsedCells = 0; // number of used slots of the table
+
+    // the values, and for each value the next value of the same cell (or, for
+    // erased values, the next free slot)
+    std::vector<ValueType> mValues;
+    std::vector<uint>      mNext;
+    uint                   mFree = UINT_NULL; // first free slot of the values
+    uint                   mSize = 0;         // number of stored values
 
 public:
     using IntersectsCellFunction = AbsGrid::IntersectsCellFunction;
 
-    using Iterator = std::unordered_multimap<KeyType, ValueType>::iterator;
+    using Iterator = HashTableGridIterator<KeyType, ValueType, HashTableGrid>;
     using ConstIterator =
-        std::unordered_multimap<KeyType, ValueType>::const_iterator;
+        HashTableGridIterator<KeyType, ValueType, HashTableGrid, true>;
 
     HashTableGrid() {};
 
@@ -90,7 +130,7 @@ public:
         const IntersectsCellFunction& intersects = nullptr) :
             AbsGrid(begin, end, intersects)
     {
-        AbsGrid::insert(begin, end);
+        insert(begin, end);
     }
 
     template<Range Rng>
@@ -106,7 +146,7 @@ public:
      * @brief Returns true if the HashTableGrid is empty (no elements in it).
      * @return
      */
-    bool empty() const { return mMap.empty(); }
+    bool empty() const { return mSize == 0; }
 
     /**
      * @brief Returns true if the given cell position does not contain
@@ -116,19 +156,23 @@ public:
      */
     bool cellEmpty(const KeyType& k) const
     {
-        return mMap.find(k) == mMap.end();
+        uint s = findSlot(k);
+        return s == UINT_NULL || mCells[s].count == 0;
     }
 
     /**
-     * @brief Returns an std::set containing the cell positions of all the
-     * cells that contain at least one element.
+     * @brief Returns a vector containing the cell positions of all the cells
+     * that contain at least one element, sorted in ascending order.
      * @return
      */
-    std::set<KeyType> nonEmptyCells() const
+    std::vector<KeyType> nonEmptyCells() const
     {
-        std::set<KeyType> keys;
-        for (const auto& p : mMap)
-            keys.insert(p.first);
+        std::vector<KeyType> keys;
+        for (const Cell& c : mCells) {
+            if (c.count > 0)
+                keys.push_back(c.key);
+        }
+        std::sort(keys.begin(), keys.end());
         return keys;
     }
 
@@ -137,85 +181,386 @@ public:
      * @param k
      * @return
      */
-    std::size_t countInCell(const KeyType& k) const { return mMap.count(k); }
+    std::size_t countInCell(const KeyType& k) const
+    {
+        uint s = findSlot(k);
+        return s == UINT_NULL ? 0 : mCells[s].count;
+    }
 
     std::pair<Iterator, Iterator> valuesInCell(const KeyType& k)
     {
-        auto p = mMap.equal_range(k);
-        return std::make_pair(Iterator(p.first), Iterator(p.second));
+        uint s = findSlot(k);
+        if (s == UINT_NULL || mCells[s].count == 0)
+            return std::make_pair(end(), end());
+        return std::make_pair(
+            Iterator(this, s, mCells[s].first), iteratorFromSlot(s + 1));
     }
 
     std::pair<ConstIterator, ConstIterator> valuesInCell(const KeyType& k) const
     {
-        auto p = mMap.equal_range(k);
-        return std::make_pair(ConstIterator(p.first), ConstIterator(p.second));
+        uint s = findSlot(k);
+        if (s == UINT_NULL || mCells[s].count == 0)
+            return std::make_pair(end(), end());
+        return std::make_pair(
+            ConstIterator(this, s, mCells[s].first), iteratorFromSlot(s + 1));
     }
 
-    void clear() { mMap.clear(); }
+    using AbsGrid::insert;
+
+    /**
+     * @brief Inserts all the elements from `begin` to `end`. The type
+     * referenced by the iterator must be the ValueType of the HashTableGrid.
+     *
+     * The cells of all the elements are computed first, and sorted by their
+     * hash (keeping the order of the elements inside each cell). Then, the
+     * hash table is reserved and the elements are inserted in slot order,
+     * looking up each cell only once.
+     *
+     * @param begin
+     * @param end
+     * @return The number of inserted elements.
+     */
+    template<typename ObjIterator>
+    uint insert(ObjIterator begin, ObjIterator end)
+    {
+        struct Entry
+        {
+            std::uint64_t hash;
+            uint          obj;
+            KeyType       key;
+            ValueType     value;
+        };
+
+        std::vector<Entry> entries;
+
+        uint nObjs = 0;
+        for (ObjIterator it = begin; it != end; ++it, ++nObjs) {
+            const ValueType& v = *it;
+            AbsGrid::forEachCellOfValue(v, [&](const KeyType& cell) {
+                entries.push_back(Entry {hashOf(cell), nObjs, cell, v});
+            });
+        }
+
+        std::stable_sort(
+            entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+                return a.hash < b.hash;
+            });
+
+        // count the new cells (equal keys are contiguous, unless two keys have
+        // the same hash: in this case the cells are just overestimated)
+        uint nCells = 0;
+        for (uint i = 0; i < entries.size(); ++i) {
+            if (i == 0 || entries[i].key != entries[i - 1].key)
+                ++nCells;
+        }
+        reserveCells(mUsedCells + nCells);
+        mValues.reserve(mValues.size() + entries.size());
+        mNext.reserve(mNext.size() + entries.size());
+
+        std::vector<bool> inserted(nObjs, false);
+        uint              s = UINT_NULL;
+        for (uint i = 0; i < entries.size(); ++i) {
+            const Entry& e = entries[i];
+            if (i == 0 || e.key != entries[i - 1].key)
+                s = findOrAddSlot(e.key);
+            if (insertInSlot(s, e.value))
+                inserted[e.obj] = true;
+        }
+        return std::count(inserted.begin(), inserted.end(), true);
+    }
+
+    /**
+     * @brief Inserts all the elements contained in the input range r, from
+     * `begin` to `end`. The type referenced by the iterator must be the
+     * ValueType of the HashTableGrid.
+     * @param r: a range that satisfies the concept std::ranges::range
+     * @return The number of inserted elements.
+     */
+    template<Range Rng>
+    uint insert(Rng&& r)
+    {
+        return insert(std::ranges::begin(r), std::ranges::end(r));
+    }
+
+    /**
+     * @brief Reserves the memory to store `n` values in at most `n` cells,
+     * without reallocations.
+     * @param n
+     */
+    void reserve(uint n)
+    {
+        reserveCells(mUsedCells + n);
+        mValues.reserve(n);
+        mNext.reserve(n);
+    }
+
+    /**
+     * @brief Removes all the elements from the grid. The allocated memory is
+     * kept, and reused by the next insertions.
+     */
+    void clear()
+    {
+        std::fill(mCells.begin(), mCells.end(), Cell());
+        mUsedCells = 0;
+        mValues.clear();
+        mNext.clear();
+        mFree = UINT_NULL;
+        mSize = 0;
+    }
 
     bool eraseAllInCell(const KeyType& k)
     {
-        std::pair<Iterator, Iterator> range = mMap.equal_range(k);
-        if (range != mMap.end()) {
-            mMap.erase(range.first, range.second);
-            return true;
+        uint s = findSlot(k);
+        if (s == UINT_NULL || mCells[s].count == 0)
+            return false;
+
+        Cell& c = mCells[s];
+        for (uint i = c.first; i != UINT_NULL;) {
+            uint next = mNext[i];
+            freeValue(i);
+            i = next;
         }
-        return false;
+        mSize -= c.count;
+        c.first = c.last = UINT_NULL;
+        c.count          = 0;
+        return true;
     }
 
     void eraseInSphere(const Sphere<typename GridType::ScalarType>& s)
     {
         std::vector<ConstIterator> toDel = AbsGrid::valuesInSphere(s);
         for (auto& it : toDel)
-            mMap.erase(it);
+            erase(it);
     }
 
-    Iterator begin() { return mMap.begin(); }
+    using AbsGrid::erase;
 
-    ConstIterator begin() const { return mMap.begin(); }
+    /**
+     * @brief Erases the value pointed by the given iterator. The iterators to
+     * the other values are not invalidated.
+     * @param it
+     */
+    void erase(ConstIterator it)
+    {
+        Cell& c    = mCells[it.slot()];
+        uint  prev = UINT_NULL;
+        for (uint i = c.first; i != it.index(); i = mNext[i])
+            prev = i;
+        eraseInSlot(it.slot(), prev, it.index());
+    }
 
-    Iterator end() { return mMap.end(); }
+    Iterator begin() { return iteratorFromSlot(0); }
 
-    ConstIterator end() const { return mMap.end(); }
+    ConstIterator begin() const { return iteratorFromSlot(0); }
+
+    Iterator end() { return Iterator(this, mCells.size(), UINT_NULL); }
+
+    ConstIterator end() const
+    {
+        return ConstIterator(this, mCells.size(), UINT_NULL);
+    }
 
 private:
+    // Fibonacci hashing: the slot of a key is given by the most significant
+    // bits of its hash, so sorting the keys by hash sorts them by slot
+    static std::uint64_t hashOf(const KeyType& k)
+    {
+        return std::uint64_t(std::hash<KeyType>()(k)) * 0x9E3779B97F4A7C15ull;
+    }
+
+    uint homeSlot(std::uint64_t hash) const
+    {
+        return hash >> (64 - mTableBits);
+    }
+
+    uint findSlot(const KeyType& k) const
+    {
+        if (mCells.empty())
+            return UINT_NULL;
+
+        const uint mask = mCells.size() - 1;
+        for (uint s = homeSlot(hashOf(k)); mCells[s].used; s = (s + 1) & mask) {
+            if (mCells[s].key == k)
+                return s;
+        }
+        return UINT_NULL;
+    }
+
+    uint findOrAddSlot(const KeyType& k)
+    {
+        reserveCells(mUsedCells + 1);
+
+        const uint mask = mCells.size() - 1;
+        uint       s    = homeSlot(hashOf(k));
+        for (; mCells[s].used; s = (s + 1) & mask) {
+            if (mCells[s].key == k)
+                return s;
+        }
+        mCells[s].used = true;
+        mCells[s].key  = k;
+        ++mUsedCells;
+        return s;
+    }
+
+    // makes the hash table large enough to store n cells with a load factor of
+    // at most 1/2; when the table is rebuilt, the cells without values are
+    // removed
+    void reserveCells(uint n)
+    {
+        if (2 * std::size_t(n) <= mCells.size())
+            return;
+
+        uint nonEmpty = 0;
+        for (const Cell& c : mCells)
+            nonEmpty += c.count > 0;
+
+        const uint bits = std::max<uint>(
+            MIN_TABLE_BITS,
+            std::bit_width(4 * std::size_t(n - mUsedCells + nonEmpty) - 1));
+
+        std::vector<Cell> old = std::exchange(
+            mCells, std::vector<Cell>(std::size_t(1) << bits));
+        mTableBits = bits;
+        mUsedCells = 0;
+
+        const uint mask = mCells.size() - 1;
+        for (const Cell& c : old) {
+            if (c.count > 0) {
+                uint s = homeSlot(hashOf(c.key));
+                while (mCells[s].used)
+                    s = (s + 1) & mask;
+                mCells[s] = c;
+                ++mUsedCells;
+            }
+        }
+    }
+
     bool insertInCell(const KeyType& k, const ValueType& v)
     {
-        if constexpr (AllowDuplicates) {
-            mMap.emplace(k, v);
-            return true;
+        return insertInSlot(findOrAddSlot(k), v);
+    }
+
+    bool insertInSlot(uint s, const ValueType& v)
+    {
+        Cell& c = mCells[s];
+        if constexpr (!AllowDuplicates) {
+            for (uint i = c.first; i != UINT_NULL; i = mNext[i]) {
+                if (mValues[i] == v)
+                    return false;
+            }
+        }
+
+        uint i;
+        if (mFree != UINT_NULL) {
+            i          = mFree;
+            mFree      = mNext[i];
+            mValues[i] = v;
+            mNext[i]   = UINT_NULL;
         }
         else {
-            auto range = mMap.equal_range(k);
-            bool found = false;
-            for (Iterator ci = range.first; ci != range.second && !found;
-                 ++ci) {
-                if (ci->second == v) {
-                    found = true;
-                }
-            }
-            if (!found)
-                mMap.emplace(k, v);
-            return !found;
+            i = mValues.size();
+            mValues.push_back(v);
+            mNext.push_back(UINT_NULL);
         }
+
+        if (c.last == UINT_NULL)
+            c.first = i;
+        else
+            mNext[c.last] = i;
+        c.last = i;
+        ++c.count;
+        ++mSize;
+        return true;
     }
 
     bool eraseInCell(const KeyType& k, const ValueType& v)
     {
-        bool found = false;
+        uint s = findSlot(k);
+        if (s == UINT_NULL)
+            return false;
 
-        std::pair<Iterator, Iterator> range = mMap.equal_range(k);
-        for (Iterator ci = range.first; ci != range.second; ++ci) {
-            if (ci->second == v) {
+        bool found = false;
+        uint prev  = UINT_NULL;
+        for (uint i = mCells[s].first; i != UINT_NULL;) {
+            uint next = mNext[i];
+            if (mValues[i] == v) {
                 found = true;
-                mMap.erase(ci);
+                eraseInSlot(s, prev, i);
                 if constexpr (!AllowDuplicates) {
                     return true;
                 }
             }
+            else {
+                prev = i;
+            }
+            i = next;
         }
         return found;
     }
+
+    // removes the value i, that follows the value prev in the list of the
+    // cell in the slot s
+    void eraseInSlot(uint s, uint prev, uint i)
+    {
+        Cell& c = mCells[s];
+        if (prev == UINT_NULL)
+            c.first = mNext[i];
+        else
+            mNext[prev] = mNext[i];
+        if (c.last == i)
+            c.last = prev;
+        --c.count;
+        --mSize;
+        freeValue(i);
+    }
+
+    void freeValue(uint i)
+    {
+        mNext[i] = mFree;
+        mFree    = i;
+    }
+
+    /* Iterator support */
+
+    const KeyType& cellKey(uint s) const { return mCells[s].key; }
+
+    ValueType& value(uint i) { return mValues[i]; }
+
+    const ValueType& value(uint i) const { return mValues[i]; }
+
+    // returns the first slot, starting from s, having at least one value
+    uint nonEmptySlot(uint s) const
+    {
+        while (s < mCells.size() && mCells[s].count == 0)
+            ++s;
+        return s;
+    }
+
+    Iterator iteratorFromSlot(uint s)
+    {
+        s = nonEmptySlot(s);
+        return Iterator(
+            this, s, s < mCells.size() ? mCells[s].first : UINT_NULL);
+    }
+
+    ConstIterator iteratorFromSlot(uint s) const
+    {
+        s = nonEmptySlot(s);
+        return ConstIterator(
+            this, s, s < mCells.size() ? mCells[s].first : UINT_NULL);
+    }
+
+    // moves to the next value of the cell in the slot s, or to the first value
+    // of the next non-empty slot
+    void advance(uint& s, uint& i) const
+    {
+        i = mNext[i];
+        if (i == UINT_NULL) {
+            s = nonEmptySlot(s + 1);
+            if (s < mCells.size())
+                i = mCells[s].first;
+        }
+    }
 };
 
 /* Specialization Aliases */
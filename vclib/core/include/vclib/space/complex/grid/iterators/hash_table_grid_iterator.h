@@ -0,0 +1,109 @@
+// VCLib - Visual Computing Library
+// Copyright (C) 2021-2026 Visual Computing Lab, ISTI - CNR.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef VCL_SPACE_COMPLEX_GRID_ITERATORS_HASH_TABLE_GRID_ITERATOR_H
+#define VCL_SPACE_COMPLEX_GRID_ITERATORS_HASH_TABLE_GRID_ITERATOR_H
+
+#include <vclib/space/core.h>
+
+#include <iterator>
+#include <type_traits>
+
+namespace vcl {
+
+/**
+ * @brief Iterator over the values of an HashTableGrid.
+ *
+ * The iterator stores the slot of the current cell in the hash table of the
+ * grid and the index of the current value in the value storage of the grid.
+ * The values of a cell are visited following the list of the cell; then, the
+ * iterator moves to the first value of the next non-empty slot of the table.
+ *
+ * Dereferencing the iterator gives a pair having as first member the position
+ * of the cell, and as second member a reference to the value.
+ */
+template<
+    typename KeyType,
+    typename ValueType,
+    typename GridType,
+    bool CNST = false>
+class HashTableGridIterator
+{
+    template<typename, typename, typename, bool>
+    friend class HashTableGridIterator;
+
+    using GridPtr    = std::conditional_t<CNST, const GridType*, GridType*>;
+    using CValueType = std::conditional_t<CNST, const ValueType, ValueType>;
+
+    GridPtr mGrid = nullptr;
+    uint    mSlot = UINT_NULL;
+    uint    mIdx  = UINT_NULL;
+
+public:
+    using difference_type   = ptrdiff_t;
+    using value_type        = SecondRefPair<KeyType, CValueType>;
+    using reference         = value_type;
+    using pointer           = FakePointerWithValue<value_type>;
+    using iterator_category = std::forward_iterator_tag;
+
+    HashTableGridIterator() = default;
+
+    HashTableGridIterator(GridPtr grid, uint slot, uint idx) :
+            mGrid(grid), mSlot(slot), mIdx(idx)
+    {
+    }
+
+    // a non-const iterator can be converted to a const iterator
+    template<bool C = CNST>
+    HashTableGridIterator(
+        const HashTableGridIterator<KeyType, ValueType, GridType, false>& it)
+        requires (C)
+            : mGrid(it.mGrid), mSlot(it.mSlot), mIdx(it.mIdx)
+    {
+    }
+
+    /**
+     * @brief Returns the slot, in the hash table of the grid, of the cell of
+     * the current value.
+     */
+    uint slot() const { return mSlot; }
+
+    /**
+     * @brief Returns the index of the current value in the value storage of
+     * the grid.
+     */
+    uint index() const { return mIdx; }
+
+    value_type operator*() const
+    {
+        return value_type(mGrid->cellKey(mSlot), mGrid->value(mIdx));
+    }
+
+    auto operator->() const { return FakePointerWithValue(**this); }
+
+    bool operator==(const HashTableGridIterator& oi) const
+    {
+        return mIdx == oi.mIdx;
+    }
+
+    HashTableGridIterator& operator++()
+    {
+        mGrid->advance(mSlot, mIdx);
+        return *this;
+    }
+
+    HashTableGridIterator operator++(int)
+    {
+        HashTableGridIterator old = *this;
+        mGrid->advance(mSlot, mIdx);
+        return old;
+    }
+};
+
+} // namespace vcl
+
+#endif // VCL_SPACE_COMPLEX_GRID_ITERATORS_HASH_TABLE_GRID_ITERATOR_H
@@ -14,6 +14,10 @@
 
 #include <vclib/mesh.h>
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <numeric>
 #include <set>
 #include <vector>
 
@@ -36,8 +40,13 @@ class StaticGrid :
 
     PairComparator mComparator = PairComparator();
 
+    // number of objects processed by each task when values are inserted or
+    // sorted in parallel
+    static const uint BLOCK_SIZE = 4096;
+
     // each value is stored as a pair: [cell index of the grid - value]
-    // when the grid is built, this vector is sorted by the cell indices
+    // when the grid is built, this vector is sorted by the cell indices; values
+    // in the same cell keep their insertion order
     std::vector<PairType> mValues;
 
     // for each cell of the grid, we store the index (in the values vector ) of
@@ -63,7 +72,7 @@ public:
         const IntersectsCellFunction& intersects = nullptr) :
             AbsGrid(begin, end, intersects)
     {
-        AbsGrid::insert(begin, end);
+        insert(begin, end);
         build();
     }
 
@@ -73,6 +82,57 @@ public:
     {
     }
 
+    /**
+     * @brief Inserts the values iterated between the two given iterators.
+     *
+     * If the iterators are random access, the cells of the values are computed
+     * in parallel, and the values are appended in the same order of a serial
+     * insertion. Otherwise, the values are inserted one by one.
+     *
+     * @note The grid must be built (see build()) after the insertion, before
+     * querying it.
+     *
+     * @param[in] begin: iterator to the first value to insert.
+     * @param[in] end: end iterator of the values to insert.
+     * @return The number of inserted values.
+     */
+    template<typename ObjIterator>
+    uint insert(ObjIterator begin, ObjIterator end)
+    {
+        if constexpr (std::random_access_iterator<ObjIterator>) {
+            return insertParallel(begin, end);
+        }
+        else {
+            return AbsGrid::insert(begin, end);
+        }
+    }
+
+    /**
+     * @brief Inserts the values of the given range.
+     *
+     * @note The grid must be built (see build()) after the insertion, before
+     * querying it.
+     *
+     * @param[in] r: range of values to insert.
+     * @return The number of inserted values.
+     */
+    template<Range Rng>
+    uint insert(Rng&& r)
+    {
+        return insert(std::ranges::begin(r), std::ranges::end(r));
+    }
+
+    using AbsGrid::insert;
+
+    /**
+     * @brief Builds the grid, sorting the inserted values by cell.
+     *
+     * The values are sorted with a parallel counting sort on the cell indices:
+     * the values of each cell are counted, the offsets of the cells are
+     * computed with a parallel prefix sum, and the values are scattered in
+     * their cells. The values of each cell keep their insertion order, hence
+     * the result does not depend on the number of threads.
+     */
     void build()
     {
         uint totCellCount = 1;
@@ -80,29 +140,51 @@ public:
             totCellCount *= GridType::cellCount(i);
         }
 
-        mGrid.resize(totCellCount);
-
-        std::sort(mValues.begin(), mValues.end(), mComparator);
+        const uint n = mValues.size();
 
-        // values[vi].first points to the next non empty cell in the grid
-        uint vi = 0;
-
-        // for each cell
-        for (uint ci = 0; ci < mGrid.size(); ++ci) {
-            // values[vi] is in the cell ci
-            if (vi < mValues.size() && mValues[vi].first == ci)
-                mGrid[ci] = vi;
-            else { // there are no values in this grid cell
-                mGrid[ci] = mValues.size(); // set the sentinel value
+        // number of values of each cell, transformed in the index of the first
+        // value of each cell by the prefix sum
+        mGrid.assign(totCellCount, 0);
+        parallelForBlocks(n, BLOCK_SIZE, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                std::atomic_ref<uint>(mGrid[mValues[i].first])
+                    .fetch_add(1, std::memory_order_relaxed);
             }
-
-            // move vi to the next non-empty cell
-            // skip all the values that are in the current cell ci
-            // won't increment vi if the values[vi].first is not equal to ci
-            while (vi < mValues.size() && mValues[vi].first == ci) {
-                vi++;
+        });
+        parallelExclusiveScan(mGrid);
+
+        // position of each value in the sorted vector; the values of a cell
+        // are scattered in a non deterministic order, fixed later by sorting
+        std::vector<uint> perm(n);
+        std::vector<uint> next(mGrid);
+        parallelForBlocks(n, BLOCK_SIZE, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                uint k = std::atomic_ref<uint>(next[mValues[i].first])
+                             .fetch_add(1, std::memory_order_relaxed);
+                perm[k] = i;
             }
-        }
+        });
+
+        // restore the insertion order in each cell, and set the sentinel value
+        // to the empty cells
+        parallelForBlocks(
+            totCellCount, BLOCK_SIZE, [&](std::size_t b, std::size_t e) {
+                for (std::size_t ci = b; ci < e; ++ci) {
+                    if (next[ci] == mGrid[ci])
+                        mGrid[ci] = n;
+                    else
+                        std::sort(
+                            perm.begin() + mGrid[ci], perm.begin() + next[ci]);
+                }
+            });
+
+        std::vector<PairType> sorted(n);
+        parallelForBlocks(n, BLOCK_SIZE, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                sorted[i] = std::move(mValues[perm[i]]);
+            }
+        });
+        mValues.swap(sorted);
     }
 
     bool empty() const { return mValues.empty(); }
@@ -201,6 +283,46 @@ private:
     using AbsGrid::eraseAllInCell;
     using AbsGrid::eraseInSphere;
 
+    template<typename ObjIterator>
+    uint insertParallel(ObjIterator begin, ObjIterator end)
+    {
+        const uint n       = std::distance(begin, end);
+        const uint nBlocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        // the values of each block are collected separately, and then appended
+        // in the order of the blocks
+        std::vector<std::vector<PairType>> blockValues(nBlocks);
+        std::vector<uint>                  blockInserted(nBlocks, 0);
+        parallelForBlocks(n, BLOCK_SIZE, [&](std::size_t b, std::size_t e) {
+            auto& values = blockValues[b / BLOCK_SIZE];
+            uint& cnt    = blockInserted[b / BLOCK_SIZE];
+            for (std::size_t i = b; i < e; ++i) {
+                const ValueType& v     = *(begin + i);
+                std::size_t      first = values.size();
+                AbsGrid::forEachCellOfValue(v, [&](const KeyType& cell) {
+                    values.emplace_back(GridType::indexOfCell(cell), v);
+                });
+                if (values.size() > first)
+                    cnt++;
+            }
+        });
+
+        std::vector<std::size_t> offsets(nBlocks + 1, mValues.size());
+        for (uint i = 0; i < nBlocks; ++i) {
+            offsets[i + 1] = offsets[i] + blockValues[i].size();
+        }
+        mValues.resize(offsets.back());
+
+        parallelForBlocks(nBlocks, 1, [&](std::size_t b, std::size_t) {
+            std::move(
+                blockValues[b].begin(),
+                blockValues[b].end(),
+                mValues.begin() + offsets[b]);
+        });
+
+        return std::accumulate(blockInserted.begin(), blockInserted.end(), 0u);
+    }
+
     bool insertInCell(const KeyType& cell, const ValueType& v)
     {
         uint cellIndex = GridType::indexOfCell(cell);
@@ -8,11 +8,13 @@
 #ifndef VCL_SPACE_COMPLEX_KD_TREE_H
 #define VCL_SPACE_COMPLEX_KD_TREE_H
 
+#include <vclib/base.h>
 #include <vclib/mesh.h>
 #include <vclib/space/core.h>
 
+#include <algorithm>
+#include <limits>
 #include <numeric>
-#include <queue>
 #include <vector>
 
 namespace vcl {
@@ -54,6 +56,18 @@ class KDTree
         Scalar sq;     // squared distance to the next node
     };
 
+    // element of the bounded max-heap used by the k nearest neighbours query
+    struct Neighbor
+    {
+        Scalar sq; // squared distance from the query point
+        uint   i;  // index of the point
+
+        bool operator<(const Neighbor& n) const { return sq < n.sq; }
+    };
+
+    // number of query points processed by each task of the batched queries
+    static const uint QUERY_BLOCK_SIZE = 256;
+
     // dummy values
     inline static Scalar              dummyScalar;
     inline static std::vector<Scalar> dummyScalars;
@@ -133,7 +147,7 @@ public:
         const PointType& queryPoint,
         Scalar&          dist = dummyScalar) const
     {
-        std::vector<QueryNode> mNodeStack(mDepth + 1);
+        std::vector<QueryNode>& mNodeStack = threadNodeStack(mDepth + 1);
         mNodeStack[0].nodeId = 0;
         mNodeStack[0].sq     = 0.;
         unsigned int count   = 1;
@@ -214,86 +228,229 @@ public:
         uint                 k,
         std::vector<Scalar>& distances = dummyScalars) const
     {
-        struct P
-        {
-            P(const PointType& p, int i) : p(p), i(i) {}
+        std::vector<uint> res;
+        kNearestNeighborsIndices(queryPoint, k, res, distances);
+        return res;
+    }
 
-            PointType p;
-            uint      i;
-        };
+    /**
+     * @brief Performs the k nearest neighbours query, storing the result in
+     * the given buffers.
+     *
+     * The indices and the distances of the (at most k) nearest neighbours are
+     * stored in the given vectors, sorted in order of neighbourhood. The
+     * vectors are only resized, therefore they can be reused among subsequent
+     * queries (e.g. one for each vertex of a mesh) without reallocations. The
+     * scratch memory of the search is also reused among the queries performed
+     * by the same thread.
+     *
+     * If `eps` is greater than zero, the query is approximated: a node of the
+     * tree is visited only if its distance from the query point, scaled by
+     * `(1 + eps)`, is less than the distance of the k-th neighbour found so
+     * far. The distance of the i-th returned neighbour is therefore at most
+     * `(1 + eps)` times the distance of the true i-th nearest neighbour, and
+     * less nodes are visited.
+     *
+     * @param[in] queryPoint: the query point.
+     * @param[in] k: the number of neighbours to search.
+     * @param[out] indices: the indices of the neighbours.
+     * @param[out] distances: the distances of the neighbours.
+     * @param[in] eps: the approximation factor of the query; 0 means exact.
+     * @return the number of neighbours found.
+     */
+    uint kNearestNeighborsIndices(
+        const PointType&     queryPoint,
+        uint                 k,
+        std::vector<uint>&   indices,
+        std::vector<Scalar>& distances = dummyScalars,
+        Scalar               eps       = 0) const
+    {
+        std::vector<QueryNode>& nodeStack = threadNodeStack(mDepth + 1);
+        std::vector<Neighbor>&  heap      = threadHeap(k);
+
+        uint n = kNearestNeighborsQuery(
+            queryPoint,
+            k,
+            nodeStack.data(),
+            heap.data(),
+            std::numeric_limits<Scalar>::max(),
+            eps);
+
+        fillResult(heap.data(), n, indices, distances);
+        return n;
+    }
 
-        struct Comparator
-        {
-            const PointType qp;
+    /**
+     * @brief Performs the k nearest neighbours query for a batch of query
+     * points, in parallel.
+     *
+     * The result of the query is stored in two flat arrays of size
+     * `queryPoints.size() * k`: the indices and the distances of the k nearest
+     * neighbours of the i-th query point are stored in the range
+     * `[i * k, (i + 1) * k)` of the arrays, sorted in order of neighbourhood.
+     * If the tree contains less than k points, the remaining entries of each
+     * range are set to UINT_NULL, with distance equal to the maximum value of
+     * the scalar type.
+     *
+     * The query points are processed in parallel in blocks, and the scratch
+     * memory of the search (the node stack and the bounded heap) is allocated
+     * once for each block, and not for each query. The output arrays are
+     * resized only if they do not have the required size, therefore they can
+     * be reused among subsequent calls without reallocations.
+     *
+     * @param[in] queryPoints: the query points.
+     * @param[in] k: the number of neighbours to search for each query point.
+     * @param[out] indices: the indices of the neighbours of each query point.
+     * @param[out] distances: the distances of the neighbours of each query
+     * point.
+     * @param[in] eps: if greater than zero, the query is approximated as
+     * described in the single query point version of this function.
+     */
+    void kNearestNeighborsIndices(
+        const std::vector<PointType>& queryPoints,
+        uint                          k,
+        std::vector<uint>&            indices,
+        std::vector<Scalar>&          distances = dummyScalars,
+        Scalar                        eps       = 0) const
+    {
+        const std::size_t nq = queryPoints.size();
+
+        indices.resize(nq * k);
+        if (&distances != &dummyScalars)
+            distances.resize(nq * k);
+
+        if (k == 0)
+            return;
+
+        parallelForBlocks(
+            nq, QUERY_BLOCK_SIZE, [&](std::size_t begin, std::size_t end) {
+                std::vector<QueryNode> nodeStack(mDepth + 1);
+                std::vector<Neighbor>  heap(k);
+
+                for (std::size_t q = begin; q < end; ++q) {
+                    uint n = kNearestNeighborsQuery(
+                        queryPoints[q],
+                        k,
+                        nodeStack.data(),
+                        heap.data(),
+                        std::numeric_limits<Scalar>::max(),
+                        eps);
+
+                    uint*   ind = indices.data() + q * k;
+                    Scalar* dst = nullptr;
+                    if (&distances != &dummyScalars)
+                        dst = distances.data() + q * k;
+
+                    for (uint i = 0; i < k; ++i) {
+                        ind[i] = i < n ? heap[i].i : UINT_NULL;
+                        if (dst) {
+                            dst[i] = i < n ? std::sqrt(heap[i].sq) :
+                                             std::numeric_limits<Scalar>::max();
+                        }
+                    }
+                }
+            });
+    }
 
-            Comparator(const PointType& qp) : qp(qp) {}
+    std::vector<PointType> kNearestNeighbors(
+        const PointType&     queryPoint,
+        uint                 k,
+        std::vector<Scalar>& distances = dummyScalars) const
+    {
+        std::vector<uint> dists =
+            kNearestNeighborsIndices(queryPoint, k, distances);
+        std::vector<PointType> res;
+        res.reserve(dists.size());
+        for (uint k : dists) {
+            res.push_back(mPoints[k]);
+        }
+        return res;
+    }
 
-            bool operator()(const P& p1, const P& p2)
-            {
-                if (qp.squaredDist(p1.p) > qp.squaredDist(p2.p))
-                    return true;
-                return false;
-            }
-        };
+    /**
+     * @brief Performs the radius query, storing the result in the given
+     * buffers.
+     *
+     * The indices and the distances of all the points having distance less
+     * than `radius` from the query point are stored in the given vectors. If
+     * `maxCount` is given, only the `maxCount` points closest to the query
+     * point are stored, sorted in order of neighbourhood; otherwise, the points
+     * are stored in the order in which they are found in the tree.
+     *
+     * The vectors are only resized, therefore they can be reused among
+     * subsequent queries (e.g. one for each vertex of a mesh) without
+     * reallocations. The scratch memory of the search is also reused among the
+     * queries performed by the same thread.
+     *
+     * @param[in] queryPoint: the query point.
+     * @param[in] radius: the radius of the query.
+     * @param[out] indices: the indices of the points within the radius.
+     * @param[out] distances: the distances of the points within the radius.
+     * @param[in] maxCount: the maximum number of points to store.
+     * @return the number of points found.
+     */
+    uint radiusSearch(
+        const PointType&     queryPoint,
+        Scalar               radius,
+        std::vector<uint>&   indices,
+        std::vector<Scalar>& distances = dummyScalars,
+        uint                 maxCount  = UINT_NULL) const
+    {
+        std::vector<QueryNode>& nodeStack = threadNodeStack(mDepth + 1);
 
-        Comparator cmp(queryPoint);
+        const Scalar sqRadius = radius * radius;
 
-        std::priority_queue<P, std::vector<P>, Comparator> neighborQueue(cmp);
+        if (maxCount != UINT_NULL) {
+            std::vector<Neighbor>& heap = threadHeap(maxCount);
 
-        std::vector<QueryNode> mNodeStack(mDepth + 1);
-        mNodeStack[0].nodeId = 0;
-        mNodeStack[0].sq     = 0.;
-        unsigned int count   = 1;
+            uint n = kNearestNeighborsQuery(
+                queryPoint, maxCount, nodeStack.data(), heap.data(), sqRadius);
 
-        while (count) {
-            // we select the last node (AABB) inserted in the stack
-            QueryNode& qnode = mNodeStack[count - 1];
+            fillResult(heap.data(), n, indices, distances);
+            return n;
+        }
 
-            // while going down the tree qnode.nodeId is the nearest sub-tree,
-            // otherwise, in backtracking, qnode.nodeId is the other sub-tree
-            // that will be visited iff the actual nearest node is further than
-            // the split distance.
-            const Node& node = mNodes[qnode.nodeId];
+        const bool storeDistances = &distances != &dummyScalars;
 
-            // if the distance is less than the top of the max-heap, it could be
-            // one of the k-nearest neighbours
-            if (neighborQueue.size() < k ||
-                qnode.sq < queryPoint.squaredDist(neighborQueue.top().p)) {
-                // when we arrive to a leaf
-                if (node.leaf) {
-                    --count; // pop of the leaf
+        indices.clear();
+        if (storeDistances)
+            distances.clear();
 
-                    // end is the index of the last element of the leaf in
-                    // mPoints
-                    unsigned int end = node.start + node.size;
-                    // adding the element of the leaf to the heap
-                    for (unsigned int i = node.start; i < end; ++i)
-                        neighborQueue.push(P(mPoints[i], mIndices[i]));
+        nodeStack[0].nodeId = 0;
+        nodeStack[0].sq     = 0.;
+        uint count          = 1;
+
+        while (count) {
+            QueryNode&  qnode = nodeStack[count - 1];
+            const Node& node  = mNodes[qnode.nodeId];
+
+            if (qnode.sq < sqRadius) {
+                if (node.leaf) {
+                    --count; // pop
+                    uint end = node.start + node.size;
+                    for (uint i = node.start; i < end; ++i) {
+                        Scalar sq = queryPoint.squaredDist(mPoints[i]);
+                        if (sq < sqRadius) {
+                            indices.push_back(mIndices[i]);
+                            if (storeDistances)
+                                distances.push_back(std::sqrt(sq));
+                        }
+                    }
                 }
-                // otherwise, if we're not on a leaf
                 else {
-                    // the new offset is the distance between the searched point
-                    // and the actual split coordinate
+                    // replace the stack top by the farthest and push the
+                    // closest
                     Scalar new_off = queryPoint[node.dim] - node.splitValue;
-
-                    // left sub-tree
                     if (new_off < 0.) {
-                        mNodeStack[count].nodeId = node.firstChildId;
-                        // in the father's nodeId we save the index of the other
-                        // sub-tree (for backtracking)
-                        qnode.nodeId = node.firstChildId + 1;
+                        nodeStack[count].nodeId = node.firstChildId;
+                        qnode.nodeId            = node.firstChildId + 1;
                     }
-                    // right sub-tree (same as above)
                     else {
-                        mNodeStack[count].nodeId = node.firstChildId + 1;
-                        qnode.nodeId             = node.firstChildId;
+                        nodeStack[count].nodeId = node.firstChildId + 1;
+                        qnode.nodeId            = node.firstChildId;
                     }
-                    // distance is inherited from the father (while descending
-                    // the tree it's equal to 0)
-                    mNodeStack[count].sq = qnode.sq;
-                    // distance of the father is the squared distance from the
-                    // split plane
-                    qnode.sq = new_off * new_off;
+                    nodeStack[count].sq = qnode.sq;
+                    qnode.sq            = new_off * new_off;
                     ++count;
                 }
             }
@@ -302,26 +459,33 @@ public:
                 --count;
             }
         }
-        distances.clear();
-        std::vector<uint> res;
+        return indices.size();
+    }
 
-        uint i = 0;
-        while (!neighborQueue.empty() && i < k) {
-            res.push_back(neighborQueue.top().i);
-            distances.push_back(queryPoint.dist(neighborQueue.top().p));
-            neighborQueue.pop();
-            i++;
-        }
+    /**
+     * @brief Performs the distance query.
+     *
+     * The result of the query, all the points within the distance dist form the
+     * query point, is the vector of the indeces and the vector of the distances
+     * from the query point.
+     */
+    std::vector<uint> neighborsIndicesInDistance(
+        const PointType&     queryPoint,
+        Scalar               dist,
+        std::vector<Scalar>& distances = dummyScalars) const
+    {
+        std::vector<uint> res;
+        radiusSearch(queryPoint, dist, res, distances);
         return res;
     }
 
-    std::vector<PointType> kNearestNeighbors(
+    std::vector<PointType> neighborsInDistance(
         const PointType&     queryPoint,
-        uint                 k,
+        Scalar               dist,
         std::vector<Scalar>& distances = dummyScalars) const
     {
         std::vector<uint> dists =
-            kNearestNeighborsIndices(queryPoint, k, distances);
+            neighborsIndicesInDistance(queryPoint, dist, distances);
         std::vector<PointType> res;
         res.reserve(dists.size());
         for (uint k : dists) {
@@ -330,57 +494,103 @@ public:
         return res;
     }
 
+private:
     /**
-     * @brief Performs the distance query.
+     * @brief Computes the k nearest neighbours of the query point, using the
+     * given preallocated scratch memory: a stack of at least mDepth + 1 nodes,
+     * and a heap of at least k neighbours.
      *
-     * The result of the query, all the points within the distance dist form the
-     * query point, is the vector of the indeces and the vector of the distances
-     * from the query point.
+     * Nodes are pruned using the distance to their split plane, and the
+     * closest points found so far are kept in a bounded max-heap, whose top
+     * is the farthest of them.
+     *
+     * Only the points having squared distance less than `maxSqDist` are
+     * considered. If `eps` is greater than zero, a node is visited only if its
+     * distance, scaled by `(1 + eps)`, is less than the distance of the
+     * farthest neighbour in the (full) heap.
+     *
+     * @return the number of neighbours found (at most k), that are stored in
+     * the first positions of the heap, sorted in order of neighbourhood.
      */
-    std::vector<uint> neighborsIndicesInDistance(
-        const PointType&     queryPoint,
-        Scalar               dist,
-        std::vector<Scalar>& distances = dummyScalars) const
+    uint kNearestNeighborsQuery(
+        const PointType& queryPoint,
+        uint             k,
+        QueryNode*       nodeStack,
+        Neighbor*        heap,
+        Scalar           maxSqDist = std::numeric_limits<Scalar>::max(),
+        Scalar           eps       = 0) const
     {
-        std::vector<uint> queryPoints;
-        distances.clear();
-        std::vector<QueryNode> mNodeStack(mDepth + 1);
-        mNodeStack[0].nodeId = 0;
-        mNodeStack[0].sq     = 0.;
-        unsigned int count   = 1;
+        if (k == 0)
+            return 0;
+
+        const Scalar epsFactor = (1 + eps) * (1 + eps);
+
+        uint heapSize = 0;
+
+        nodeStack[0].nodeId = 0;
+        nodeStack[0].sq     = 0.;
+        uint count          = 1;
 
-        Scalar squareDist = dist * dist;
         while (count) {
-            QueryNode&  qnode = mNodeStack[count - 1];
-            const Node& node  = mNodes[qnode.nodeId];
+            // we select the last node (AABB) inserted in the stack
+            QueryNode& qnode = nodeStack[count - 1];
+
+            // while going down the tree qnode.nodeId is the nearest sub-tree,
+            // otherwise, in backtracking, qnode.nodeId is the other sub-tree
+            // that will be visited iff the actual nearest node is further than
+            // the split distance.
+            const Node& node = mNodes[qnode.nodeId];
 
-            if (qnode.sq < squareDist) {
+            // if the distance is less than the top of the max-heap, it could be
+            // one of the k-nearest neighbours
+            if (heapSize < k ? qnode.sq < maxSqDist :
+                               qnode.sq * epsFactor < heap[0].sq) {
+                // when we arrive to a leaf
                 if (node.leaf) {
-                    --count; // pop
-                    unsigned int end = node.start + node.size;
-                    for (unsigned int i = node.start; i < end; ++i) {
-                        Scalar pointSquareDist =
-                            queryPoint.squareDist(mPoints[i]);
-                        if (pointSquareDist < squareDist) {
-                            queryPoints.push_back(mIndices[i]);
-                            distances.push_back(queryPoint.dist(mPoints[i]));
+                    --count; // pop of the leaf
+
+                    // adding the elements of the leaf to the heap, if they are
+                    // closer than the farthest neighbour found so far
+                    uint end = node.start + node.size;
+                    for (uint i = node.start; i < end; ++i) {
+                        Scalar sq = queryPoint.squaredDist(mPoints[i]);
+                        if (heapSize < k) {
+                            if (sq >= maxSqDist)
+                                continue;
+                            heap[heapSize++] = {sq, mIndices[i]};
+                            std::push_heap(heap, heap + heapSize);
+                        }
+                        else if (sq < heap[0].sq) {
+                            std::pop_heap(heap, heap + k);
+                            heap[k - 1] = {sq, mIndices[i]};
+                            std::push_heap(heap, heap + k);
                         }
                     }
                 }
+                // otherwise, if we're not on a leaf
                 else {
-                    // replace the stack top by the farthest and push the
-                    // closest
+                    // the new offset is the distance between the searched point
+                    // and the actual split coordinate
                     Scalar new_off = queryPoint[node.dim] - node.splitValue;
+
+                    // left sub-tree
                     if (new_off < 0.) {
-                        mNodeStack[count].nodeId = node.firstChildId;
-                        qnode.nodeId             = node.firstChildId + 1;
+                        nodeStack[count].nodeId = node.firstChildId;
+                        // in the father's nodeId we save the index of the other
+                        // sub-tree (for backtracking)
+                        qnode.nodeId = node.firstChildId + 1;
                     }
+                    // right sub-tree (same as above)
                     else {
-                        mNodeStack[count].nodeId = node.firstChildId + 1;
-                        qnode.nodeId             = node.firstChildId;
+                        nodeStack[count].nodeId = node.firstChildId + 1;
+                        qnode.nodeId            = node.firstChildId;
                     }
-                    mNodeStack[count].sq = qnode.sq;
-                    qnode.sq             = new_off * new_off;
+                    // distance is inherited from the father (while descending
+                    // the tree it's equal to 0)
+                    nodeStack[count].sq = qnode.sq;
+                    // distance of the father is the squared distance from the
+                    // split plane
+                    qnode.sq = new_off * new_off;
                     ++count;
                 }
             }
@@ -389,25 +599,46 @@ public:
                 --count;
             }
         }
-        return queryPoints;
+
+        std::sort_heap(heap, heap + heapSize);
+        return heapSize;
     }
 
-    std::vector<PointType> neighborsInDistance(
-        const PointType&     queryPoint,
-        Scalar               dist,
-        std::vector<Scalar>& distances = dummyScalars) const
+    // copies the first n neighbours of the heap in the output buffers
+    static void fillResult(
+        const Neighbor*      heap,
+        uint                 n,
+        std::vector<uint>&   indices,
+        std::vector<Scalar>& distances)
     {
-        std::vector<uint> dists =
-            neighborsIndicesInDistance(queryPoint, dist, distances);
-        std::vector<PointType> res;
-        res.reserve(dists.size());
-        for (uint k : dists) {
-            res.push_back(mPoints[k]);
+        indices.resize(n);
+        for (uint i = 0; i < n; ++i)
+            indices[i] = heap[i].i;
+
+        if (&distances != &dummyScalars) {
+            distances.resize(n);
+            for (uint i = 0; i < n; ++i)
+                distances[i] = std::sqrt(heap[i].sq);
         }
-        return res;
     }
 
-private:
+    // scratch memory of the queries, reused among the queries of each thread
+    static std::vector<QueryNode>& threadNodeStack(uint size)
+    {
+        thread_local std::vector<QueryNode> nodeStack;
+        if (nodeStack.size() < size)
+            nodeStack.resize(size);
+        return nodeStack;
+    }
+
+    static std::vector<Neighbor>& threadHeap(uint size)
+    {
+        thread_local std::vector<Neighbor> heap;
+        if (heap.size() < size)
+            heap.resize(size);
+        return heap;
+    }
+
     /**
      * @brief Rrecursively builds the kdtree
      *
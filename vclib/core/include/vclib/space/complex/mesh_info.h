@@ -11,6 +11,7 @@
 #include <vclib/base.h>
 #include <vclib/mesh.h>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <string>
@@ -907,6 +908,52 @@ public:
         return res;
     }
 
+    /**
+     * @brief Merges `info` into this MeshInfo object.
+     *
+     * After the merge, the Elements/Components are enabled if they are enabled
+     * in this object or in `info`. The types of the Components that were
+     * already enabled in this object are preserved, while the ones enabled
+     * only in `info` are imported from `info`. Custom components of `info`
+     * whose names are not already stored in this object are added. The Mesh
+     * Type is updated as if the faces described by `info` were added to the
+     * ones described by this object.
+     *
+     * It is useful to combine the infos of different parts of the same mesh,
+     * e.g. read in parallel from different portions of a file.
+     *
+     * @param[in] info: The info object to merge into this one.
+     */
+    void merge(const MeshInfo& info)
+    {
+        for (uint i = 0; i < NUM_ELEMENTS; ++i) {
+            mElements[i] = mElements[i] || info.mElements[i];
+            for (uint j = 0; j < NUM_COMPONENTS; ++j) {
+                if (!mPerElemComponents[i][j] &&
+                    info.mPerElemComponents[i][j]) {
+                    mPerElemComponents[i][j] = true;
+                    mPerElemComponentsType(i, j) =
+                        info.mPerElemComponentsType(i, j);
+                }
+            }
+            for (const CustomComponent& cc : info.mPerElemCustomComponents[i]) {
+                auto it = std::find_if(
+                    mPerElemCustomComponents[i].begin(),
+                    mPerElemCustomComponents[i].end(),
+                    [&](const CustomComponent& c) {
+                        return c.name == cc.name;
+                    });
+                if (it == mPerElemCustomComponents[i].end())
+                    mPerElemCustomComponents[i].push_back(cc);
+            }
+        }
+
+        if (mType == MeshType::UNKNOWN)
+            mType = info.mType;
+        else if (info.mType != MeshType::UNKNOWN && mType != info.mType)
+            mType = MeshType::POLYGON_MESH;
+    }
+
 private:
     /**
      * @brief Given the template T, returns the corresponding enum DataType
@@ -122,6 +122,30 @@ public:
         mRMS += (value * value) * increment;
     }
 
+    /**
+     * @brief Adds to the histogram all the values collected by another
+     * histogram, that must have been created with the same range and number of
+     * bins.
+     *
+     * It allows to fill a histogram in parallel: each thread fills its own
+     * partial histogram, and the partial histograms are then merged.
+     *
+     * @param[in] h: the histogram to merge into this one.
+     */
+    void merge(const Histogram& h)
+    {
+        assert(mRanges == h.mRanges);
+        for (uint i = 0; i < mHist.size(); ++i)
+            mHist[i] += h.mHist[i];
+        if (h.mMin < mMin)
+            mMin = h.mMin;
+        if (h.mMax > mMax)
+            mMax = h.mMax;
+        mCnt += h.mCnt;
+        mSum += h.mSum;
+        mRMS += h.mRMS;
+    }
+
     /**
      * @brief Minimum value of the range where the histogram is defined.
      * @return